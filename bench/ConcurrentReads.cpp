@@ -0,0 +1,146 @@
+#include "json/FrozenDocument.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Read-scaling benchmark for FrozenDocument: 1, 2, 4, ... up to
+ * --max-threads readers look up members of one shared document for
+ * --min-time seconds each. Readers share nothing writable: each counts into
+ * its own cache-line-aligned slot, which is summed after the run, so with
+ * enough cores throughput should grow linearly with the thread count.
+ *
+ *   JSON_PARSER_READ_BENCH [--min-time SECONDS] [--max-threads N]
+ */
+
+using namespace json;
+
+namespace
+{
+    struct alignas(64) ReaderSlot
+    {
+        uint64_t lookups = 0;
+        uint64_t checksum = 0;
+    };
+
+    // A config-like document: services with nested settings.
+    std::string makeConfig(size_t services)
+    {
+        std::string text = "{\"services\": {";
+        for (size_t i = 0; i < services; ++i)
+        {
+            text += i ? ", " : "";
+            text += "\"svc" + std::to_string(i) + "\": {\"port\": " + std::to_string(8000 + i) +
+                    ", \"host\": \"node" + std::to_string(i % 16) + ".internal\", \"limits\": {\"rate\": " +
+                    std::to_string(i * 10) + ", \"burst\": " + std::to_string(i) + "}}";
+        }
+        text += "}}";
+        return text;
+    }
+
+    // Lookups per second across all readers.
+    double measure(const FrozenDocument &config, const std::vector<std::string> &names, size_t threads,
+                   double minTime, uint64_t &checksum)
+    {
+        static constexpr Key servicesKey{"services"};
+        static constexpr Key limitsKey{"limits"};
+        static constexpr Key rateKey{"rate"};
+
+        std::vector<ReaderSlot> slots(threads);
+        std::atomic<bool> go{false};
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < threads; ++t)
+            readers.emplace_back(
+                [&, t]
+                {
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    uint64_t lookups = 0;
+                    uint64_t sum = 0;
+                    size_t next = t * 7919;
+                    const JsonValue &services = config.at(servicesKey);
+                    while (!stop.load(std::memory_order_relaxed))
+                        for (int batch = 0; batch < 256; ++batch)
+                        {
+                            const std::string &name = names[next++ % names.size()];
+                            const JsonValue &rate = services.at(name).at(limitsKey).at(rateKey);
+                            sum += static_cast<uint64_t>(static_cast<double>(rate));
+                            lookups += 3;
+                        }
+                    slots[t].lookups = lookups;
+                    slots[t].checksum = sum;
+                });
+
+        using Clock = std::chrono::steady_clock;
+        auto begin = Clock::now();
+        go.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::duration<double>(minTime));
+        stop = true;
+        for (auto &reader : readers)
+            reader.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        uint64_t total = 0;
+        for (const ReaderSlot &slot : slots)
+        {
+            total += slot.lookups;
+            checksum += slot.checksum;
+        }
+        return total / seconds;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double minTime = 0.5;
+    size_t maxThreads = 64;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--min-time")
+            minTime = std::stod(value());
+        else if (arg == "--max-threads")
+            maxThreads = std::max<size_t>(1, std::stoul(value()));
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    const size_t services = 1000;
+    FrozenDocument config(jsonDecodeValue(makeConfig(services)));
+    std::vector<std::string> names;
+    for (size_t i = 0; i < services; ++i)
+        names.push_back("svc" + std::to_string(i));
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    std::printf("%-10s %16s %16s %10s\n", "threads", "lookups/s", "per thread", "scaling");
+
+    uint64_t checksum = 0;
+    double single = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double rate = measure(config, names, threads, minTime, checksum);
+        if (threads == 1)
+            single = rate;
+        std::printf("%-10zu %16.0f %16.0f %9.2fx\n", threads, rate, rate / threads, rate / single);
+    }
+    return checksum == 0 ? 1 : 0;
+}
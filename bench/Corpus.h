@@ -0,0 +1,99 @@
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Deterministic benchmark corpus shared by the throughput benchmark and the
+ * PGO training run, so the profile is collected on the documents the
+ * optimised build is measured against, plus the timing loop the benchmarks
+ * share.
+ */
+namespace bench
+{
+    struct Document
+    {
+        std::string name;
+        std::string text;
+    };
+
+    inline std::vector<Document> makeCorpus()
+    {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> digit(0, 9);
+        std::uniform_real_distribution<double> real(-1e6, 1e6);
+        auto word = [&]()
+        {
+            static const char *words[] = {"alpha", "beta", "gamma", "delta", "status", "event", "user", "value", "na\\u00efve", "line\\nbreak"};
+            return std::string(words[digit(rng)]);
+        };
+
+        std::vector<Document> corpus;
+
+        // Wide event records, as produced by services.
+        std::string records = "{\"events\": [\n";
+        for (int i = 0; i < 4000; ++i)
+        {
+            records += i ? ",\n" : "";
+            records += "  {\"id\": " + std::to_string(i) + ", \"type\": \"" + word() + "\", \"ok\": " +
+                       (digit(rng) < 8 ? "true" : "false") + ", \"score\": " + std::to_string(real(rng)) +
+                       ", \"user\": {\"name\": \"" + word() + " " + word() + "\", \"tags\": [\"" + word() + "\", \"" +
+                       word() + "\"]}, \"note\": null}";
+        }
+        corpus.push_back({"records", records + "\n]}"});
+
+        // Long strings with escapes.
+        std::string strings = "{\"paragraphs\": [";
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string text;
+            for (int w = 0; w < 40; ++w)
+                text += word() + (digit(rng) == 0 ? "\\\" " : " ");
+            strings += (i ? ", \"" : "\"") + text + "\"";
+        }
+        corpus.push_back({"strings", strings + "]}"});
+
+        // Dense numeric arrays.
+        std::string numbers = "{\"matrix\": [";
+        for (int i = 0; i < 500; ++i)
+        {
+            numbers += i ? ",[" : "[";
+            for (int j = 0; j < 100; ++j)
+                numbers += (j ? "," : "") + std::to_string(real(rng));
+            numbers += "]";
+        }
+        corpus.push_back({"numbers", numbers + "]}"});
+
+        return corpus;
+    }
+
+    // Best-of-runs throughput in MB/s over at least `minTime` seconds. Exits
+    // if `run` reports a failure.
+    inline double measure(const char *name, const std::function<bool()> &run, size_t bytes, double minTime)
+    {
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        auto start = Clock::now();
+        do
+        {
+            auto begin = Clock::now();
+            if (!run())
+            {
+                std::fprintf(stderr, "%s failed\n", name);
+                std::exit(1);
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            best = std::max(best, bytes / 1e6 / seconds);
+        } while (std::chrono::duration<double>(Clock::now() - start).count() < minTime);
+        return best;
+    }
+}
+
+#endif // BENCH_CORPUS_H
@@ -0,0 +1,106 @@
+#include "Corpus.h"
+#include "json/Json.h"
+#include "json/LargePages.h"
+#include "parser/Lexer.h"
+#include "parser/Validate.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/*
+ * Large-input benchmark for LargeBuffer: one generated document of
+ * --size-mb megabytes is parsed from a std::string, from a LargeBuffer with
+ * huge pages and NUMA binding disabled, and from one with both enabled.
+ * The gain is largest on multi-GB inputs on multi-socket hosts; on a host
+ * without huge pages or NUMA the last two rows should match.
+ *
+ *   JSON_PARSER_LARGE_BENCH [--size-mb N] [--min-time SECONDS]
+ */
+
+using namespace json;
+
+namespace
+{
+    std::string makeDocument(size_t bytes)
+    {
+        std::string text = "{\"events\": [";
+        for (size_t i = 0; text.size() < bytes; ++i)
+        {
+            text += i ? "," : "";
+            text += "{\"id\": " + std::to_string(i) + ", \"kind\": \"event-" + std::to_string(i % 97) +
+                    "\", \"score\": " + std::to_string(i * 0.25) + ", \"ok\": " + (i % 3 ? "true" : "false") + "}";
+        }
+        text += "]}";
+        return text;
+    }
+
+    void report(const char *name, std::string_view input, double minTime)
+    {
+        double validate = bench::measure(
+            "validate",
+            [&]
+            {
+                Lexer lexer(input);
+                return validator::validate(lexer);
+            },
+            input.size(), minTime);
+        double decode = bench::measure("decode", [&] { return jsonTryDecode(input).has_value(); }, input.size(), minTime);
+        std::printf("%-24s %12.1f %12.1f\n", name, validate, decode);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t sizeMb = 256;
+    double minTime = 1.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--size-mb")
+            sizeMb = std::max<size_t>(1, std::stoul(value()));
+        else if (arg == "--min-time")
+            minTime = std::stod(value());
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    const LargePageSupport &support = largePageSupport();
+    std::printf("hugetlb: %s, transparent huge pages: %s, numa: %s, huge page size: %zu KiB\n",
+                support.hugetlb ? "yes" : "no", support.transparent ? "yes" : "no", support.numa ? "yes" : "no",
+                support.hugePageSize / 1024);
+
+    std::string document = makeDocument(sizeMb << 20);
+
+    LargePageOptions plain;
+    plain.hugePages = false;
+    plain.localNode = false;
+    LargeBuffer normal(document.size(), plain);
+    std::memcpy(normal.data(), document.data(), document.size());
+
+    LargeBuffer large(document.size());
+    std::memcpy(large.data(), document.data(), document.size());
+    const LargePagePlacement &placement = large.placement();
+    std::printf("large buffer: hugetlb %s, transparent %s, node %d\n", placement.hugetlb ? "yes" : "no",
+                placement.transparent ? "yes" : "no", placement.node);
+
+    std::printf("%-24s %12s %12s\n", "input", "validate MB/s", "decode MB/s");
+    report("std::string", document, minTime);
+    report("LargeBuffer (plain)", normal.view(), minTime);
+    report("LargeBuffer (large)", large.view(), minTime);
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "Corpus.h"
+#include "json/Async.h"
+#include "json/Json.h"
+#include "parser/Formatter.h"
+#include "parser/Kernels.h"
+#include "parser/Lexer.h"
+#include "parser/Validate.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*
+ * Throughput benchmark and perf-regression gate. The corpus is generated
+ * deterministically in-process, so no data files or network are needed.
+ *
+ *   JSON_PARSER_BENCH [--min-time SECONDS] [--filter TEXT]
+ *                     [--baseline FILE [--threshold PERCENT]]
+ *                     [--write-baseline FILE]
+ *
+ * With --baseline the run fails (exit 1) when any benchmark's MB/s falls
+ * more than the threshold below its recorded value. Baselines are machine
+ * specific; record one with --write-baseline on the machine that checks it.
+ */
+
+using namespace json;
+using bench::Document;
+using bench::makeCorpus;
+
+namespace
+{
+    class StringReader : public AsyncReader
+    {
+    public:
+        explicit StringReader(std::string_view data) : data_(data) {}
+
+        Task<size_t> read(std::span<char> buffer) override
+        {
+            size_t n = std::min(buffer.size(), data_.size() - pos_);
+            std::memcpy(buffer.data(), data_.data() + pos_, n);
+            pos_ += n;
+            co_return n;
+        }
+
+    private:
+        std::string_view data_;
+        size_t pos_ = 0;
+    };
+
+    struct Engine
+    {
+        const char *name;
+        std::function<bool(const std::string &)> run;
+    };
+
+    std::vector<Engine> makeEngines()
+    {
+        return {
+            {"decode", [](const std::string &text)
+             { return jsonTryDecode(text).has_value(); }},
+            // Strict input through the flag templates: the Strict
+            // instantiation should match "decode", and Json5Lite shows what
+            // the relaxed features cost.
+            {"decode-flags-strict", [](const std::string &text)
+             { return jsonTryDecodeWith<ParseFlags::Strict>(text).has_value(); }},
+            {"decode-flags-json5lite", [](const std::string &text)
+             { return jsonTryDecodeWith<ParseFlags::Json5Lite>(text).has_value(); }},
+            {"decode-lazy", [](const std::string &text)
+             { return jsonTryDecodeLazy(text).has_value(); }},
+            {"decode-projected", [](const std::string &text)
+             { return jsonTryDecode(text, Projection{"/events/id"}).has_value(); }},
+            {"decode-async", [](const std::string &text)
+             {
+                 StringReader reader(text);
+                 auto task = asyncDecode(reader);
+                 task.start();
+                 return task.done() && task.result().has_value();
+             }},
+            {"validate", [](const std::string &text)
+             {
+                 Lexer lexer(text);
+                 return validator::validate(lexer);
+             }},
+            {"minify", [](const std::string &text)
+             { return !formatter::minify(text, formatter::MinifyMode::Simd).empty(); }},
+        };
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double minTime = 0.5;
+    double threshold = 10;
+    std::string baselinePath;
+    std::string writePath;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--min-time")
+            minTime = std::stod(value());
+        else if (arg == "--threshold")
+            threshold = std::stod(value());
+        else if (arg == "--baseline")
+            baselinePath = value();
+        else if (arg == "--write-baseline")
+            writePath = value();
+        else if (arg == "--filter")
+            filter = value();
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    JsonObject baseline;
+    if (!baselinePath.empty())
+    {
+        std::ifstream file(baselinePath);
+        if (!file)
+        {
+            std::fprintf(stderr, "no baseline at %s; record one with --write-baseline\n", baselinePath.c_str());
+            return 1;
+        }
+        baseline = jsonDecode(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+
+    std::printf("kernels: %s\n", toString(kernels::active().isa));
+    std::printf("%-32s %10s %10s %8s\n", "benchmark", "MB/s", "baseline", "change");
+
+    JsonObject results;
+    bool regressed = false;
+    for (const Document &doc : makeCorpus())
+    {
+        for (const Engine &engine : makeEngines())
+        {
+            std::string name = std::string(engine.name) + "/" + doc.name;
+            if (name.find(filter) == std::string::npos)
+                continue;
+
+            double mbps = bench::measure(engine.name, [&] { return engine.run(doc.text); }, doc.text.size(), minTime);
+            results[name] = mbps;
+
+            auto it = baseline.find(name);
+            if (it == baseline.end())
+            {
+                std::printf("%-32s %10.1f %10s %8s\n", name.c_str(), mbps, "-", "-");
+                continue;
+            }
+            double expected = static_cast<double>(it->second);
+            double change = (mbps - expected) / expected * 100;
+            bool slow = change < -threshold;
+            regressed |= slow;
+            std::printf("%-32s %10.1f %10.1f %+7.1f%%%s\n", name.c_str(), mbps, expected, change,
+                        slow ? "  REGRESSION" : "");
+        }
+    }
+
+    if (!writePath.empty())
+    {
+        std::ofstream(writePath) << formatter::prettify(jsonEncodeCanonical(results)) << "\n";
+        std::printf("baseline written to %s\n", writePath.c_str());
+    }
+
+    if (regressed)
+    {
+        std::printf("throughput dropped more than %.1f%% below the baseline\n", threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "Corpus.h"
+#include "json/Json.h"
+#include "json/Writer.h"
+#include "parser/Formatter.h"
+#include "parser/Lexer.h"
+#include "parser/Validate.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+ * PGO training run: drives the decode, encode and validate hot paths over
+ * the benchmark corpus so an instrumented build (JSONPARSER_PGO=GENERATE)
+ * records a representative profile. Run through the pgo-train target.
+ *
+ *   JSON_PARSER_TRAIN [--rounds N]
+ *
+ * Exits non-zero if any stage fails, so a broken build cannot silently
+ * produce an empty profile.
+ */
+
+using namespace json;
+
+namespace
+{
+    bool train(const std::string &text)
+    {
+        auto decoded = jsonTryDecode(text);
+        if (!decoded)
+            return false;
+
+        bool ok = jsonTryDecodeLazy(text).has_value() && jsonTryDecodeValue(text).has_value() &&
+                  jsonTryDecodeWith<ParseFlags::Json5Lite>(text).has_value();
+
+        Lexer lexer(text);
+        ok = ok && validator::validate(lexer);
+
+        std::string encoded = jsonEncode(*decoded);
+        std::string canonical = jsonEncodeCanonical(*decoded);
+        ok = ok && jsonTryDecode(canonical).has_value();
+
+        std::string written;
+        StringSink sink(written);
+        Writer writer(sink);
+        writer.value(*decoded);
+        writer.flush();
+        ok = ok && !written.empty();
+
+        std::string minified = formatter::minify(text, formatter::MinifyMode::Simd);
+        ok = ok && !formatter::prettify(minified).empty() && !encoded.empty();
+        return ok;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 10;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--rounds" && i + 1 < argc)
+            rounds = std::stoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<bench::Document> corpus = bench::makeCorpus();
+    for (int round = 0; round < rounds; ++round)
+        for (const bench::Document &doc : corpus)
+            if (!train(doc.text))
+            {
+                std::fprintf(stderr, "training failed on %s\n", doc.name.c_str());
+                return 1;
+            }
+
+    std::printf("trained %d rounds over %zu documents\n", rounds, corpus.size());
+    return 0;
+}
@@ -0,0 +1,157 @@
+#ifndef DIFFERENTIAL_H
+#define DIFFERENTIAL_H
+
+#include "json/Async.h"
+#include "json/DocumentStream.h"
+#include "json/Hash.h"
+#include "json/Json.h"
+#include "json/Snapshot.h"
+#include "parser/Formatter.h"
+#include "parser/Kernels.h"
+#include "parser/Lexer.h"
+#include "parser/Parser.h"
+#include "parser/Validate.h"
+
+#include <algorithm>
+#include <cstring>
+#include <expected>
+#include <string>
+#include <string_view>
+
+namespace json::fuzz
+{
+    using Result = std::expected<JsonValue, ParseError>;
+
+    // Serves the input a few bytes at a time so incremental lexing sees
+    // tokens cut at every possible boundary.
+    class ChunkedReader : public AsyncReader
+    {
+    public:
+        ChunkedReader(std::string_view data, size_t step) : data_(data), step_(step) {}
+
+        Task<size_t> read(std::span<char> buffer) override
+        {
+            size_t n = std::min({buffer.size(), step_, data_.size() - pos_});
+            std::memcpy(buffer.data(), data_.data() + pos_, n);
+            pos_ += n;
+            co_return n;
+        }
+
+    private:
+        std::string_view data_;
+        size_t step_;
+        size_t pos_ = 0;
+    };
+
+    inline Result decodeAsync(std::string_view input, size_t step)
+    {
+        ChunkedReader reader(input, step);
+        AsyncDecodeOptions options;
+        options.chunkSize = step;
+        auto task = asyncDecode(reader, options);
+        task.start();
+        return task.result();
+    }
+
+    inline std::string describe(const Result &result)
+    {
+        if (result)
+            return "ok " + jsonEncodeCanonical(*result);
+        return std::string(toString(result.error().code)) + " at " + std::to_string(result.error().offset);
+    }
+
+    // Same outcome: equal values, or the same error code and offset.
+    inline bool agree(const Result &a, const Result &b)
+    {
+        if (a.has_value() != b.has_value())
+            return false;
+        if (a)
+            return *a == *b;
+        return a.error().code == b.error().code && a.error().offset == b.error().offset;
+    }
+
+    /*
+     * Runs `input` through every parse engine and cross-checks the results.
+     * Returns a description of the first disagreement, or an empty string.
+     * The reference is jsonTryDecode (ParserContext over the full token
+     * vector with the active kernels).
+     */
+    inline std::string checkDifferential(std::string_view input)
+    {
+        const Result reference = jsonTryDecode(input);
+        auto mismatch = [&](const char *engine, const std::string &got)
+        { return std::string(engine) + ": got " + got + ", reference " + describe(reference); };
+
+        // Engines that must match the reference exactly.
+        if (Result lazy = jsonTryDecodeLazy(input); !agree(lazy, reference))
+            return mismatch("lazy strings", describe(lazy));
+        if (Result projected = jsonTryDecode(input, Projection{""}); !agree(projected, reference))
+            return mismatch("pull parser", describe(projected));
+        for (size_t step : {size_t(1), size_t(7), size_t(4096)})
+            if (Result async = decodeAsync(input, step); !agree(async, reference))
+                return mismatch("async", describe(async) + " (step " + std::to_string(step) + ")");
+
+        // Every kernel variant the CPU supports.
+        Isa original = kernels::active().isa;
+        for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+        {
+            if (!kernels::select(isa))
+                continue;
+            Result other = jsonTryDecode(input);
+            kernels::select(original);
+            if (!agree(other, reference))
+                return mismatch(toString(isa), describe(other));
+        }
+
+        // A standalone parser over the same tokens agrees, offsets included.
+        Lexer lexer(input);
+        Result standalone = Parser(lexer.tokenise()).tryParse();
+        if (!agree(standalone, reference))
+            return mismatch("standalone parser", describe(standalone));
+
+        // Both minifier variants rewrite any bytes identically.
+        std::string minified = formatter::minify(input);
+        if (formatter::minify(input, formatter::MinifyMode::Simd) != minified)
+            return "minify: scalar and simd outputs differ";
+
+        if (!reference)
+            return {};
+
+        // The validator is structural only, but must accept what parses.
+        Lexer validating(input);
+        if (!validator::validate(validating))
+            return "validator rejected a document the parser accepts";
+
+        // Any-root decoding, and a stream holding just this document.
+        if (Result value = jsonTryDecodeValue(input); !agree(value, reference))
+            return mismatch("any-root decode", describe(value));
+        DocumentStream stream(input);
+        DocumentStream::Document document;
+        if (!stream.next(document) || !(document.value == *reference) || stream.next(document) || stream.failed())
+            return "document stream disagrees on a single document";
+
+        // Whitespace rewrites preserve the document.
+        if (Result again = jsonTryDecode(minified); !agree(again, reference))
+            return mismatch("minified", describe(again));
+        if (Result again = jsonTryDecode(formatter::prettify(input)); !agree(again, reference))
+            return mismatch("prettified", describe(again));
+
+        // Canonical encoding round-trips and is a fixed point.
+        std::string canonical = jsonEncodeCanonical(*reference);
+        Result decoded = jsonTryDecode(canonical);
+        if (!agree(decoded, reference))
+            return mismatch("canonical round trip", describe(decoded));
+        if (jsonEncodeCanonical(*decoded) != canonical)
+            return "canonical encoding is not idempotent";
+        if (structuralHash(*decoded) != structuralHash(*reference))
+            return "structural hash changed across a round trip";
+
+        std::string snapshot = snapshotEncode(*reference);
+        if (!(SnapshotView(snapshot.data(), snapshot.size()).root().toJsonValue() == *reference))
+            return "snapshot round trip changed the document";
+
+        return {};
+    }
+}
+
+#endif // DIFFERENTIAL_H
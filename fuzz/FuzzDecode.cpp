@@ -0,0 +1,19 @@
+#include "Differential.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// libFuzzer entry point; also driven by ReplayMain.cpp when libFuzzer is not
+// available.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    std::string_view input(reinterpret_cast<const char *>(data), size);
+    std::string failure = json::fuzz::checkDifferential(input);
+    if (!failure.empty())
+    {
+        std::fprintf(stderr, "differential mismatch: %s\n", failure.c_str());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/*
+ * Stand-in for libFuzzer's driver on compilers without -fsanitize=fuzzer:
+ * runs every file named on the command line (directories are walked) once.
+ * Arguments starting with '-' are libFuzzer flags and are ignored, so the
+ * same command line works for both builds.
+ */
+int main(int argc, char **argv)
+{
+    std::vector<std::filesystem::path> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::filesystem::path path = argv[i];
+        if (argv[i][0] == '-')
+            continue;
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(path))
+                if (entry.is_regular_file())
+                    inputs.push_back(entry.path());
+        }
+        else
+        {
+            inputs.push_back(path);
+        }
+    }
+
+    for (const auto &path : inputs)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    }
+
+    std::printf("Replayed %zu inputs\n", inputs.size());
+    return 0;
+}
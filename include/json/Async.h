@@ -0,0 +1,138 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include "Json.h"
+#include "parser/ParseError.h"
+#include "parser/ParseLimits.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace json
+{
+    /*
+     * Minimal lazy coroutine task. The body does not start until the task is
+     * awaited (or start() is called from non-coroutine code), and completion
+     * resumes the awaiting coroutine directly via symmetric transfer.
+     */
+    template <typename T>
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            std::optional<T> value;
+            std::exception_ptr exception;
+            std::coroutine_handle<> continuation = std::noop_coroutine();
+
+            // Not an aggregate, so coroutine arguments are never used to
+            // initialise the members.
+            promise_type() = default;
+
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    return handle.promise().continuation;
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            template <typename U>
+            void return_value(U &&result) { value.emplace(std::forward<U>(result)); }
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().continuation = awaiting;
+            return handle_;
+        }
+        T await_resume() { return result(); }
+
+        // Runs the task from plain code until its first suspension point.
+        void start() { handle_.resume(); }
+        bool done() const { return handle_.done(); }
+
+        // Only valid once done(); rethrows an exception escaping the body.
+        T result()
+        {
+            if (handle_.promise().exception)
+                std::rethrow_exception(handle_.promise().exception);
+            return std::move(*handle_.promise().value);
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    /*
+     * Byte source for asyncDecode, e.g. a socket. read() fills a prefix of
+     * `buffer` and returns the number of bytes written, or 0 at end of input.
+     */
+    class AsyncReader
+    {
+    public:
+        virtual ~AsyncReader() = default;
+        virtual Task<size_t> read(std::span<char> buffer) = 0;
+    };
+
+    struct AsyncDecodeOptions
+    {
+        // Bytes requested from the reader per read() call.
+        size_t chunkSize = 64 * 1024;
+
+        // Parsing yields to `schedule` after roughly this many bytes so a
+        // large document does not monopolise the executor thread.
+        size_t yieldEvery = 256 * 1024;
+
+        // Receives the suspended decoder and must resume it later, typically
+        // by posting it to the executor's queue. Without one, no yields occur.
+        std::function<void(std::coroutine_handle<>)> schedule;
+
+        ParseLimits limits;
+    };
+
+    /*
+     * Decodes one JSON document from `reader`, suspending while the reader
+     * has no data. Error offsets, lines and columns refer to the whole byte
+     * stream. The reader is drained to end of input so trailing content is
+     * detected, as with jsonTryDecode.
+     */
+    Task<std::expected<JsonValue, ParseError>> asyncDecode(AsyncReader &reader, AsyncDecodeOptions options = {});
+}
+
+#endif // ASYNC_H
@@ -0,0 +1,126 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "parser/ParseError.h"
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace json
+{
+    enum class ColumnType
+    {
+        Boolean,
+        Int64,
+        Float64,
+        String
+    };
+
+    // One output column, taken from the top-level member `name` of each record.
+    struct ColumnField
+    {
+        std::string name;
+        ColumnType type;
+    };
+
+    using ColumnSchema = std::vector<ColumnField>;
+
+    /*
+     * Column builder whose buffers follow the Apache Arrow columnar format, so
+     * they can be handed to Arrow consumers without conversion:
+     *  - validity: LSB-ordered bitmap, bit set when the slot is non-null;
+     *  - Boolean:  values in a second bitmap of the same shape;
+     *  - Int64 / Float64: contiguous little-endian values, 0 in null slots;
+     *  - String:   int32 offsets (length + 1 entries) into UTF-8 data.
+     */
+    class Column
+    {
+    public:
+        Column(std::string name, ColumnType type);
+
+        const std::string &name() const { return name_; }
+        ColumnType type() const { return type_; }
+        size_t length() const { return length_; }
+        size_t nullCount() const { return nullCount_; }
+
+        bool isValid(size_t row) const { return (validity_[row / 8] >> (row % 8)) & 1; }
+        bool boolean(size_t row) const { return (bits_[row / 8] >> (row % 8)) & 1; }
+        int64_t int64(size_t row) const { return int64s_[row]; }
+        double float64(size_t row) const { return float64s_[row]; }
+        std::string_view string(size_t row) const
+        {
+            return std::string_view(data_).substr(offsets_[row], offsets_[row + 1] - offsets_[row]);
+        }
+
+        // Arrow buffers.
+        std::span<const uint8_t> validity() const { return validity_; }
+        std::span<const uint8_t> booleanValues() const { return bits_; }
+        std::span<const int64_t> int64Values() const { return int64s_; }
+        std::span<const double> float64Values() const { return float64s_; }
+        std::span<const int32_t> offsets() const { return offsets_; }
+        std::string_view data() const { return data_; }
+
+        void appendNull();
+        void appendBoolean(bool value);
+        void appendInt64(int64_t value);
+        void appendFloat64(double value);
+        // Throws std::length_error once the data exceeds int32 offsets.
+        void appendString(std::string_view value);
+
+    private:
+        void pushSlot(bool valid);
+
+        std::string name_;
+        ColumnType type_;
+        size_t length_ = 0;
+        size_t nullCount_ = 0;
+        std::vector<uint8_t> validity_;
+        std::vector<uint8_t> bits_;
+        std::vector<int64_t> int64s_;
+        std::vector<double> float64s_;
+        std::vector<int32_t> offsets_;
+        std::string data_;
+    };
+
+    struct RecordBatch
+    {
+        size_t rows = 0;
+        std::vector<Column> columns;
+
+        // nullptr when the batch has no such column.
+        const Column *column(std::string_view name) const;
+    };
+
+    /*
+     * Infers a schema from the first `sampleRecords` records of `ndjson`.
+     * Columns appear in first-seen order. Integers widen to Float64 when a
+     * fractional number is seen. Members whose types conflict, or that only
+     * hold objects, arrays or null, become String columns.
+     */
+    std::expected<ColumnSchema, ParseError> inferColumns(std::string_view ndjson, size_t sampleRecords = 1024);
+
+    /*
+     * Parses newline-delimited JSON objects straight into column builders,
+     * without building a JsonValue per record. Members not in the schema are
+     * skipped unparsed. A member missing from a record, or holding a value its
+     * column cannot represent, becomes null. String columns keep strings
+     * decoded and any other value as its JSON text. For a duplicated key the
+     * first occurrence wins.
+     */
+    std::expected<RecordBatch, ParseError> shredRecords(std::string_view ndjson, const ColumnSchema &schema);
+
+    /*
+     * Splits `ndjson` at line boundaries into up to `threads` slices and
+     * shreds them concurrently, one batch per slice, in input order. Error
+     * offsets refer to the whole input; the first failing slice is reported.
+     */
+    std::expected<std::vector<RecordBatch>, ParseError> shredRecordsParallel(
+        std::string_view ndjson, const ColumnSchema &schema, size_t threads = std::thread::hardware_concurrency());
+}
+
+#endif // COLUMNAR_H
@@ -0,0 +1,150 @@
+#ifndef COW_VALUE_H
+#define COW_VALUE_H
+
+#include "Json.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+    /*
+     * Persistent JSON tree. Objects and arrays are immutable, reference-
+     * counted nodes shared between copies, so copying a CowValue is O(1).
+     * The mutating accessors copy a node only when another value still
+     * shares it; an edit through operator[] therefore copies just the path
+     * from the root to the modified node and leaves every other copy as it
+     * was:
+     *
+     *     CowValue base(jsonDecodeValue(text));
+     *     CowValue mine = base;        // O(1) snapshot
+     *     mine["user"]["name"] = "ada"; // copies root and "user" only
+     *
+     * The mutating accessors return a Ref, which records the path from the
+     * root rather than pointing into a node, and unshares that path again
+     * on every write. A Ref kept across a copy therefore never writes into
+     * the copy:
+     *
+     *     auto user = base["user"];
+     *     CowValue snap = base;        // shares every node with `base`
+     *     user["name"] = "ada";        // copies root and "user"; `snap` unchanged
+     *
+     * Each write through a Ref walks its path from the root, and a Ref
+     * must not outlive the value it was taken from.
+     *
+     * Distinct CowValues may be read and modified from different threads
+     * even when they share nodes; a single CowValue is no more thread-safe
+     * than a JsonValue. Leaves hold JsonValues; lazy strings are copied out.
+     */
+    class CowValue
+    {
+    public:
+        using object_t = std::unordered_map<std::string, CowValue, KeyHash, KeyEqual>;
+        using array_t = std::vector<CowValue>;
+
+        // Writable handle to a value inside a tree: the root and a path of
+        // member keys and array indexes.
+        class Ref
+        {
+        public:
+            Ref operator[](const std::string &key) const { return (*this)[Key(key)]; }
+            Ref operator[](const char *key) const { return (*this)[Key(key)]; }
+            Ref operator[](const Key &key) const;
+            Ref at(size_t index) const;
+            void push_back(CowValue value) const;
+            size_t erase(std::string_view key) const;
+
+            const Ref &operator=(const JsonValue &value) const { return *this = CowValue(value); }
+            const Ref &operator=(CowValue value) const;
+            Ref(const Ref &) = default;
+            Ref &operator=(const Ref &other); // assigns the referenced value
+
+            // The current value, without unsharing anything.
+            operator const CowValue &() const;
+
+        private:
+            friend class CowValue;
+            using Step = std::variant<std::string, size_t>;
+
+            Ref(CowValue &root, std::vector<Step> path) : root_(&root), path_(std::move(path)) {}
+
+            // Unshares the path from the root and returns its end.
+            CowValue &resolve() const;
+
+            CowValue *root_;
+            std::vector<Step> path_;
+        };
+
+        CowValue() = default;
+        CowValue(const JsonValue &value);
+
+        CowValue &operator=(const JsonValue &value) { return *this = CowValue(value); }
+
+        bool is_null() const;
+        bool is_object() const;
+        bool is_array() const;
+
+        // The leaf value; throws std::bad_variant_access for objects and arrays.
+        const JsonValue &value() const;
+        const object_t &object() const;
+        const array_t &array() const;
+
+        // Members of an object, elements of an array, 0 for leaves.
+        size_t size() const;
+
+        // nullptr when this is not an object or has no such member.
+        const CowValue *find(std::string_view key) const;
+        const CowValue *find(const Key &key) const;
+
+        // Throws std::out_of_range.
+        const CowValue &at(size_t index) const;
+
+        // Mutation. A non-object becomes an empty object first, like
+        // JsonValue::operator[]; a missing member is created.
+        Ref operator[](const std::string &key) { return (*this)[Key(key)]; }
+        Ref operator[](const char *key) { return (*this)[Key(key)]; }
+        Ref operator[](const Key &key);
+        Ref at(size_t index);
+        void push_back(CowValue value);
+        size_t erase(std::string_view key);
+
+        /*
+         * Path-based mutation from this value, unsharing every node along an
+         * RFC 6901 JSON pointer. Missing members are created and non-objects
+         * become objects, as with operator[]; "-" appends to an array.
+         * Throws std::runtime_error for a malformed pointer or array index
+         * and std::out_of_range for an index past the end. The reference
+         * passed to `edit` is valid only for the duration of the call.
+         */
+        void update(std::string_view pointer, const std::function<void(CowValue &)> &edit);
+        void set(std::string_view pointer, CowValue value);
+
+        // True when both values refer to the same node.
+        bool shares(const CowValue &other) const { return node_ && node_ == other.node_; }
+
+        JsonValue toJsonValue() const;
+
+    private:
+        struct Node;
+
+        // The node, copied first if another value shares it.
+        Node &unique();
+
+        // Unsharing steps shared by operator[], at, Ref and update.
+        CowValue &member(const Key &key);
+        CowValue &element(size_t index);
+
+        std::shared_ptr<const Node> node_;
+    };
+
+    // Deep equality, as for JsonValue.
+    bool operator==(const CowValue &lhs, const CowValue &rhs);
+}
+
+#endif // COW_VALUE_H
@@ -0,0 +1,90 @@
+#ifndef DECODE_CACHE_H
+#define DECODE_CACHE_H
+
+#include "Json.h"
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace json
+{
+    struct DecodeCacheOptions
+    {
+        size_t maxBytes = 64 * 1024 * 1024;
+        size_t shards = 16;
+        ParseLimits limits;
+    };
+
+    struct DecodeCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    /*
+     * Thread-safe LRU cache of decoded documents keyed by a hash of the input
+     * bytes. Identical inputs share one immutable document. The cache is split
+     * into independently locked shards so concurrent callers rarely contend;
+     * parsing a miss happens outside any lock.
+     *
+     * Each entry is charged its input size plus the decoded tree's
+     * memory_usage(), and least recently used entries are evicted per shard
+     * to stay within maxBytes. Inputs that fail to parse are not cached.
+     */
+    class DecodeCache
+    {
+    public:
+        using Document = std::shared_ptr<const JsonValue>;
+
+        explicit DecodeCache(const DecodeCacheOptions &options = {});
+
+        DecodeCache(const DecodeCache &) = delete;
+        DecodeCache &operator=(const DecodeCache &) = delete;
+
+        std::expected<Document, ParseError> decode(std::string_view input);
+
+        DecodeCacheStats stats() const;
+        void clear();
+
+    private:
+        struct Entry
+        {
+            uint64_t hash;
+            std::string input;
+            Document document;
+            size_t charge;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex;
+            std::list<Entry> lru; // most recently used first
+            std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+            size_t bytes = 0;
+
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> misses{0};
+            std::atomic<uint64_t> evictions{0};
+        };
+
+        DecodeCacheOptions options_;
+        size_t shardCapacity_;
+        std::vector<Shard> shards_;
+
+        Shard &shardFor(uint64_t hash) { return shards_[(hash >> 48) % shards_.size()]; }
+        void insert(Shard &shard, Entry entry);
+    };
+}
+
+#endif // DECODE_CACHE_H
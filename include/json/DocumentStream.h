@@ -0,0 +1,108 @@
+#ifndef DOCUMENT_STREAM_H
+#define DOCUMENT_STREAM_H
+
+#include "Json.h"
+#include "parser/Lexer.h"
+#include "parser/Parser.h"
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace json
+{
+    /*
+     * Parses concatenated JSON documents ("{...}{...}", "1 2 [3]") back to
+     * back from one buffer, with no delimiter required between them. Each
+     * document may have any root value. One lexer and parser are reused for
+     * the whole stream, and tokens are pulled a batch at a time, so memory
+     * tracks the largest document rather than the buffer.
+     *
+     *     DocumentStream stream(buffer);
+     *     for (const DocumentStream::Document &doc : stream)
+     *         handle(doc.value, buffer.substr(doc.begin, doc.end - doc.begin));
+     *     if (stream.failed())
+     *         report(stream.error());
+     *
+     * Iteration stops at the first malformed document; there is no reliable
+     * way to resynchronise inside undelimited input. ParseLimits apply to
+     * each document separately. The buffer must outlive the stream.
+     */
+    class DocumentStream
+    {
+    public:
+        struct Document
+        {
+            JsonValue value;
+            size_t begin = 0; // byte offset of the first token
+            size_t end = 0;   // one past the last byte of the last token
+        };
+
+        explicit DocumentStream(std::string_view input, const ParseLimits &limits = {});
+
+        DocumentStream(const DocumentStream &) = delete;
+        DocumentStream &operator=(const DocumentStream &) = delete;
+
+        // Parses the next document into `out`. Returns false at the end of
+        // the stream or on error; check failed() to tell them apart.
+        bool next(Document &out);
+
+        bool failed() const { return failed_; }
+        const ParseError &error() const { return error_; }
+
+        // Documents parsed so far.
+        size_t count() const { return count_; }
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Document;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Document *;
+            using reference = const Document &;
+
+            iterator() = default;
+            explicit iterator(DocumentStream *stream) : stream_(stream) { ++*this; }
+
+            reference operator*() const { return document_; }
+            pointer operator->() const { return &document_; }
+
+            iterator &operator++()
+            {
+                if (stream_ && !stream_->next(document_))
+                    stream_ = nullptr;
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const { return stream_ == other.stream_; }
+
+        private:
+            DocumentStream *stream_ = nullptr;
+            Document document_;
+        };
+
+        // Single pass: begin() continues from the current position.
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+
+    private:
+        // Tokens are pulled from the lexer this many at a time.
+        static constexpr size_t batchSize = 256;
+
+        std::string_view input_;
+        ParseLimits limits_;
+        Lexer lexer_;
+        Parser parser_;
+        bool exhausted_ = false;
+        bool failed_ = false;
+        ParseError error_;
+        size_t count_ = 0;
+
+        bool refill();
+        bool fail(const ParseError &error);
+        size_t tokenEnd(const Token &token) const;
+    };
+}
+
+#endif // DOCUMENT_STREAM_H
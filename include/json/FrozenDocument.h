@@ -0,0 +1,46 @@
+#ifndef FROZEN_DOCUMENT_H
+#define FROZEN_DOCUMENT_H
+
+#include "Json.h"
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <string_view>
+
+namespace json
+{
+    /*
+     * Immutable document for sharing between threads. Freezing decodes
+     * every lazy string (whose first access would otherwise write a cache),
+     * and after that the tree, including each object's member hash table,
+     * is only ever read: the API is const, so concurrent readers need no
+     * locks and never write to shared memory.
+     *
+     * Copies share the frozen tree and are O(1); hand each thread its own
+     * copy or a reference. Whatever root() returns stays valid for as long
+     * as any copy is alive.
+     */
+    class FrozenDocument
+    {
+    public:
+        explicit FrozenDocument(JsonValue value);
+
+        static std::expected<FrozenDocument, ParseError> decode(std::string_view text, const ParseLimits &limits = {});
+
+        const JsonValue &root() const { return *root_; }
+
+        const JsonValue *find(const Key &key) const { return root_->find(key); }
+        const JsonValue *find(std::string_view key) const { return root_->find(key); }
+        bool contains(const Key &key) const { return root_->contains(key); }
+        bool contains(std::string_view key) const { return root_->contains(key); }
+        const JsonValue &at(const Key &key) const { return root_->at(key); }
+        const JsonValue &at(std::string_view key) const { return root_->at(key); }
+        const JsonValue &at(size_t index) const { return root_->at(index); }
+
+    private:
+        std::shared_ptr<const JsonValue> root_;
+    };
+}
+
+#endif // FROZEN_DOCUMENT_H
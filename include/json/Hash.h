@@ -0,0 +1,35 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include "Json.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace json
+{
+    /*
+     * Structural hash over a JsonValue, computed without serialising. Object
+     * members are combined commutatively, so the result does not depend on
+     * iteration order, and numerically equal integers and floats hash alike,
+     * matching jsonEncodeCanonical().
+     */
+    uint64_t structuralHash(const JsonValue &value);
+
+    /*
+     * Memoises structuralHash per node address. Entries are only valid while
+     * the hashed tree is unchanged; call clear() after mutating it.
+     */
+    class HashCache
+    {
+    public:
+        uint64_t hash(const JsonValue &value);
+        void clear() { cache_.clear(); }
+        size_t size() const { return cache_.size(); }
+
+    private:
+        std::unordered_map<const JsonValue *, uint64_t> cache_;
+    };
+}
+
+#endif // HASH_H
@@ -1,11 +1,21 @@
 #ifndef JsonValue_H
 #define JsonValue_H
 
+#include "parser/ParseError.h"
+#include "parser/ParseFlags.h"
+#include "parser/ParseLimits.h"
+#include "Key.h"
+#include "Projection.h"
+
+#include <expected>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <variant>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
@@ -16,9 +26,66 @@ namespace json
 
     class JsonValue;
 
+    /*
+     * String value produced by lazy decoding: a span of the source text
+     * between the quotes, still escaped. Escape-free strings are served as a
+     * view of the source; escaped ones are decoded on first access and the
+     * result is cached. The source buffer must outlive the value, and the
+     * first access of an escaped string is not safe to race with another.
+     */
+    class LazyString
+    {
+    public:
+        LazyString(std::string_view raw, bool escaped) : raw_(raw), escaped_(escaped) {}
+
+        std::string_view view() const
+        {
+            if (!escaped_)
+                return raw_;
+            if (!decoded_)
+                decode();
+            return value_;
+        }
+
+        std::string_view raw() const { return raw_; }
+        bool escaped() const { return escaped_; }
+
+        // The value as a std::string, made on first use; an unescaped
+        // string is only copied out of the input when asked for this way.
+        const std::string &str() const
+        {
+            if (!decoded_)
+            {
+                if (escaped_)
+                    decode();
+                else
+                {
+                    value_.assign(raw_);
+                    decoded_ = true;
+                }
+            }
+            return value_;
+        }
+
+        // The decoded copy, or nullptr while none has been made.
+        const std::string *decoded() const { return decoded_ ? &value_ : nullptr; }
+
+    private:
+        void decode() const;
+
+        std::string_view raw_;
+        bool escaped_;
+        mutable bool decoded_ = false;
+        mutable std::string value_;
+    };
+
     class JsonObject
     {
     public:
+        using map_t = std::unordered_map<std::string, JsonValue, KeyHash, KeyEqual>;
+        using iterator = map_t::iterator;
+        using const_iterator = map_t::const_iterator;
+
         JsonObject() = default;
         JsonObject(const JsonObject &other) = default;
 
@@ -29,10 +96,24 @@ namespace json
 
         JsonValue &operator[](const char *key)
         {
-            return object_[std::string(key)];
+            return (*this)[Key(key)];
         }
 
+        // Allocates the member name only when the member is inserted.
+        JsonValue &operator[](const Key &key);
+
         bool empty() const { return object_.empty(); }
+        size_t size() const { return object_.size(); }
+        size_t bucket_count() const { return object_.bucket_count(); }
+
+        iterator find(const std::string &key);
+        const_iterator find(const std::string &key) const;
+        bool contains(const std::string &key) const;
+        size_t erase(const std::string &key);
+
+        iterator find(const Key &key);
+        const_iterator find(const Key &key) const;
+        bool contains(const Key &key) const;
 
         auto begin() { return object_.begin(); }
         auto end() { return object_.end(); }
@@ -41,7 +122,7 @@ namespace json
         auto end() const { return object_.end(); }
 
     private:
-        std::unordered_map<std::string, JsonValue> object_;
+        map_t object_;
     };
 
     class JsonValue
@@ -53,6 +134,7 @@ namespace json
         using boolean_t = bool;
         using number_integer_t = int64_t;
         using number_float_t = double;
+        using lazy_string_t = LazyString;
         using value_t = std::variant<
             std::nullptr_t,
             string_t,
@@ -60,7 +142,8 @@ namespace json
             array_t,
             boolean_t,
             number_integer_t,
-            number_float_t>;
+            number_float_t,
+            lazy_string_t>;
 
         JsonValue() : value_(nullptr) {}
 
@@ -80,8 +163,9 @@ namespace json
                 value_ = static_cast<number_integer_t>(val);
             else if constexpr (std::is_floating_point_v<DecayT>)
                 value_ = static_cast<number_float_t>(val);
-            else if constexpr (std::is_same_v<DecayT, array_t> || std::is_same_v<DecayT, object_t>)
-                value_ = val;
+            else if constexpr (std::is_same_v<DecayT, array_t> || std::is_same_v<DecayT, object_t> ||
+                               std::is_same_v<DecayT, lazy_string_t>)
+                value_ = std::forward<T>(val);
             else if constexpr (std::is_same_v<DecayT, JsonValue>)
                 value_ = val.value_;
             else
@@ -91,15 +175,50 @@ namespace json
         JsonValue(std::initializer_list<JsonValue> list) : value_(array_t(list)) {}
 
         const value_t &get_value() const { return value_; }
+        value_t &get_value() { return value_; }
 
-        bool is_string() const { return std::holds_alternative<string_t>(value_); }
+        bool is_string() const
+        {
+            return std::holds_alternative<string_t>(value_) || std::holds_alternative<lazy_string_t>(value_);
+        }
         bool is_object() const { return std::holds_alternative<object_t>(value_); }
         bool is_array() const { return std::holds_alternative<array_t>(value_); }
         bool is_boolean() const { return std::holds_alternative<boolean_t>(value_); }
         bool is_number_integer() const { return std::holds_alternative<number_integer_t>(value_); }
         bool is_number_float() const { return std::holds_alternative<number_float_t>(value_); }
 
-        explicit operator string_t() const { return std::get<string_t>(value_); }
+        // Either string representation; throws std::bad_variant_access otherwise.
+        std::string_view get_string() const
+        {
+            if (auto *lazy = std::get_if<lazy_string_t>(&value_))
+                return lazy->view();
+            return std::get<string_t>(value_);
+        }
+
+        /*
+         * Typed access without copies or exceptions:
+         *  - try_get<T>(): for string_t, object_t and array_t a pointer to
+         *    the stored value, nullptr on a mismatch (a lazy string makes
+         *    its std::string copy on first use; ask for std::string_view to
+         *    avoid it); for bool, arithmetic types and std::string_view a
+         *    std::optional. Character types are not numbers and are
+         *    rejected at compile time.
+         *  - get<T>(): the same, dereferenced; throws std::bad_variant_access
+         *    on a mismatch.
+         *  - get_or<T>(fallback): the value, or `fallback` on a mismatch.
+         *
+         * Numbers convert between integers and floats. A float is read as an
+         * integer only when it is integral, and an integer type only matches
+         * when it can hold the value exactly.
+         */
+        template <typename T>
+        auto try_get() const;
+        template <typename T>
+        decltype(auto) get() const;
+        template <typename T>
+        T get_or(T fallback) const;
+
+        explicit operator string_t() const { return string_t(get_string()); }
         explicit operator object_t() const { return std::get<object_t>(value_); }
         explicit operator array_t() const { return std::get<array_t>(value_); }
         explicit operator boolean_t() const { return std::get<boolean_t>(value_); }
@@ -113,7 +232,29 @@ namespace json
             return std::get<object_t>(value_)[key];
         }
 
-        JsonValue &operator[](const char *key) { return (*this)[std::string(key)]; }
+        JsonValue &operator[](const char *key) { return (*this)[Key(key)]; }
+
+        JsonValue &operator[](const Key &key)
+        {
+            if (!is_object())
+                value_ = object_t{};
+            return std::get<object_t>(value_)[key];
+        }
+
+        /*
+         * Read-only lookups. Unlike operator[] they never insert, so any
+         * number of threads may call them on a shared value (see
+         * FrozenDocument for lazy strings). find() returns nullptr when this
+         * is not an object or has no such member; at() throws
+         * std::out_of_range instead.
+         */
+        const JsonValue *find(const Key &key) const;
+        const JsonValue *find(std::string_view key) const { return find(Key(key)); }
+        bool contains(const Key &key) const { return find(key) != nullptr; }
+        bool contains(std::string_view key) const { return find(Key(key)) != nullptr; }
+        const JsonValue &at(const Key &key) const;
+        const JsonValue &at(std::string_view key) const { return at(Key(key)); }
+        const JsonValue &at(size_t index) const;
 
         template <typename T>
         JsonValue &operator=(T &&val)
@@ -126,10 +267,136 @@ namespace json
         value_t value_;
     };
 
+    inline JsonObject::iterator JsonObject::find(const std::string &key) { return object_.find(key); }
+    inline JsonObject::const_iterator JsonObject::find(const std::string &key) const { return object_.find(key); }
+    inline bool JsonObject::contains(const std::string &key) const { return object_.find(key) != object_.end(); }
+    inline size_t JsonObject::erase(const std::string &key) { return object_.erase(key); }
+    inline JsonObject::iterator JsonObject::find(const Key &key) { return object_.find(key); }
+    inline JsonObject::const_iterator JsonObject::find(const Key &key) const { return object_.find(key); }
+    inline bool JsonObject::contains(const Key &key) const { return object_.find(key) != object_.end(); }
+
+    inline JsonValue &JsonObject::operator[](const Key &key)
+    {
+        auto it = object_.find(key);
+        if (it == object_.end())
+            it = object_.try_emplace(std::string(key.view())).first;
+        return it->second;
+    }
+
+    inline const JsonValue *JsonValue::find(const Key &key) const
+    {
+        auto *object = std::get_if<object_t>(&value_);
+        if (!object)
+            return nullptr;
+        auto it = object->find(key);
+        return it == object->end() ? nullptr : &it->second;
+    }
+
+    inline const JsonValue &JsonValue::at(const Key &key) const
+    {
+        if (const JsonValue *value = find(key))
+            return *value;
+        throw std::out_of_range("JsonValue has no member \"" + std::string(key.view()) + "\"");
+    }
+
+    inline const JsonValue &JsonValue::at(size_t index) const
+    {
+        auto *array = std::get_if<array_t>(&value_);
+        if (!array || index >= array->size())
+            throw std::out_of_range("JsonValue has no element " + std::to_string(index));
+        return (*array)[index];
+    }
+
+    template <typename T>
+    auto JsonValue::try_get() const
+    {
+        if constexpr (std::is_same_v<T, string_t>)
+        {
+            if (auto *lazy = std::get_if<lazy_string_t>(&value_))
+                return &lazy->str();
+            return std::get_if<T>(&value_);
+        }
+        else if constexpr (std::is_same_v<T, object_t> || std::is_same_v<T, array_t>)
+            return std::get_if<T>(&value_);
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            if (auto *s = std::get_if<string_t>(&value_))
+                return std::optional<std::string_view>(*s);
+            if (auto *lazy = std::get_if<lazy_string_t>(&value_))
+                return std::optional<std::string_view>(lazy->view());
+            return std::optional<std::string_view>();
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            auto *b = std::get_if<boolean_t>(&value_);
+            return b ? std::optional<bool>(*b) : std::optional<bool>();
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            if (auto *d = std::get_if<number_float_t>(&value_))
+                return std::optional<T>(static_cast<T>(*d));
+            if (auto *i = std::get_if<number_integer_t>(&value_))
+                return std::optional<T>(static_cast<T>(*i));
+            return std::optional<T>();
+        }
+        else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, char8_t> || std::is_same_v<T, char16_t> ||
+                           std::is_same_v<T, char32_t> || std::is_same_v<T, wchar_t>)
+            static_assert(always_false<T>, "JsonValue::try_get: character types are not numbers; use a sized "
+                                           "integer such as int8_t or uint8_t");
+        else if constexpr (std::is_integral_v<T>)
+        {
+            std::optional<number_integer_t> n;
+            if (auto *i = std::get_if<number_integer_t>(&value_))
+                n = *i;
+            else if (auto *d = std::get_if<number_float_t>(&value_))
+            {
+                // The range check also rejects NaN.
+                if (*d >= -0x1p63 && *d < 0x1p63 && static_cast<double>(static_cast<number_integer_t>(*d)) == *d)
+                    n = static_cast<number_integer_t>(*d);
+            }
+            if (n && std::in_range<T>(*n))
+                return std::optional<T>(static_cast<T>(*n));
+            return std::optional<T>();
+        }
+        else
+            static_assert(always_false<T>, "Unsupported type for JsonValue::try_get");
+    }
+
+    template <typename T>
+    decltype(auto) JsonValue::get() const
+    {
+        auto result = try_get<T>();
+        if (!result)
+            throw std::bad_variant_access();
+        if constexpr (std::is_pointer_v<decltype(result)>)
+            return static_cast<const T &>(*result);
+        else
+            return T(*result);
+    }
+
+    template <typename T>
+    T JsonValue::get_or(T fallback) const
+    {
+        if constexpr (std::is_same_v<T, string_t>)
+        {
+            auto view = try_get<std::string_view>();
+            return view ? string_t(*view) : fallback;
+        }
+        else
+        {
+            auto result = try_get<T>();
+            return result ? T(*result) : fallback;
+        }
+    }
+
+    // Deep equality; integers and floats compare by numeric value.
+    bool operator==(const JsonValue &lhs, const JsonValue &rhs);
+    bool operator==(const JsonObject &lhs, const JsonObject &rhs);
+
     inline std::ostream &operator<<(std::ostream &os, const JsonValue &JsonValue)
     {
         if (JsonValue.is_string())
-            os << std::get<JsonValue::string_t>(JsonValue.get_value());
+            os << JsonValue.get_string();
         else if (JsonValue.is_boolean())
             os << (std::get<JsonValue::boolean_t>(JsonValue.get_value()) ? "true" : "false");
         else if (JsonValue.is_number_integer())
@@ -146,9 +413,50 @@ namespace json
         return os;
     }
 
-    JsonObject jsonDecode(std::string_view jsonStr);
+    JsonObject jsonDecode(std::string_view jsonStr, const ParseLimits &limits = {});
+    std::expected<JsonValue, ParseError> jsonTryDecode(std::string_view jsonStr, const ParseLimits &limits = {});
+
+    /*
+     * Decode a document whose root may be any JSON value (RFC 8259), not
+     * only an object. jsonDecodeValue throws ParseException.
+     */
+    JsonValue jsonDecodeValue(std::string_view jsonStr, const ParseLimits &limits = {});
+    std::expected<JsonValue, ParseError> jsonTryDecodeValue(std::string_view jsonStr, const ParseLimits &limits = {});
+
+    /*
+     * Relaxed-syntax decoding: `Flags` is a ParseFlags combination such as
+     * ParseFlags::Comments | ParseFlags::TrailingCommas, or Json5Lite. The
+     * extensions are compiled into a separate lexer instantiation, so
+     * jsonDecode and jsonDecodeWith<ParseFlags::Strict> pay nothing for
+     * them. NaN and Infinity decode as non-finite doubles.
+     */
+    template <unsigned Flags>
+    JsonObject jsonDecodeWith(std::string_view jsonStr, const ParseLimits &limits = {});
+    template <unsigned Flags>
+    std::expected<JsonValue, ParseError> jsonTryDecodeWith(std::string_view jsonStr, const ParseLimits &limits = {});
+
+    /*
+     * As jsonTryDecode, but string values are LazyStrings pointing into
+     * `jsonStr`, which must outlive the result. Object keys are still copied.
+     * maxStringLength is checked against the escaped length.
+     */
+    std::expected<JsonValue, ParseError> jsonTryDecodeLazy(std::string_view jsonStr, const ParseLimits &limits = {});
+
+    /*
+     * Decode only the members selected by `projection`. Unselected subtrees
+     * are skipped over in the input without being tokenised or allocated;
+     * their contents are only checked for balanced brackets and terminated
+     * strings.
+     */
+    JsonObject jsonDecode(std::string_view jsonStr, const Projection &projection, const ParseLimits &limits = {});
+    std::expected<JsonValue, ParseError> jsonTryDecode(std::string_view jsonStr, const Projection &projection,
+                                                       const ParseLimits &limits = {});
+
     std::string jsonEncode(const JsonObject &jsonObj);
     std::string jsonEncode(const JsonValue &jsonObj);
+
+    // RFC 8785 (JCS) canonical form: sorted keys, shortest numbers, no whitespace.
+    std::string jsonEncodeCanonical(const JsonValue &value);
 }
 
 #endif // JsonValue_H
@@ -0,0 +1,138 @@
+#ifndef KEY_H
+#define KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace json
+{
+    namespace detail
+    {
+        inline constexpr uint64_t hashSecret[4] = {
+            0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+        // 64x64 -> 128 multiply folded back to 64 bits (the wyhash "mum").
+        constexpr uint64_t mix(uint64_t a, uint64_t b)
+        {
+#ifdef __SIZEOF_INT128__
+            unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+            uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffffull, lb = b & 0xffffffffull;
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            uint64_t t = rl + (rm0 << 32);
+            uint64_t carry = t < rl;
+            uint64_t lo = t + (rm1 << 32);
+            carry += lo < t;
+            uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+            return lo ^ hi;
+#endif
+        }
+
+        constexpr uint64_t read(std::string_view data, size_t pos, size_t bytes)
+        {
+            uint64_t v = 0;
+            for (size_t i = 0; i < bytes; ++i)
+                v |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+            return v;
+        }
+    }
+
+    /*
+     * Fast non-cryptographic 64-bit hash in the style of wyhash. It is
+     * constexpr so key hashes can be computed at compile time.
+     */
+    constexpr uint64_t hashBytes(std::string_view data, uint64_t seed = 0)
+    {
+        using detail::hashSecret;
+        using detail::mix;
+        using detail::read;
+
+        seed ^= mix(seed ^ hashSecret[0], hashSecret[1]);
+        size_t len = data.size();
+        size_t pos = 0;
+        uint64_t a = 0, b = 0;
+
+        if (len <= 16)
+        {
+            if (len >= 8)
+            {
+                a = read(data, 0, 8);
+                b = read(data, len - 8, 8);
+            }
+            else if (len > 0)
+            {
+                a = read(data, 0, len >= 4 ? 4 : len);
+                b = read(data, len >= 4 ? len - 4 : 0, len >= 4 ? 4 : len) << 3;
+            }
+        }
+        else
+        {
+            for (; len - pos > 16; pos += 16)
+                seed = mix(read(data, pos, 8) ^ hashSecret[1], read(data, pos + 8, 8) ^ seed);
+            a = read(data, len - 16, 8);
+            b = read(data, len - 8, 8);
+        }
+
+        return mix(hashSecret[1] ^ len, mix(a ^ hashSecret[1], b ^ seed));
+    }
+
+    constexpr uint64_t hashCombine(uint64_t a, uint64_t b)
+    {
+        return detail::mix(a ^ detail::hashSecret[2], b ^ detail::hashSecret[3]);
+    }
+
+    /*
+     * Precompiled member name. The hash is computed once, when the key is
+     * constructed, and at compile time for a constexpr Key, so lookups with
+     * it neither build a std::string nor rehash the name:
+     *
+     *     static constexpr json::Key userId{"user_id"};
+     *     auto it = object.find(userId);
+     *
+     * A Key only views its name, which must outlive it (string literals do).
+     */
+    class Key
+    {
+    public:
+        explicit constexpr Key(std::string_view name) : name_(name), hash_(hashBytes(name)) {}
+        explicit constexpr Key(const char *name) : Key(std::string_view(name)) {}
+
+        constexpr std::string_view view() const { return name_; }
+        constexpr uint64_t hash() const { return hash_; }
+
+    private:
+        std::string_view name_;
+        uint64_t hash_;
+    };
+
+    // Transparent hash and equality for containers keyed by member name; they
+    // accept a Key or any string type without building a std::string.
+    struct KeyHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view key) const { return static_cast<size_t>(hashBytes(key)); }
+        size_t operator()(const std::string &key) const { return static_cast<size_t>(hashBytes(key)); }
+        size_t operator()(const char *key) const { return static_cast<size_t>(hashBytes(key)); }
+        size_t operator()(const Key &key) const { return static_cast<size_t>(key.hash()); }
+    };
+
+    struct KeyEqual
+    {
+        using is_transparent = void;
+
+        template <typename A, typename B>
+        bool operator()(const A &a, const B &b) const { return view(a) == view(b); }
+
+    private:
+        static std::string_view view(std::string_view key) { return key; }
+        static std::string_view view(const std::string &key) { return key; }
+        static std::string_view view(const char *key) { return key; }
+        static std::string_view view(const Key &key) { return key.view(); }
+    };
+}
+
+#endif // KEY_H
@@ -0,0 +1,107 @@
+#ifndef LARGE_PAGES_H
+#define LARGE_PAGES_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace json
+{
+    // What the running kernel offers, detected once on first use.
+    struct LargePageSupport
+    {
+        bool hugetlb = false;     // preallocated huge pages (vm.nr_hugepages > 0)
+        bool transparent = false; // THP in "always" or "madvise" mode
+        bool numa = false;        // more than one memory node and mbind works
+        size_t hugePageSize = 0;  // bytes, 0 when unknown
+    };
+
+    const LargePageSupport &largePageSupport();
+
+    struct LargePageOptions
+    {
+        // Back mappings with huge pages: MAP_HUGETLB when the pool has pages,
+        // otherwise madvise(MADV_HUGEPAGE).
+        bool hugePages = true;
+        // mbind mappings to the NUMA node of the allocating thread.
+        bool localNode = true;
+        // LargePageResource only: smaller requests go to the upstream resource.
+        size_t minBytes = size_t(2) << 20;
+    };
+
+    // How a mapping ended up being backed.
+    struct LargePagePlacement
+    {
+        bool hugetlb = false;
+        bool transparent = false;
+        int node = -1; // bound NUMA node, -1 when not bound
+    };
+
+    /*
+     * Buffer for a large input document in its own anonymous mapping, backed
+     * by huge pages and placed on the parsing thread's NUMA node where the
+     * host allows; every unavailable feature silently falls back to normal
+     * pages. Allocate (or readFile) on the thread that will parse it.
+     */
+    class LargeBuffer
+    {
+    public:
+        LargeBuffer() = default;
+        explicit LargeBuffer(size_t size, const LargePageOptions &options = {});
+        ~LargeBuffer();
+
+        LargeBuffer(LargeBuffer &&other) noexcept;
+        LargeBuffer &operator=(LargeBuffer &&other) noexcept;
+
+        // Throws std::runtime_error if the file cannot be read.
+        static LargeBuffer readFile(const std::string &path, const LargePageOptions &options = {});
+
+        char *data() { return data_; }
+        const char *data() const { return data_; }
+        size_t size() const { return size_; }
+        std::string_view view() const { return std::string_view(data_, size_); }
+        const LargePagePlacement &placement() const { return placement_; }
+
+    private:
+        char *data_ = nullptr;
+        size_t size_ = 0;
+        size_t mapped_ = 0;
+        LargePagePlacement placement_;
+    };
+
+    /*
+     * Memory resource that maps requests of options.minBytes and above
+     * directly, with the same huge-page and NUMA treatment as LargeBuffer,
+     * and passes smaller ones upstream. Use it as the upstream of a
+     * std::pmr::monotonic_buffer_resource to get a huge-page arena for
+     * pmr containers built while decoding. Thread-safe.
+     */
+    class LargePageResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit LargePageResource(const LargePageOptions &options = {},
+                                   std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+        ~LargePageResource() override;
+
+        LargePageResource(const LargePageResource &) = delete;
+        LargePageResource &operator=(const LargePageResource &) = delete;
+
+        // Number of live mappings, for tests and diagnostics.
+        size_t mappings() const;
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        LargePageOptions options_;
+        std::pmr::memory_resource *upstream_;
+        mutable std::mutex mutex_;
+        std::unordered_map<void *, size_t> mapped_;
+    };
+}
+
+#endif // LARGE_PAGES_H
@@ -0,0 +1,63 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "Json.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace json
+{
+    /*
+     * Heap bytes owned by a JsonValue tree, by component. These are the
+     * sizes requested from the allocator (malloc's own headers and rounding
+     * are not included); the root JsonValue itself is not counted, since it
+     * usually lives on the stack or inside something else.
+     */
+    struct MemoryUsage
+    {
+        size_t strings = 0; // string value buffers, including decoded lazy strings
+        size_t keys = 0;    // member name buffers
+        size_t arrays = 0;  // element buffers, by capacity
+        size_t objects = 0; // hash-table nodes and bucket arrays
+
+        size_t total() const { return strings + keys + arrays + objects; }
+    };
+
+    // Short strings held inline (SSO) cost nothing.
+    MemoryUsage memory_usage(const JsonValue &value);
+
+    struct MemoryEstimate
+    {
+        size_t bytes = 0; // predicted memory_usage(jsonDecode(input)).total()
+
+        size_t objects = 0;
+        size_t arrays = 0;
+        size_t members = 0;
+        size_t elements = 0;
+        size_t strings = 0; // string values, not member names
+
+        // DepthLimitExceeded when nesting passed maxDepth and the scan
+        // stopped there; UnexpectedEndOfInput when containers were left
+        // open. Either way the counts cover what was scanned, with open
+        // containers counted as closed.
+        ParseErrorCode error = ParseErrorCode::None;
+    };
+
+    /*
+     * Predicts the decoded size of `input` from one pass over its bytes,
+     * counting containers, members and string lengths, without tokenising
+     * or building anything; use it to reject oversized requests before
+     * decoding. The input is not validated, so the estimate of malformed
+     * text is meaningless. Escaped strings are counted at their escaped
+     * length and hash-table growth is approximated, so expect it to run a
+     * few percent high for typical documents.
+     *
+     * Scratch memory is bounded by `maxDepth` (the parser's default limit),
+     * so adversarial input such as megabytes of '[' costs a fixed amount;
+     * check `error` before trusting `bytes`.
+     */
+    MemoryEstimate estimate_memory_usage(std::string_view input, size_t maxDepth = ParseLimits{}.maxDepth);
+}
+
+#endif // MEMORY_H
@@ -0,0 +1,49 @@
+#ifndef PATCH_H
+#define PATCH_H
+
+#include "Json.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace json
+{
+    class PatchException : public std::runtime_error
+    {
+    public:
+        PatchException(size_t operation, const std::string &message)
+            : std::runtime_error("Patch operation " + std::to_string(operation) + ": " + message),
+              operation_(operation) {}
+
+        // Index of the failing operation within the patch document.
+        size_t operation() const { return operation_; }
+
+    private:
+        size_t operation_;
+    };
+
+    /*
+     * RFC 7386 JSON Merge Patch, applied in place. Only members named by the
+     * patch are visited; the rvalue overload moves patch values into place.
+     */
+    void mergePatch(JsonValue &target, const JsonValue &patch);
+    void mergePatch(JsonValue &target, JsonValue &&patch);
+
+    /*
+     * RFC 6902 JSON Patch, applied in place. Work is proportional to the
+     * number of operations and the depth of their paths. If any operation
+     * fails, the operations already applied are rolled back and a
+     * PatchException is thrown, leaving `target` unchanged.
+     */
+    void applyPatch(JsonValue &target, const JsonValue &patch);
+    void applyPatch(JsonValue &target, JsonValue &&patch);
+
+    // Produces a JSON Patch that turns `from` into `to`.
+    JsonValue diff(const JsonValue &from, const JsonValue &to);
+
+    // RFC 6901 reference-token escaping ("~" -> "~0", "/" -> "~1").
+    std::string escapePointerToken(std::string_view token);
+}
+
+#endif // PATCH_H
@@ -0,0 +1,50 @@
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace json
+{
+    /*
+     * Field allowlist for projected decoding, compiled once into a trie of
+     * object keys. Paths are RFC 6901 JSON pointers naming object members;
+     * arrays are transparent, so "/items/id" keeps the "id" member of every
+     * element of "items". A path selects its whole subtree, and the empty
+     * pointer "" selects the entire document.
+     */
+    class Projection
+    {
+    public:
+        struct Node
+        {
+            std::unordered_map<std::string, size_t> children;
+            bool whole = false;
+        };
+
+        Projection() : nodes_(1) {}
+        Projection(std::initializer_list<std::string_view> paths);
+
+        // Throws std::runtime_error for a malformed pointer.
+        Projection &add(std::string_view pointer);
+        Projection &add(const std::vector<std::string> &path);
+
+        const Node *root() const { return &nodes_.front(); }
+
+        // Child of `node` for `key`, or nullptr when the member is not
+        // projected.
+        const Node *find(const Node *node, const std::string &key) const
+        {
+            auto it = node->children.find(key);
+            return it == node->children.end() ? nullptr : &nodes_[it->second];
+        }
+
+    private:
+        std::vector<Node> nodes_;
+    };
+}
+
+#endif // PROJECTION_H
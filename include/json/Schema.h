@@ -0,0 +1,129 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include "Json.h"
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace json
+{
+    namespace detail
+    {
+        class Pattern;
+    }
+
+    // Thrown when compiling a schema that is malformed or uses a keyword
+    // outside the supported subset.
+    class SchemaException : public std::runtime_error
+    {
+    public:
+        SchemaException(const std::string &location, const std::string &message)
+            : std::runtime_error("Schema at \"" + location + "\": " + message), location_(location) {}
+
+        // JSON pointer to the offending keyword within the schema.
+        const std::string &location() const { return location_; }
+
+    private:
+        std::string location_;
+    };
+
+    /*
+     * First failure found while validating an instance. `path` is a JSON
+     * pointer into the instance. When validating raw text, `offset` is the
+     * byte offset of the failing value, and malformed JSON is reported with
+     * `parseError` set instead of a schema failure.
+     */
+    struct SchemaViolation
+    {
+        std::string path;
+        std::string message;
+        size_t offset = 0;
+        ParseErrorCode parseError = ParseErrorCode::None;
+    };
+
+    /*
+     * JSON Schema (draft 2020-12) subset compiled into a flat program of
+     * nodes. Supported keywords: type, enum, const, required, properties,
+     * additionalProperties, items, minimum, maximum, exclusiveMinimum,
+     * exclusiveMaximum, minLength, maxLength, minItems, maxItems and pattern.
+     * Annotations such as title are ignored; any other keyword is rejected
+     * rather than silently skipped.
+     *
+     * pattern takes unanchored ECMAScript syntax without backreferences,
+     * lookaround or word boundaries, and runs on a linear-time matcher: a
+     * string costs at most its length times the compiled pattern size, which
+     * is capped at 10000 instructions, so hostile strings cannot exhaust the
+     * stack or backtrack. Bound string length itself with
+     * ParseLimits::maxStringLength or maxLength.
+     *
+     * A compiled Schema is immutable, so one instance can validate from any
+     * number of threads at once.
+     */
+    class Schema
+    {
+    public:
+        // Throws SchemaException.
+        explicit Schema(const JsonValue &schema);
+
+        std::expected<void, SchemaViolation> validate(const JsonValue &instance) const;
+
+        /*
+         * Validates JSON text in a single pass over the tokens, checking the
+         * grammar and the schema together without building a DOM. Any root
+         * value is accepted. Only subtrees constrained by enum or const are
+         * materialised, to compare them.
+         */
+        std::expected<void, SchemaViolation> validateText(std::string_view input,
+                                                          const ParseLimits &limits = {}) const;
+
+    private:
+        class TextValidator;
+
+        static constexpr size_t unconstrained = static_cast<size_t>(-1);
+
+        struct Member
+        {
+            bool declared = false;           // listed under properties
+            size_t schema = unconstrained;   // its schema, when declared
+            size_t required = unconstrained; // index into Node::required
+        };
+
+        struct Node
+        {
+            uint8_t types = 0x7f; // one bit per JSON type; 0 rejects everything
+            std::optional<double> minimum, maximum, exclusiveMinimum, exclusiveMaximum;
+            size_t minLength = 0, maxLength = unconstrained;
+            size_t minItems = 0, maxItems = unconstrained;
+            std::shared_ptr<const detail::Pattern> pattern;
+            std::string patternSource;
+            std::optional<std::vector<JsonValue>> allowed; // enum/const
+            std::unordered_map<std::string, Member> members;
+            std::vector<std::string> required;
+            size_t additional = unconstrained;
+            size_t items = unconstrained;
+        };
+
+        // Per-value checks shared by the DOM and text validators. Each
+        // returns an empty string or a message describing the failure.
+        static std::string checkType(const Node &node, uint8_t type);
+        static std::string checkNumber(const Node &node, double value);
+        static std::string checkString(const Node &node, std::string_view value);
+        static std::string checkAllowed(const Node &node, const JsonValue &value);
+
+        size_t compile(const JsonValue &schema, const std::string &location);
+        bool walk(size_t index, const JsonValue &value, std::string &path, SchemaViolation &violation) const;
+
+        std::vector<Node> nodes_;
+        size_t root_ = unconstrained;
+    };
+}
+
+#endif // SCHEMA_H
@@ -0,0 +1,95 @@
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include "Json.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace json
+{
+    /*
+     * Hidden-class descriptor: an ordered set of member names, each mapped to
+     * a slot index. Records that share a Shape store their members by slot,
+     * so a name is resolved once and every further access is an indexed load.
+     */
+    class Shape
+    {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        Shape() = default;
+        Shape(std::initializer_list<std::string_view> keys);
+
+        // Slot of `key`, appending it if it is new.
+        size_t add(std::string_view key);
+
+        // npos when the shape has no such member.
+        size_t slot(const Key &key) const;
+        size_t slot(std::string_view key) const;
+
+        std::string_view key(size_t slot) const { return keys_[slot]; }
+        size_t size() const { return keys_.size(); }
+
+    private:
+        std::vector<std::string> keys_;
+        std::unordered_map<std::string, size_t, KeyHash, KeyEqual> slots_;
+    };
+
+    /*
+     * An array of objects stored against one shared Shape: each record is a
+     * row of slots, with a presence bit telling a missing member apart from a
+     * null one. Resolve a name with shape().slot() once, outside the loop:
+     *
+     *     RecordSet records = RecordSet::fromArray(std::move(array));
+     *     size_t id = records.shape().slot(Key("user_id"));
+     *     for (size_t row = 0; row < records.size(); ++row)
+     *         if (const JsonValue *value = records.get(row, id))
+     *             use(*value);
+     */
+    class RecordSet
+    {
+    public:
+        /*
+         * The shape is the union of the records' member names in first-seen
+         * order. Throws std::invalid_argument if an element is not an object.
+         */
+        static RecordSet fromArray(JsonValue::array_t records);
+
+        // Lays the records out against an existing shape; members it lacks are dropped.
+        static RecordSet fromArray(JsonValue::array_t records, std::shared_ptr<const Shape> shape);
+
+        const Shape &shape() const { return *shape_; }
+        const std::shared_ptr<const Shape> &sharedShape() const { return shape_; }
+        size_t size() const { return rows_; }
+
+        // nullptr when the record has no member in `slot`, or slot is npos.
+        const JsonValue *get(size_t row, size_t slot) const
+        {
+            if (slot >= shape_->size() || !present_[row * shape_->size() + slot])
+                return nullptr;
+            return &values_[row * shape_->size() + slot];
+        }
+
+        const JsonValue *get(size_t row, const Key &key) const { return get(row, shape_->slot(key)); }
+
+        // Rebuilds the array of objects.
+        JsonValue::array_t toArray() const;
+
+    private:
+        RecordSet(std::shared_ptr<const Shape> shape, size_t rows);
+
+        void store(size_t row, JsonObject &record);
+
+        std::shared_ptr<const Shape> shape_;
+        size_t rows_;
+        std::vector<JsonValue> values_;
+        std::vector<bool> present_;
+    };
+}
+
+#endif // SHAPE_H
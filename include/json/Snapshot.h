@@ -0,0 +1,263 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Json.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace json
+{
+    /*
+     * Binary snapshot layout (host byte order, every block 8-byte aligned).
+     *
+     *   SnapshotHeader
+     *   node blocks     16-byte SnapshotNode records; arrays store their
+     *                   children contiguously, objects store `count` sorted
+     *                   SnapshotEntry key records followed by `count` nodes
+     *   string table    deduplicated, NUL-terminated string bytes
+     *
+     * Every reference is a byte offset from the start of the buffer, so a
+     * snapshot can be mapped at any address and read without fixups.
+     */
+    namespace snapshot
+    {
+        inline constexpr char magic[8] = {'J', 'S', 'O', 'N', 'S', 'N', 'A', 'P'};
+        inline constexpr uint32_t version = 1;
+
+        enum NodeType : uint8_t
+        {
+            Null = 0,
+            Boolean,
+            Integer,
+            Float,
+            String,
+            Array,
+            Object
+        };
+
+        struct SnapshotHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t size;
+            uint64_t root;
+            uint64_t strings;
+        };
+
+        struct SnapshotNode
+        {
+            uint8_t type;
+            uint8_t reserved[3];
+            uint32_t count;
+            uint64_t payload;
+        };
+
+        struct SnapshotEntry
+        {
+            uint64_t key;
+            uint32_t length;
+            uint32_t reserved;
+        };
+
+        static_assert(sizeof(SnapshotHeader) == 40);
+        static_assert(sizeof(SnapshotNode) == 16);
+        static_assert(sizeof(SnapshotEntry) == 16);
+    }
+
+    class SnapshotObject;
+    class SnapshotArray;
+
+    /*
+     * Read-only handle to one node of a snapshot. Looking up a missing key or
+     * index yields an absent value for which exists() and every is_*() are false.
+     */
+    class SnapshotValue
+    {
+    public:
+        SnapshotValue() = default;
+        SnapshotValue(const char *base, size_t size, const snapshot::SnapshotNode *node)
+            : base_(base), size_(size), node_(node) {}
+
+        bool exists() const { return node_ != nullptr; }
+
+        bool is_null() const { return type_is(snapshot::Null); }
+        bool is_string() const { return type_is(snapshot::String); }
+        bool is_object() const { return type_is(snapshot::Object); }
+        bool is_array() const { return type_is(snapshot::Array); }
+        bool is_boolean() const { return type_is(snapshot::Boolean); }
+        bool is_number_integer() const { return type_is(snapshot::Integer); }
+        bool is_number_float() const { return type_is(snapshot::Float); }
+
+        size_t size() const;
+        bool contains(std::string_view key) const { return (*this)[key].exists(); }
+
+        SnapshotValue operator[](std::string_view key) const;
+        SnapshotValue operator[](const char *key) const { return (*this)[std::string_view(key)]; }
+        SnapshotValue operator[](size_t index) const;
+        SnapshotValue operator[](int index) const { return (*this)[static_cast<size_t>(index)]; }
+
+        SnapshotObject items() const;
+        SnapshotArray elements() const;
+
+        explicit operator std::string_view() const;
+        explicit operator JsonValue::string_t() const { return JsonValue::string_t(static_cast<std::string_view>(*this)); }
+        explicit operator JsonValue::boolean_t() const;
+        explicit operator JsonValue::number_integer_t() const;
+        explicit operator JsonValue::number_float_t() const;
+
+        JsonValue toJsonValue() const;
+
+    private:
+        const char *base_ = nullptr;
+        size_t size_ = 0;
+        const snapshot::SnapshotNode *node_ = nullptr;
+
+        bool type_is(snapshot::NodeType type) const { return node_ && node_->type == type; }
+        void expect(snapshot::NodeType type) const;
+
+        // The node's payload block of `bytes` bytes, checked against the buffer.
+        const char *payload(uint64_t bytes) const;
+
+        friend class SnapshotObject;
+        friend class SnapshotArray;
+    };
+
+    class SnapshotArray
+    {
+    public:
+        class iterator
+        {
+        public:
+            iterator(const char *base, size_t size, const snapshot::SnapshotNode *node)
+                : base_(base), size_(size), node_(node) {}
+
+            SnapshotValue operator*() const { return SnapshotValue(base_, size_, node_); }
+            iterator &operator++()
+            {
+                ++node_;
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return node_ == other.node_; }
+
+        private:
+            const char *base_;
+            size_t size_;
+            const snapshot::SnapshotNode *node_;
+        };
+
+        SnapshotArray(const char *base, size_t size, const snapshot::SnapshotNode *first, size_t count)
+            : base_(base), size_(size), first_(first), count_(count) {}
+
+        iterator begin() const { return iterator(base_, size_, first_); }
+        iterator end() const { return iterator(base_, size_, first_ + count_); }
+        size_t size() const { return count_; }
+
+    private:
+        const char *base_;
+        size_t size_;
+        const snapshot::SnapshotNode *first_;
+        size_t count_;
+    };
+
+    class SnapshotObject
+    {
+    public:
+        class iterator
+        {
+        public:
+            iterator(const char *base, size_t size, const snapshot::SnapshotEntry *entry, const snapshot::SnapshotNode *node)
+                : base_(base), size_(size), entry_(entry), node_(node) {}
+
+            std::pair<std::string_view, SnapshotValue> operator*() const
+            {
+                return {std::string_view(base_ + entry_->key, entry_->length), SnapshotValue(base_, size_, node_)};
+            }
+            iterator &operator++()
+            {
+                ++entry_;
+                ++node_;
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return node_ == other.node_; }
+
+        private:
+            const char *base_;
+            size_t size_;
+            const snapshot::SnapshotEntry *entry_;
+            const snapshot::SnapshotNode *node_;
+        };
+
+        // Every entry's key must already be checked against the buffer.
+        SnapshotObject(const char *base, size_t size, const snapshot::SnapshotEntry *entries, size_t count)
+            : base_(base), size_(size), entries_(entries), count_(count) {}
+
+        iterator begin() const { return iterator(base_, size_, entries_, values()); }
+        iterator end() const { return iterator(base_, size_, entries_ + count_, values() + count_); }
+        size_t size() const { return count_; }
+
+    private:
+        const char *base_;
+        size_t size_;
+        const snapshot::SnapshotEntry *entries_;
+        size_t count_;
+
+        const snapshot::SnapshotNode *values() const
+        {
+            return reinterpret_cast<const snapshot::SnapshotNode *>(entries_ + count_);
+        }
+    };
+
+    /*
+     * Non-owning view over a snapshot buffer. The buffer must stay alive and
+     * 8-byte aligned for as long as any value obtained from the view is used.
+     * Only the header is checked up front; every offset is checked against
+     * the buffer when it is followed, so a truncated or corrupt snapshot
+     * throws std::runtime_error instead of reading outside it.
+     */
+    class SnapshotView
+    {
+    public:
+        SnapshotView(const void *data, size_t size);
+
+        SnapshotValue root() const;
+        size_t size() const { return size_; }
+
+    private:
+        const char *base_;
+        size_t size_;
+    };
+
+    /*
+     * Snapshot file mapped read-only into memory; loading costs one mmap and a
+     * header check regardless of document size.
+     */
+    class MappedSnapshot
+    {
+    public:
+        explicit MappedSnapshot(const std::string &path);
+        ~MappedSnapshot();
+
+        MappedSnapshot(const MappedSnapshot &) = delete;
+        MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+        SnapshotView view() const { return SnapshotView(data_, size_); }
+        SnapshotValue root() const { return view().root(); }
+
+    private:
+        void *data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void *file_ = nullptr;
+        void *mapping_ = nullptr;
+#endif
+    };
+
+    std::string snapshotEncode(const JsonValue &value);
+    void snapshotWrite(const std::string &path, const JsonValue &value);
+}
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,168 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include "Json.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Nesting checks in Writer: on by default in debug builds of the library.
+// They are compiled into Writer.cpp, so choose them when building the
+// library with -DJSONPARSER_WRITER_CHECKS=ON|OFF; that exports the matching
+// JSON_WRITER_CHECKS definition to consumers. Defining the macro only in
+// consumer code does not change the prebuilt library.
+#ifndef JSON_WRITER_CHECKS
+#ifdef NDEBUG
+#define JSON_WRITER_CHECKS 0
+#else
+#define JSON_WRITER_CHECKS 1
+#endif
+#endif
+
+namespace json
+{
+    // Destination for Writer output. write() receives the buffered bytes in
+    // order and must consume all of them or throw.
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+        virtual void write(std::string_view data) = 0;
+    };
+
+    // Appends to a string owned by the caller.
+    class StringSink : public Sink
+    {
+    public:
+        explicit StringSink(std::string &out) : out_(out) {}
+        void write(std::string_view data) override { out_.append(data); }
+
+    private:
+        std::string &out_;
+    };
+
+    // Throws std::runtime_error if the stream goes bad.
+    class StreamSink : public Sink
+    {
+    public:
+        explicit StreamSink(std::ostream &out) : out_(out) {}
+        void write(std::string_view data) override;
+
+    private:
+        std::ostream &out_;
+    };
+
+    // Writes to a file descriptor the caller keeps open, retrying short
+    // writes. Throws std::system_error on failure.
+    class FdSink : public Sink
+    {
+    public:
+        explicit FdSink(int fd) : fd_(fd) {}
+        void write(std::string_view data) override;
+
+    private:
+        int fd_;
+    };
+
+    class CallbackSink : public Sink
+    {
+    public:
+        explicit CallbackSink(std::function<void(std::string_view)> callback) : callback_(std::move(callback)) {}
+        void write(std::string_view data) override { callback_(data); }
+
+    private:
+        std::function<void(std::string_view)> callback_;
+    };
+
+    /*
+     * Streaming JSON encoder. Output is built in a fixed-size buffer and
+     * handed to the sink whenever the buffer fills, so memory stays bounded
+     * by the buffer size plus the longest single string or key. Strings and
+     * doubles go through the same escaping and shortest-round-trip number
+     * routines as jsonEncodeCanonical; integers are written exactly.
+     *
+     *     Writer w(sink);
+     *     w.begin_object().key("ids").begin_array().value(1).value(2).end_array().end_object();
+     *     w.flush();
+     *
+     * Misuse (a key outside an object, mismatched ends, a second root value)
+     * throws std::logic_error when JSON_WRITER_CHECKS is enabled; otherwise
+     * the output is simply malformed. The destructor flushes but swallows
+     * sink errors, so call flush() to observe them.
+     */
+    class Writer
+    {
+    public:
+        static constexpr size_t defaultBufferSize = 64 * 1024;
+
+        explicit Writer(Sink &sink, size_t bufferSize = defaultBufferSize);
+        ~Writer();
+
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        Writer &begin_object();
+        Writer &end_object();
+        Writer &begin_array();
+        Writer &end_array();
+        Writer &key(std::string_view name);
+
+        Writer &value(std::nullptr_t);
+        Writer &value(bool b);
+        Writer &value(double d); // throws std::runtime_error for NaN and infinities
+        Writer &value(std::string_view s);
+        Writer &value(const char *s) { return value(std::string_view(s)); }
+        Writer &value(const std::string &s) { return value(std::string_view(s)); }
+
+        template <std::integral T>
+            requires(!std::same_as<T, bool>)
+        Writer &value(T n)
+        {
+            if constexpr (std::is_signed_v<T>)
+                return integer(static_cast<int64_t>(n), false);
+            else
+                return integer(static_cast<int64_t>(n), true);
+        }
+
+        // Streams a whole subtree, members in the object's iteration order.
+        Writer &value(const JsonValue &v);
+
+        // Hands everything buffered so far to the sink.
+        void flush();
+
+        // Open containers.
+        size_t depth() const { return stack_.size(); }
+
+    private:
+        struct Frame
+        {
+            bool object;
+            bool empty = true;
+        };
+
+        Sink &sink_;
+        size_t bufferSize_;
+        std::string buffer_;
+        std::vector<Frame> stack_;
+        bool afterKey_ = false;
+        bool done_ = false;
+
+        // Separator and checks before any value, container or key.
+        void prefix(bool isKey);
+        void close(bool object);
+        void maybeFlush()
+        {
+            if (buffer_.size() >= bufferSize_)
+                flush();
+        }
+        Writer &integer(int64_t n, bool isUnsigned);
+    };
+}
+
+#endif // WRITER_H
@@ -0,0 +1,48 @@
+#ifndef FORMATTER_H
+#define FORMATTER_H
+
+#include <string>
+#include <string_view>
+
+namespace json::formatter
+{
+    /*
+     * Streaming reformatters: they rewrite whitespace straight from the input
+     * bytes to the output buffer without tokenising or building a DOM, so key
+     * order and number spelling are preserved exactly. Input is assumed to be
+     * valid JSON; run validator::validate first when that is not guaranteed.
+     */
+
+    // Simd scans with the runtime-selected kernels (parser/Kernels.h);
+    // Scalar always uses the portable ones.
+    enum class MinifyMode
+    {
+        Scalar,
+        Simd
+    };
+
+    struct PrettyOptions
+    {
+        size_t indent = 4;
+        char indentChar = ' ';
+    };
+
+    void minify(std::string_view input, std::string &out, MinifyMode mode = MinifyMode::Scalar);
+    void prettify(std::string_view input, std::string &out, const PrettyOptions &options = {});
+
+    inline std::string minify(std::string_view input, MinifyMode mode = MinifyMode::Scalar)
+    {
+        std::string out;
+        minify(input, out, mode);
+        return out;
+    }
+
+    inline std::string prettify(std::string_view input, const PrettyOptions &options = {})
+    {
+        std::string out;
+        prettify(input, out, options);
+        return out;
+    }
+}
+
+#endif // FORMATTER_H
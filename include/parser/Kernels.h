@@ -0,0 +1,99 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+namespace json
+{
+    // Instruction sets the byte-scanning kernels are built for, in order of
+    // preference.
+    enum class Isa
+    {
+        Scalar = 0,
+        Sse42,
+        Avx2,
+        Avx512
+    };
+
+    inline const char *toString(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Sse42:
+            return "sse4.2";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+        }
+        return "unknown";
+    }
+
+    inline std::ostream &operator<<(std::ostream &os, Isa isa)
+    {
+        return os << toString(isa);
+    }
+
+    /*
+     * Table of byte-scanning kernels for one instruction set. Each scan
+     * starts at `pos` and returns the index of the first matching byte, or
+     * `size` when there is none.
+     */
+    struct Kernels
+    {
+        Isa isa;
+
+        // First byte that is not JSON whitespace.
+        size_t (*skipWhitespace)(const char *data, size_t size, size_t pos);
+
+        // First byte a JSON string cannot hold verbatim: '"', '\\' or a
+        // control character. Used to scan strings and to find what to escape.
+        size_t (*findStringSpecial)(const char *data, size_t size, size_t pos);
+
+        // First JSON whitespace byte or '"'.
+        size_t (*findWhitespaceOrQuote)(const char *data, size_t size, size_t pos);
+
+        // First byte that is not an ASCII digit.
+        size_t (*skipDigits)(const char *data, size_t size, size_t pos);
+
+        // Whether the bytes are well-formed UTF-8 (no overlongs, surrogates or
+        // code points above U+10FFFF).
+        bool (*validateUtf8)(const char *data, size_t size);
+    };
+
+    /*
+     * Runtime kernel selection. The best instruction set the CPU supports is
+     * chosen on first use; the JSONPARSER_ISA environment variable (scalar,
+     * sse4.2, avx2 or avx512) caps it, and select() overrides it later.
+     */
+    namespace kernels
+    {
+        bool supported(Isa isa);
+
+        // Best instruction set this CPU (and build) supports.
+        Isa best();
+
+        // Kernels for `isa`, or nullptr when it is not supported.
+        const Kernels *forIsa(Isa isa);
+
+        const Kernels &active();
+
+        // Switches the active kernels; returns false, changing nothing, when
+        // `isa` is not supported.
+        bool select(Isa isa);
+
+        std::optional<Isa> parseIsa(std::string_view name);
+    }
+
+    inline bool isValidUtf8(std::string_view text)
+    {
+        return kernels::active().validateUtf8(text.data(), text.size());
+    }
+}
+
+#endif // KERNELS_H
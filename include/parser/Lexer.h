@@ -1,13 +1,17 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "ParseFlags.h"
 #include "Token.h"
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace json
 {
+    struct Kernels;
 
     class Lexer
     {
@@ -17,16 +21,92 @@ namespace json
 
         std::vector<Token> tokenise();
 
+        // Refills `tokens` in place, keeping its capacity for the next call.
+        // `Flags` (see ParseFlags) enables syntax extensions; the strict
+        // default is the RFC 8259 scanner. With TrailingCommas the redundant
+        // comma is dropped here, so the parser never sees it. The tokens end
+        // with an EndOfFile positioned at the input size, or at the first
+        // Invalid token.
+        template <unsigned Flags = ParseFlags::Strict>
+        void tokenise(std::vector<Token> &tokens);
+
+        // Points the lexer at new input; internal scratch buffers are kept.
+        void reset(std::string_view input)
+        {
+            input_ = input;
+            pos_ = 0;
+            partial_ = 0;
+        }
+
+        // Incremental lexing for input that arrives in pieces. `input` must
+        // start with the bytes the lexer was already given; scanning resumes
+        // where it stopped. Unless `final` is set, a token that runs into the
+        // end of the buffer may be truncated, so it is left for the next call.
+        // An unterminated string is only scanned for its closing quote, and
+        // from where the previous call stopped, so a long string arriving in
+        // small pieces is still lexed in linear time.
+        // Tokens are appended to `tokens`; returns the number added.
+        void extend(std::string_view input) { input_ = input; }
+        size_t tokeniseAvailable(std::vector<Token> &tokens, bool final);
+
+        // As extend, for a caller that has dropped the bytes before
+        // position(): `input` starts at the old position().
+        void rebase(std::string_view input)
+        {
+            input_ = input;
+            pos_ = 0;
+        }
+        size_t position() const { return pos_; }
+
+        void setStringStorage(StringStorage storage) { storage_ = storage; }
+
+        // Pull interface: appends the next token, or returns false at end of
+        // input without appending anything.
+        bool next(std::vector<Token> &tokens);
+
+        // Steps over one value in the raw bytes without producing tokens.
+        // Containers are matched by bracket counting with strings skipped,
+        // so their contents are not otherwise validated. Returns false, with
+        // position() at the problem, if no complete value follows.
+        bool skipValue();
+
+        bool eof() const { return pos_ >= input_.size(); }
+        void seek(size_t pos) { pos_ = pos; }
+
+        // Raw scanning primitives, shared with tools that work on the byte
+        // stream directly instead of on tokens.
+        static bool isWhitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+        static size_t scanWhitespace(std::string_view input, size_t pos);
+        static size_t scanString(std::string_view input, size_t pos);
+        static size_t scanString(std::string_view input, size_t pos, const Kernels &kernels);
+
+        // Decodes string contents starting just past the opening quote,
+        // appending to `out` unless it is null (validation only). On success
+        // `pos` is past the closing quote. On failure `error` is the offending
+        // byte, or npos if the input ran out first.
+        static bool decodeString(std::string_view input, size_t &pos, std::string *out, size_t &error);
+
+        // Decodes the escaped text between a string's quotes, as recorded in
+        // Token::raw. The text must already have been validated.
+        static std::string unescape(std::string_view raw);
+
     private:
         std::string_view input_;
         size_t pos_;
+        size_t partial_ = 0; // bytes of an unterminated string at pos_ already scanned
+        std::string scratch_;
+        StringStorage storage_ = StringStorage::Copy;
 
         char peek() const { return pos_ < input_.size() ? input_[pos_] : '\0'; }
         char get() { return pos_ < input_.size() ? input_[pos_++] : '\0'; }
-        bool eof() const { return pos_ >= input_.size(); }
 
         void skipWhitespace();
+        void skipWhitespaceAndComments();
+        size_t scanPartialString(size_t pos) const;
         Token nextToken();
+        template <unsigned Flags>
+        Token nextRelaxedToken();
+        Token parseSingleQuotedString();
 
         Token parseString();
         Token parseNumber();
@@ -0,0 +1,129 @@
+#ifndef PARSE_ERROR_H
+#define PARSE_ERROR_H
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace json
+{
+    enum class ParseErrorCode
+    {
+        None = 0,
+        InvalidToken,
+        UnexpectedToken,
+        UnexpectedEndOfInput,
+        ExpectedValue,
+        ExpectedKey,
+        ExpectedColon,
+        ExpectedCommaOrBrace,
+        ExpectedCommaOrBracket,
+        InvalidNumber,
+        TrailingContent,
+        DepthLimitExceeded,
+        DocumentTooLarge,
+        StringTooLong,
+        TooManyElements
+    };
+
+    inline const char *toString(ParseErrorCode code)
+    {
+        switch (code)
+        {
+        case ParseErrorCode::None:
+            return "no error";
+        case ParseErrorCode::InvalidToken:
+            return "invalid token";
+        case ParseErrorCode::UnexpectedToken:
+            return "unexpected token";
+        case ParseErrorCode::UnexpectedEndOfInput:
+            return "unexpected end of input";
+        case ParseErrorCode::ExpectedValue:
+            return "expected a value";
+        case ParseErrorCode::ExpectedKey:
+            return "expected a string key";
+        case ParseErrorCode::ExpectedColon:
+            return "expected ':' after key";
+        case ParseErrorCode::ExpectedCommaOrBrace:
+            return "expected ',' or '}' in object";
+        case ParseErrorCode::ExpectedCommaOrBracket:
+            return "expected ',' or ']' in array";
+        case ParseErrorCode::InvalidNumber:
+            return "invalid number";
+        case ParseErrorCode::TrailingContent:
+            return "unexpected content after document";
+        case ParseErrorCode::DepthLimitExceeded:
+            return "maximum nesting depth exceeded";
+        case ParseErrorCode::DocumentTooLarge:
+            return "document exceeds maximum size";
+        case ParseErrorCode::StringTooLong:
+            return "string exceeds maximum length";
+        case ParseErrorCode::TooManyElements:
+            return "document exceeds maximum element count";
+        }
+        return "unknown error";
+    }
+
+    inline std::ostream &operator<<(std::ostream &os, ParseErrorCode code)
+    {
+        return os << toString(code);
+    }
+
+    /*
+     * Plain error record returned by the non-throwing decode API. `offset` is a
+     * byte offset into the input; line and column are 1-based and are only
+     * filled in once locate() has been given the source text.
+     */
+    struct ParseError
+    {
+        ParseErrorCode code = ParseErrorCode::None;
+        size_t offset = 0;
+        size_t line = 0;
+        size_t column = 0;
+
+        void locate(std::string_view input)
+        {
+            line = 1;
+            column = 1;
+            size_t end = offset < input.size() ? offset : input.size();
+            for (size_t i = 0; i < end; ++i)
+            {
+                if (input[i] == '\n')
+                {
+                    ++line;
+                    column = 1;
+                }
+                else
+                {
+                    ++column;
+                }
+            }
+        }
+
+        std::string describe() const
+        {
+            std::string text = toString(code);
+            if (line != 0)
+                text += " at line " + std::to_string(line) + ", column " + std::to_string(column);
+            else
+                text += " at offset " + std::to_string(offset);
+            return text;
+        }
+    };
+
+    class ParseException : public std::runtime_error
+    {
+    public:
+        explicit ParseException(const ParseError &error)
+            : std::runtime_error(error.describe()), error_(error) {}
+
+        const ParseError &error() const { return error_; }
+
+    private:
+        ParseError error_;
+    };
+}
+
+#endif // PARSE_ERROR_H
@@ -0,0 +1,29 @@
+#ifndef PARSE_FLAGS_H
+#define PARSE_FLAGS_H
+
+namespace json
+{
+    /*
+     * Syntax extensions, chosen at compile time as the template argument of
+     * jsonDecodeWith/jsonTryDecodeWith (and Lexer::tokenise). Each set of
+     * flags gets its own lexer instantiation, so the strict one is the plain
+     * RFC 8259 scanner with no relaxed-mode branches in it.
+     */
+    struct ParseFlags
+    {
+        static constexpr unsigned Strict = 0;
+        static constexpr unsigned Comments = 1u << 0;       // "// line" and "/* block */"
+        static constexpr unsigned TrailingCommas = 1u << 1; // [1, 2,] and {"a": 1,}
+        static constexpr unsigned NonFinite = 1u << 2;      // NaN, Infinity, -Infinity
+        static constexpr unsigned SingleQuotes = 1u << 3;   // 'strings' and 'keys'
+
+        static constexpr unsigned Json5Lite = Comments | TrailingCommas | NonFinite | SingleQuotes;
+    };
+
+// Expands X(flags) for every combination, to explicitly instantiate the
+// flag templates in their translation units.
+#define JSON_FOR_EACH_PARSE_FLAGS(X) \
+    X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15)
+}
+
+#endif // PARSE_FLAGS_H
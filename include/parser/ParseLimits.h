@@ -0,0 +1,25 @@
+#ifndef PARSE_LIMITS_H
+#define PARSE_LIMITS_H
+
+#include <cstddef>
+#include <limits>
+
+namespace json
+{
+    /*
+     * Resource limits enforced while decoding untrusted input. Exceeding one
+     * fails the parse with the matching ParseErrorCode instead of exhausting
+     * memory. Nesting depth is bounded by default; the others are opt-in.
+     */
+    struct ParseLimits
+    {
+        static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+        size_t maxDepth = 1024;              // open objects/arrays
+        size_t maxDocumentSize = unlimited;  // input bytes
+        size_t maxStringLength = unlimited;  // decoded bytes, keys included
+        size_t maxElements = unlimited;      // values of any kind, root included
+    };
+}
+
+#endif // PARSE_LIMITS_H
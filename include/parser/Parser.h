@@ -2,8 +2,13 @@
 #define PARSER_H
 
 #include "Lexer.h"
+#include "ParseError.h"
+#include "ParseLimits.h"
 #include "json/Json.h"
+#include "json/Projection.h"
 
+#include <cstddef>
+#include <expected>
 #include <vector>
 #include <memory>
 #include <string>
@@ -11,28 +16,121 @@
 
 namespace json
 {
+    /*
+     * Iterative parser over a token stream. Nesting is tracked on an explicit
+     * stack of open containers, so native stack usage is constant regardless
+     * of document depth and ParseLimits are checked as each value is built.
+     *
+     * All engine state lives in members, so a parse can also be driven
+     * incrementally with begin()/resume() while tokens are still arriving.
+     */
     class Parser
     {
     public:
-        Parser(std::vector<Token> tokens)
-            : tokens_(tokens), pos_(0) {}
+        enum class Progress
+        {
+            Complete,  // the value passed to begin() is fully built
+            NeedInput, // ran out of tokens; append more and resume
+            Failed     // see error()
+        };
 
+        Parser(std::vector<Token> tokens, const ParseLimits &limits = {})
+            : tokens_(std::move(tokens)), pos_(0), limits_(limits) {}
+
+        // Throws ParseException on malformed input.
         JsonObject parse();
 
+        // Reports malformed input through the return value instead of throwing.
+        std::expected<JsonValue, ParseError> tryParse();
+
+        // As tryParse, but any value is accepted at the root (RFC 8259), not
+        // only an object.
+        std::expected<JsonValue, ParseError> tryParseValue();
+
+        // Token buffer and reset hook for callers that reuse one parser (and
+        // its token and nesting-stack capacity) across documents.
+        std::vector<Token> &tokens() { return tokens_; }
+        void reset(const ParseLimits &limits)
+        {
+            pos_ = 0;
+            limits_ = limits;
+            source_ = nullptr;
+            projection_ = nullptr;
+        }
+        size_t stackCapacity() const { return stack_.capacity(); }
+
+        // Must match the lexer that produced the tokens. With Lazy, string
+        // values become LazyStrings over the lexer's input.
+        void setStringStorage(StringStorage storage) { storage_ = storage; }
+
+        // Builds only the members selected by `projection`. Tokens are pulled
+        // from `source` one at a time rather than read from tokens(), so
+        // unselected subtrees are stepped over in the raw bytes and never
+        // tokenised or allocated. Skipped values do not count towards the
+        // element, depth or string limits. Cleared by reset().
+        void setProjection(const Projection &projection, Lexer &source)
+        {
+            projection_ = &projection;
+            source_ = &source;
+        }
+
+        // Incremental interface: begin() targets `out` and resume() consumes
+        // the buffered tokens. Until `final` is set, running out of tokens
+        // yields NeedInput instead of an end-of-input error.
+        void begin(JsonValue &out);
+        Progress resume(bool final);
+        size_t position() const { return pos_; }
+
+        // Drops tokens resume() has already consumed so a long stream does
+        // not accumulate them.
+        void discardConsumed()
+        {
+            tokens_.erase(tokens_.begin(), tokens_.begin() + static_cast<std::ptrdiff_t>(pos_));
+            pos_ = 0;
+        }
+        const ParseError &error() const { return error_; }
+
     private:
+        enum class State
+        {
+            Value,
+            ObjectStart,
+            ArrayStart,
+            Key,
+            Colon,
+            AfterValue
+        };
+
+        // `node` is the projection applied to the container's members, or
+        // nullptr when the whole container is kept.
+        struct Frame
+        {
+            JsonObject *object;
+            JsonValue::array_t *array;
+            const Projection::Node *node;
+        };
+
         std::vector<Token> tokens_;
         size_t pos_;
+        ParseLimits limits_;
+        StringStorage storage_ = StringStorage::Copy;
+        ParseError error_;
+        std::vector<Frame> stack_;
+        size_t elements_ = 0;
+        State state_ = State::Value;
+        JsonValue *target_ = nullptr;
+        std::string key_;
+        const Projection *projection_ = nullptr;
+        const Projection::Node *node_ = nullptr;
+        Lexer *source_ = nullptr;
 
+        bool fill();
         const Token &current();
-        void consume(TokenType expectedType);
-
-        JsonValue parseValue();
-        JsonObject parseObject();
-        JsonValue parseArray();
-        JsonValue parseString();
-        JsonValue parseNumber();
-        JsonValue parseLiteral();
+        bool fail(ParseErrorCode code);
+
+        bool parseDocument(JsonValue &out, bool anyRoot);
+        bool checkString(const Token &token);
     };
 }
 
-#endif // PARSER_H
\ No newline at end of file
+#endif // PARSER_H
@@ -0,0 +1,71 @@
+#ifndef PARSER_CONTEXT_H
+#define PARSER_CONTEXT_H
+
+#include "Lexer.h"
+#include "Parser.h"
+
+#include <expected>
+#include <string_view>
+
+namespace json
+{
+    /*
+     * Reusable lexer/parser pair. The token vector, string scratch buffer and
+     * nesting stack keep their capacity between decode() calls, so parsing a
+     * stream of similarly sized messages stops allocating parser state after
+     * the first few. Not thread-safe: keep one per thread, e.g. via local().
+     */
+    class ParserContext
+    {
+    public:
+        // Buffers grown past this many tokens are released after a decode so
+        // one huge document does not pin memory for the life of the thread.
+        static constexpr size_t defaultRetainedTokens = size_t(1) << 20;
+
+        explicit ParserContext(size_t retainedTokens = defaultRetainedTokens)
+            : lexer_(std::string_view()), parser_({}), retainedTokens_(retainedTokens) {}
+
+        ParserContext(const ParserContext &) = delete;
+        ParserContext &operator=(const ParserContext &) = delete;
+
+        std::expected<JsonValue, ParseError> decode(std::string_view input, const ParseLimits &limits = {},
+                                                    StringStorage storage = StringStorage::Copy);
+
+        // Accepts any value at the root, not only an object.
+        std::expected<JsonValue, ParseError> decodeValue(std::string_view input, const ParseLimits &limits = {},
+                                                         StringStorage storage = StringStorage::Copy);
+
+        // Accepts the syntax extensions in `Flags` (see ParseFlags).
+        // decodeWith<ParseFlags::Strict> is equivalent to decode().
+        template <unsigned Flags>
+        std::expected<JsonValue, ParseError> decodeWith(std::string_view input, const ParseLimits &limits = {});
+
+        // Decodes only the members selected by `projection`; see
+        // Parser::setProjection.
+        std::expected<JsonValue, ParseError> decode(std::string_view input, const Projection &projection,
+                                                    const ParseLimits &limits = {});
+
+        size_t tokenCapacity() { return parser_.tokens().capacity(); }
+        size_t stackCapacity() const { return parser_.stackCapacity(); }
+
+        // The calling thread's context, used by jsonDecode/jsonTryDecode.
+        static ParserContext &local();
+
+    private:
+        // Resets the lexer and parser for a new document.
+        void prepare(std::string_view input, const ParseLimits &limits, StringStorage storage);
+
+        // Size check, prepare, tokenise with `Flags`, then finish.
+        template <unsigned Flags>
+        std::expected<JsonValue, ParseError> run(std::string_view input, const ParseLimits &limits,
+                                                 StringStorage storage, bool anyRoot);
+
+        std::expected<JsonValue, ParseError> finish(std::string_view input, bool anyRoot = false);
+
+        Lexer lexer_;
+        Parser parser_;
+        size_t retainedTokens_;
+    };
+}
+
+#endif // PARSER_CONTEXT_H
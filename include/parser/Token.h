@@ -2,6 +2,7 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 
 namespace json
 {
@@ -25,6 +26,13 @@ namespace json
         Invalid
     };
 
+    // How the lexer hands string contents to its consumer.
+    enum class StringStorage
+    {
+        Copy, // decoded into Token::value
+        Lazy  // left in the source, described by Token::raw/escaped
+    };
+
     class Token
     {
     public:
@@ -32,6 +40,11 @@ namespace json
         std::string value;
         size_t position;
 
+        // Set instead of `value` for strings lexed with StringStorage::Lazy:
+        // the source text between the quotes and whether it holds escapes.
+        std::string_view raw;
+        bool escaped = false;
+
         Token(TokenType t, std::string v = "", size_t pos = 0)
             : type(t), value(std::move(v)), position(pos) {}
     };
@@ -0,0 +1,147 @@
+#include "json/Async.h"
+#include "parser/Lexer.h"
+#include "parser/Parser.h"
+
+#include <string>
+
+namespace json
+{
+    namespace
+    {
+        struct Yield
+        {
+            const std::function<void(std::coroutine_handle<>)> &schedule;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const { schedule(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        // Line/column bookkeeping for the bytes already dropped from the
+        // front of the buffer, so errors still point into the whole stream.
+        struct StreamPosition
+        {
+            size_t offset = 0;
+            size_t line = 1;
+            size_t column = 1;
+
+            void advance(std::string_view bytes)
+            {
+                for (char c : bytes)
+                {
+                    if (c == '\n')
+                    {
+                        ++line;
+                        column = 1;
+                    }
+                    else
+                    {
+                        ++column;
+                    }
+                }
+                offset += bytes.size();
+            }
+
+            // `error.offset` is relative to `buffer`, which starts at this position.
+            std::unexpected<ParseError> fail(ParseError error, std::string_view buffer) const
+            {
+                error.locate(buffer);
+                if (error.line == 1)
+                    error.column += column - 1;
+                error.line += line - 1;
+                error.offset += offset;
+                return std::unexpected(error);
+            }
+        };
+
+        ParseErrorCode unexpected(const Token &token, ParseErrorCode code)
+        {
+            return token.type == TokenType::Invalid ? ParseErrorCode::InvalidToken : code;
+        }
+    }
+
+    Task<std::expected<JsonValue, ParseError>> asyncDecode(AsyncReader &reader, AsyncDecodeOptions options)
+    {
+        std::string buffer;
+        Lexer lexer{std::string_view()};
+        Parser parser({}, options.limits);
+        std::vector<Token> &tokens = parser.tokens();
+        StreamPosition start;
+        JsonValue root;
+
+        size_t total = 0;
+        size_t sinceYield = 0;
+        bool eof = false;
+        bool started = false;
+        bool complete = false;
+
+        while (true)
+        {
+            if (!eof)
+            {
+                size_t used = buffer.size();
+                buffer.resize(used + options.chunkSize);
+                size_t read = co_await reader.read(std::span<char>(buffer.data() + used, options.chunkSize));
+                buffer.resize(used + read);
+                eof = read == 0;
+                total += read;
+                sinceYield += read;
+
+                if (total > options.limits.maxDocumentSize)
+                    co_return start.fail({ParseErrorCode::DocumentTooLarge, options.limits.maxDocumentSize - start.offset},
+                                         buffer);
+            }
+
+            lexer.extend(buffer);
+            lexer.tokeniseAvailable(tokens, eof);
+
+            if (!started && !tokens.empty())
+            {
+                if (tokens.front().type != TokenType::LBrace)
+                    co_return start.fail({unexpected(tokens.front(), ParseErrorCode::UnexpectedToken),
+                                          tokens.front().position},
+                                         buffer);
+                parser.begin(root);
+                started = true;
+            }
+            else if (!started && eof)
+            {
+                co_return start.fail({ParseErrorCode::UnexpectedEndOfInput, buffer.size()}, buffer);
+            }
+
+            if (started && !complete)
+            {
+                Parser::Progress progress = parser.resume(eof);
+                if (progress == Parser::Progress::Failed)
+                {
+                    ParseError error = parser.error();
+                    if (error.code == ParseErrorCode::UnexpectedEndOfInput)
+                        error.offset = buffer.size();
+                    co_return start.fail(error, buffer);
+                }
+                complete = progress == Parser::Progress::Complete;
+            }
+
+            if (complete && parser.position() < tokens.size())
+            {
+                const Token &extra = tokens[parser.position()];
+                co_return start.fail({unexpected(extra, ParseErrorCode::TrailingContent), extra.position}, buffer);
+            }
+            if (complete && eof)
+                co_return std::move(root);
+
+            // Everything lexed so far has been consumed; drop it so memory
+            // stays proportional to the chunk size rather than the document.
+            parser.discardConsumed();
+            start.advance(std::string_view(buffer).substr(0, lexer.position()));
+            buffer.erase(0, lexer.position());
+            lexer.rebase(buffer);
+
+            if (options.schedule && sinceYield >= options.yieldEvery)
+            {
+                sinceYield = 0;
+                co_await Yield{options.schedule};
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "json/Json.h"
+#include "Encoding.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace json
+{
+    namespace
+    {
+        constexpr int64_t maxExactInteger = int64_t(1) << 53;
+
+        void encodeCanonical(std::string &out, const JsonValue &value)
+        {
+            const auto &v = value.get_value();
+
+            if (std::holds_alternative<std::nullptr_t>(v))
+            {
+                out.append("null");
+            }
+            else if (std::holds_alternative<JsonValue::boolean_t>(v))
+            {
+                out.append(std::get<JsonValue::boolean_t>(v) ? "true" : "false");
+            }
+            else if (std::holds_alternative<JsonValue::number_integer_t>(v))
+            {
+                int64_t n = std::get<JsonValue::number_integer_t>(v);
+                if (n >= -maxExactInteger && n <= maxExactInteger)
+                    detail::appendInteger(out, n);
+                else
+                    detail::appendShortestNumber(out, static_cast<double>(n));
+            }
+            else if (std::holds_alternative<JsonValue::number_float_t>(v))
+            {
+                detail::appendShortestNumber(out, std::get<JsonValue::number_float_t>(v));
+            }
+            else if (value.is_string())
+            {
+                detail::appendEscaped(out, value.get_string());
+            }
+            else if (std::holds_alternative<JsonValue::array_t>(v))
+            {
+                const auto &arr = std::get<JsonValue::array_t>(v);
+                out.push_back('[');
+                for (size_t i = 0; i < arr.size(); ++i)
+                {
+                    if (i > 0)
+                        out.push_back(',');
+                    encodeCanonical(out, arr[i]);
+                }
+                out.push_back(']');
+            }
+            else
+            {
+                std::vector<std::pair<std::string_view, const JsonValue *>> members;
+                for (const auto &pair : std::get<JsonObject>(v))
+                    members.emplace_back(pair.first, &pair.second);
+                std::sort(members.begin(), members.end(),
+                          [](const auto &a, const auto &b)
+                          { return detail::utf16Less(a.first, b.first); });
+
+                out.push_back('{');
+                for (size_t i = 0; i < members.size(); ++i)
+                {
+                    if (i > 0)
+                        out.push_back(',');
+                    detail::appendEscaped(out, members[i].first);
+                    out.push_back(':');
+                    encodeCanonical(out, *members[i].second);
+                }
+                out.push_back('}');
+            }
+        }
+    }
+
+    std::string jsonEncodeCanonical(const JsonValue &value)
+    {
+        std::string out;
+        encodeCanonical(out, value);
+        return out;
+    }
+}
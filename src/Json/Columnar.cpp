@@ -0,0 +1,457 @@
+#include "json/Columnar.h"
+#include "parser/Lexer.h"
+
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace json
+{
+    Column::Column(std::string name, ColumnType type) : name_(std::move(name)), type_(type), offsets_{0} {}
+
+    void Column::pushSlot(bool valid)
+    {
+        if (length_ % 8 == 0)
+        {
+            validity_.push_back(0);
+            if (type_ == ColumnType::Boolean)
+                bits_.push_back(0);
+        }
+        if (valid)
+            validity_.back() |= static_cast<uint8_t>(1u << (length_ % 8));
+        else
+            ++nullCount_;
+        ++length_;
+    }
+
+    void Column::appendNull()
+    {
+        switch (type_)
+        {
+        case ColumnType::Int64:
+            int64s_.push_back(0);
+            break;
+        case ColumnType::Float64:
+            float64s_.push_back(0);
+            break;
+        case ColumnType::String:
+            offsets_.push_back(offsets_.back());
+            break;
+        case ColumnType::Boolean:
+            break;
+        }
+        pushSlot(false);
+    }
+
+    void Column::appendBoolean(bool value)
+    {
+        size_t row = length_;
+        pushSlot(true);
+        if (value)
+            bits_.back() |= static_cast<uint8_t>(1u << (row % 8));
+    }
+
+    void Column::appendInt64(int64_t value)
+    {
+        int64s_.push_back(value);
+        pushSlot(true);
+    }
+
+    void Column::appendFloat64(double value)
+    {
+        float64s_.push_back(value);
+        pushSlot(true);
+    }
+
+    void Column::appendString(std::string_view value)
+    {
+        if (data_.size() + value.size() > static_cast<size_t>(INT32_MAX))
+            throw std::length_error("String column '" + name_ + "' exceeds 2 GiB of data");
+        data_.append(value);
+        offsets_.push_back(static_cast<int32_t>(data_.size()));
+        pushSlot(true);
+    }
+
+    const Column *RecordBatch::column(std::string_view name) const
+    {
+        for (const Column &column : columns)
+            if (column.name() == name)
+                return &column;
+        return nullptr;
+    }
+
+    namespace
+    {
+        /*
+         * Pulls tokens for a stream of top-level objects and hands each member
+         * to a visitor, which must consume the member's value. Strings stay in
+         * the input (lazy storage) so keys are matched without copying.
+         */
+        class RecordReader
+        {
+        public:
+            explicit RecordReader(std::string_view input) : input_(input), lexer_(input)
+            {
+                lexer_.setStringStorage(StringStorage::Lazy);
+            }
+
+            const Token *next()
+            {
+                tokens_.clear();
+                return lexer_.next(tokens_) ? &tokens_.back() : nullptr;
+            }
+
+            // Null token pointer means end of input.
+            std::unexpected<ParseError> fail(const Token *token, ParseErrorCode code) const
+            {
+                if (!token)
+                    return std::unexpected(ParseError{ParseErrorCode::UnexpectedEndOfInput, input_.size()});
+                if (token->type == TokenType::Invalid)
+                    code = ParseErrorCode::InvalidToken;
+                return std::unexpected(ParseError{code, token->position});
+            }
+
+            // Skips the value whose first token is `token`, returning its text.
+            std::expected<std::string_view, ParseError> skip(const Token &token)
+            {
+                size_t start = token.position;
+                lexer_.seek(start);
+                if (!lexer_.skipValue())
+                    return std::unexpected(ParseError{lexer_.eof() ? ParseErrorCode::UnexpectedEndOfInput
+                                                                   : ParseErrorCode::ExpectedValue,
+                                                      lexer_.position()});
+                return input_.substr(start, lexer_.position() - start);
+            }
+
+            bool skipValue(ParseError &error)
+            {
+                if (lexer_.skipValue())
+                    return true;
+                error = {lexer_.eof() ? ParseErrorCode::UnexpectedEndOfInput : ParseErrorCode::ExpectedValue,
+                         lexer_.position()};
+                return false;
+            }
+
+            // visit(key) -> std::optional<ParseError> for each member, done()
+            // after each record. Stops after `limit` records.
+            template <typename Visit, typename Done>
+            std::optional<ParseError> records(Visit &&visit, Done &&done, size_t limit = SIZE_MAX)
+            {
+                std::string key;
+                for (size_t count = 0; count < limit; ++count)
+                {
+                    const Token *token = next();
+                    if (!token)
+                        break;
+                    if (token->type != TokenType::LBrace)
+                        return fail(token, ParseErrorCode::UnexpectedToken).error();
+
+                    token = next();
+                    if (!token || token->type != TokenType::RBrace)
+                    {
+                        while (true)
+                        {
+                            if (!token || token->type != TokenType::String)
+                                return fail(token, ParseErrorCode::ExpectedKey).error();
+                            std::string_view name = token->raw;
+                            if (token->escaped)
+                                name = key = Lexer::unescape(token->raw);
+
+                            token = next();
+                            if (!token || token->type != TokenType::Colon)
+                                return fail(token, ParseErrorCode::ExpectedColon).error();
+                            if (auto error = visit(name))
+                                return error;
+
+                            token = next();
+                            if (token && token->type == TokenType::Comma)
+                            {
+                                token = next();
+                                continue;
+                            }
+                            if (token && token->type == TokenType::RBrace)
+                                break;
+                            return fail(token, ParseErrorCode::ExpectedCommaOrBrace).error();
+                        }
+                    }
+                    done();
+                }
+                return std::nullopt;
+            }
+
+        private:
+            std::string_view input_;
+            Lexer lexer_;
+            std::vector<Token> tokens_;
+        };
+
+        std::optional<int64_t> toInt64(const std::string &text)
+        {
+            int64_t value;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec == std::errc() && end == text.data() + text.size())
+                return value;
+
+            // Integral values spelled with a fraction or exponent, e.g. 1.0 or 1e3.
+            double number;
+            auto [fend, fec] = std::from_chars(text.data(), text.data() + text.size(), number);
+            if (fec == std::errc() && fend == text.data() + text.size() && std::trunc(number) == number &&
+                number >= -9223372036854775808.0 && number < 9223372036854775808.0)
+                return static_cast<int64_t>(number);
+            return std::nullopt;
+        }
+
+        // nullopt when the number is out of double range, e.g. 1e999.
+        std::optional<double> toFloat64(const std::string &text)
+        {
+            double value;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec == std::errc() && end == text.data() + text.size())
+                return value;
+            return std::nullopt;
+        }
+
+        std::optional<ParseError> appendValue(RecordReader &reader, Column &column, std::string &scratch)
+        {
+            const Token *token = reader.next();
+            if (!token)
+                return reader.fail(token, ParseErrorCode::ExpectedValue).error();
+
+            switch (token->type)
+            {
+            case TokenType::LBrace:
+            case TokenType::LBracket:
+            {
+                auto text = reader.skip(*token);
+                if (!text)
+                    return text.error();
+                if (column.type() == ColumnType::String)
+                    column.appendString(*text);
+                else
+                    column.appendNull();
+                return std::nullopt;
+            }
+            case TokenType::String:
+                if (column.type() != ColumnType::String)
+                    column.appendNull();
+                else if (token->escaped)
+                    column.appendString(scratch = Lexer::unescape(token->raw));
+                else
+                    column.appendString(token->raw);
+                return std::nullopt;
+            case TokenType::Number:
+                if (column.type() == ColumnType::Int64)
+                {
+                    auto value = toInt64(token->value);
+                    value ? column.appendInt64(*value) : column.appendNull();
+                }
+                else if (column.type() == ColumnType::Float64)
+                {
+                    auto value = toFloat64(token->value);
+                    value ? column.appendFloat64(*value) : column.appendNull();
+                }
+                else if (column.type() == ColumnType::String)
+                {
+                    column.appendString(token->value);
+                }
+                else
+                {
+                    column.appendNull();
+                }
+                return std::nullopt;
+            case TokenType::True:
+            case TokenType::False:
+                if (column.type() == ColumnType::Boolean)
+                    column.appendBoolean(token->type == TokenType::True);
+                else if (column.type() == ColumnType::String)
+                    column.appendString(token->value);
+                else
+                    column.appendNull();
+                return std::nullopt;
+            case TokenType::Null:
+                column.appendNull();
+                return std::nullopt;
+            default:
+                return reader.fail(token, ParseErrorCode::ExpectedValue).error();
+            }
+        }
+
+        std::expected<RecordBatch, ParseError> shredSlice(std::string_view input, const ColumnSchema &schema)
+        {
+            RecordBatch batch;
+            std::unordered_map<std::string_view, size_t> index;
+            batch.columns.reserve(schema.size());
+            for (const ColumnField &field : schema)
+            {
+                index.emplace(field.name, batch.columns.size());
+                batch.columns.emplace_back(field.name, field.type);
+            }
+
+            RecordReader reader(input);
+            std::string scratch;
+            ParseError skipError;
+            auto error = reader.records(
+                [&](std::string_view key) -> std::optional<ParseError>
+                {
+                    auto it = index.find(key);
+                    if (it == index.end() || batch.columns[it->second].length() > batch.rows)
+                    {
+                        if (!reader.skipValue(skipError))
+                            return skipError;
+                        return std::nullopt;
+                    }
+                    return appendValue(reader, batch.columns[it->second], scratch);
+                },
+                [&]()
+                {
+                    ++batch.rows;
+                    for (Column &column : batch.columns)
+                        if (column.length() < batch.rows)
+                            column.appendNull();
+                });
+
+            if (error)
+                return std::unexpected(*error);
+            return batch;
+        }
+
+        std::unexpected<ParseError> located(ParseError error, std::string_view input)
+        {
+            error.locate(input);
+            return std::unexpected(error);
+        }
+    }
+
+    std::expected<ColumnSchema, ParseError> inferColumns(std::string_view ndjson, size_t sampleRecords)
+    {
+        // Unset until a non-null value is seen.
+        std::vector<std::pair<std::string, std::optional<ColumnType>>> columns;
+        std::unordered_map<std::string, size_t> index;
+
+        RecordReader reader(ndjson);
+        ParseError skipError;
+        auto error = reader.records(
+            [&](std::string_view key) -> std::optional<ParseError>
+            {
+                const Token *token = reader.next();
+                if (!token)
+                    return reader.fail(token, ParseErrorCode::ExpectedValue).error();
+
+                std::optional<ColumnType> seen;
+                switch (token->type)
+                {
+                case TokenType::LBrace:
+                case TokenType::LBracket:
+                    if (auto text = reader.skip(*token); !text)
+                        return text.error();
+                    seen = ColumnType::String;
+                    break;
+                case TokenType::String:
+                    seen = ColumnType::String;
+                    break;
+                case TokenType::Number:
+                    seen = token->value.find_first_of(".eE") == std::string::npos ? ColumnType::Int64
+                                                                                  : ColumnType::Float64;
+                    break;
+                case TokenType::True:
+                case TokenType::False:
+                    seen = ColumnType::Boolean;
+                    break;
+                case TokenType::Null:
+                    break;
+                default:
+                    return reader.fail(token, ParseErrorCode::ExpectedValue).error();
+                }
+
+                auto [it, inserted] = index.try_emplace(std::string(key), columns.size());
+                if (inserted)
+                    columns.emplace_back(std::string(key), std::nullopt);
+                std::optional<ColumnType> &type = columns[it->second].second;
+
+                if (!seen || type == seen)
+                    return std::nullopt;
+                if (!type)
+                    type = seen;
+                else if ((*type == ColumnType::Int64 && *seen == ColumnType::Float64) ||
+                         (*type == ColumnType::Float64 && *seen == ColumnType::Int64))
+                    type = ColumnType::Float64;
+                else
+                    type = ColumnType::String;
+                return std::nullopt;
+            },
+            []() {}, sampleRecords);
+
+        if (error)
+            return located(*error, ndjson);
+
+        ColumnSchema schema;
+        schema.reserve(columns.size());
+        for (auto &[name, type] : columns)
+            schema.push_back({std::move(name), type.value_or(ColumnType::String)});
+        return schema;
+    }
+
+    std::expected<RecordBatch, ParseError> shredRecords(std::string_view ndjson, const ColumnSchema &schema)
+    {
+        auto batch = shredSlice(ndjson, schema);
+        if (!batch)
+            return located(batch.error(), ndjson);
+        return batch;
+    }
+
+    std::expected<std::vector<RecordBatch>, ParseError> shredRecordsParallel(std::string_view ndjson,
+                                                                            const ColumnSchema &schema,
+                                                                            size_t threads)
+    {
+        // JSON strings cannot hold a raw newline, so splitting after one never
+        // cuts a record in two.
+        std::vector<std::string_view> slices;
+        size_t target = ndjson.size() / (threads == 0 ? 1 : threads) + 1;
+        size_t start = 0;
+        while (start < ndjson.size())
+        {
+            size_t end = start + target < ndjson.size() ? ndjson.find('\n', start + target) : std::string_view::npos;
+            end = end == std::string_view::npos ? ndjson.size() : end + 1;
+            slices.push_back(ndjson.substr(start, end - start));
+            start = end;
+        }
+
+        std::vector<std::expected<RecordBatch, ParseError>> results(slices.size());
+        std::vector<std::exception_ptr> failures(slices.size());
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(slices.size());
+            for (size_t i = 0; i < slices.size(); ++i)
+                workers.emplace_back([&, i]()
+                                     {
+                                         try
+                                         {
+                                             results[i] = shredSlice(slices[i], schema);
+                                         }
+                                         catch (...)
+                                         {
+                                             failures[i] = std::current_exception();
+                                         } });
+        }
+        for (const std::exception_ptr &failure : failures)
+            if (failure)
+                std::rethrow_exception(failure);
+
+        std::vector<RecordBatch> batches;
+        batches.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (!results[i])
+            {
+                ParseError error = results[i].error();
+                error.offset += static_cast<size_t>(slices[i].data() - ndjson.data());
+                return located(error, ndjson);
+            }
+            batches.push_back(std::move(*results[i]));
+        }
+        return batches;
+    }
+}
@@ -0,0 +1,305 @@
+#include "json/CowValue.h"
+#include "Encoding.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <variant>
+
+namespace json
+{
+    struct CowValue::Node
+    {
+        std::variant<JsonValue, object_t, array_t> value;
+    };
+
+    CowValue::CowValue(const JsonValue &value)
+    {
+        std::visit(
+            [this](const auto &v)
+            {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, std::nullptr_t>)
+                    return;
+                else if constexpr (std::is_same_v<T, JsonValue::object_t>)
+                {
+                    object_t members;
+                    members.reserve(v.size());
+                    for (const auto &[key, member] : v)
+                        members.emplace(key, CowValue(member));
+                    node_ = std::make_shared<Node>(Node{std::move(members)});
+                }
+                else if constexpr (std::is_same_v<T, JsonValue::array_t>)
+                {
+                    array_t elements;
+                    elements.reserve(v.size());
+                    for (const JsonValue &element : v)
+                        elements.emplace_back(element);
+                    node_ = std::make_shared<Node>(Node{std::move(elements)});
+                }
+                else if constexpr (std::is_same_v<T, JsonValue::lazy_string_t>)
+                    node_ = std::make_shared<Node>(Node{JsonValue(std::string(v.view()))});
+                else
+                    node_ = std::make_shared<Node>(Node{JsonValue(v)});
+            },
+            value.get_value());
+    }
+
+    CowValue::Node &CowValue::unique()
+    {
+        if (!node_)
+            node_ = std::make_shared<Node>();
+        else if (node_.use_count() == 1)
+            // The last other owner may have just released it; see its writes.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        else
+            node_ = std::make_shared<Node>(*node_);
+        // Nodes are only ever created non-const.
+        return const_cast<Node &>(*node_);
+    }
+
+    bool CowValue::is_null() const
+    {
+        return !node_ || (std::holds_alternative<JsonValue>(node_->value) &&
+                          std::holds_alternative<std::nullptr_t>(std::get<JsonValue>(node_->value).get_value()));
+    }
+
+    bool CowValue::is_object() const { return node_ && std::holds_alternative<object_t>(node_->value); }
+    bool CowValue::is_array() const { return node_ && std::holds_alternative<array_t>(node_->value); }
+
+    const JsonValue &CowValue::value() const
+    {
+        static const JsonValue null;
+        return node_ ? std::get<JsonValue>(node_->value) : null;
+    }
+
+    const CowValue::object_t &CowValue::object() const
+    {
+        if (!node_)
+            throw std::bad_variant_access();
+        return std::get<object_t>(node_->value);
+    }
+
+    const CowValue::array_t &CowValue::array() const
+    {
+        if (!node_)
+            throw std::bad_variant_access();
+        return std::get<array_t>(node_->value);
+    }
+
+    size_t CowValue::size() const
+    {
+        if (is_object())
+            return std::get<object_t>(node_->value).size();
+        if (is_array())
+            return std::get<array_t>(node_->value).size();
+        return 0;
+    }
+
+    const CowValue *CowValue::find(const Key &key) const
+    {
+        if (!is_object())
+            return nullptr;
+        const object_t &members = std::get<object_t>(node_->value);
+        auto it = members.find(key);
+        return it == members.end() ? nullptr : &it->second;
+    }
+
+    const CowValue *CowValue::find(std::string_view key) const { return find(Key(key)); }
+
+    const CowValue &CowValue::at(size_t index) const { return array().at(index); }
+
+    CowValue &CowValue::member(const Key &key)
+    {
+        Node &node = unique();
+        if (!std::holds_alternative<object_t>(node.value))
+            node.value = object_t{};
+        object_t &members = std::get<object_t>(node.value);
+        auto it = members.find(key);
+        if (it == members.end())
+            it = members.try_emplace(std::string(key.view())).first;
+        return it->second;
+    }
+
+    CowValue &CowValue::element(size_t index)
+    {
+        if (!is_array())
+            throw std::bad_variant_access();
+        if (index >= size())
+            throw std::out_of_range("CowValue index " + std::to_string(index) + " out of range");
+        return std::get<array_t>(unique().value)[index];
+    }
+
+    CowValue::Ref CowValue::operator[](const Key &key)
+    {
+        member(key);
+        return Ref(*this, {std::string(key.view())});
+    }
+
+    CowValue::Ref CowValue::at(size_t index)
+    {
+        element(index);
+        return Ref(*this, {index});
+    }
+
+    void CowValue::push_back(CowValue value)
+    {
+        Node &node = unique();
+        if (!std::holds_alternative<array_t>(node.value))
+            node.value = array_t{};
+        std::get<array_t>(node.value).push_back(std::move(value));
+    }
+
+    size_t CowValue::erase(std::string_view key)
+    {
+        if (!find(key))
+            return 0;
+        object_t &members = std::get<object_t>(unique().value);
+        members.erase(members.find(Key(key)));
+        return 1;
+    }
+
+    void CowValue::update(std::string_view pointer, const std::function<void(CowValue &)> &edit)
+    {
+        CowValue *target = this;
+        for (const std::string &token : detail::parsePointer(pointer))
+        {
+            if (!target->is_array())
+            {
+                target = &target->member(Key(token));
+                continue;
+            }
+            array_t &elements = std::get<array_t>(target->unique().value);
+            if (token == "-")
+            {
+                target = &elements.emplace_back();
+                continue;
+            }
+            if (token.empty() || (token.size() > 1 && token[0] == '0') ||
+                !std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                throw std::runtime_error("Invalid array index: " + token);
+            size_t index = std::stoull(token);
+            if (index >= elements.size())
+                throw std::out_of_range("CowValue index " + token + " out of range");
+            target = &elements[index];
+        }
+        edit(*target);
+    }
+
+    void CowValue::set(std::string_view pointer, CowValue value)
+    {
+        update(pointer, [&](CowValue &target) { target = std::move(value); });
+    }
+
+    CowValue &CowValue::Ref::resolve() const
+    {
+        CowValue *target = root_;
+        for (const Step &step : path_)
+        {
+            if (const std::string *key = std::get_if<std::string>(&step))
+                target = &target->member(Key(*key));
+            else
+                target = &target->element(std::get<size_t>(step));
+        }
+        return *target;
+    }
+
+    CowValue::Ref CowValue::Ref::operator[](const Key &key) const
+    {
+        resolve().member(key);
+        std::vector<Step> path = path_;
+        path.emplace_back(std::string(key.view()));
+        return Ref(*root_, std::move(path));
+    }
+
+    CowValue::Ref CowValue::Ref::at(size_t index) const
+    {
+        resolve().element(index);
+        std::vector<Step> path = path_;
+        path.emplace_back(index);
+        return Ref(*root_, std::move(path));
+    }
+
+    void CowValue::Ref::push_back(CowValue value) const { resolve().push_back(std::move(value)); }
+
+    size_t CowValue::Ref::erase(std::string_view key) const
+    {
+        // Nothing is unshared when there is nothing to erase.
+        const CowValue &current = *this;
+        return current.find(key) ? resolve().erase(key) : 0;
+    }
+
+    const CowValue::Ref &CowValue::Ref::operator=(CowValue value) const
+    {
+        resolve() = std::move(value);
+        return *this;
+    }
+
+    CowValue::Ref &CowValue::Ref::operator=(const Ref &other)
+    {
+        *this = static_cast<const CowValue &>(other);
+        return *this;
+    }
+
+    CowValue::Ref::operator const CowValue &() const
+    {
+        // A path erased since the Ref was taken reads as null.
+        static const CowValue null;
+        const CowValue *target = root_;
+        for (const Step &step : path_)
+        {
+            if (const std::string *key = std::get_if<std::string>(&step))
+                target = target->find(std::string_view(*key));
+            else if (target->is_array() && std::get<size_t>(step) < target->size())
+                target = &target->array()[std::get<size_t>(step)];
+            else
+                target = nullptr;
+            if (!target)
+                return null;
+        }
+        return *target;
+    }
+
+    JsonValue CowValue::toJsonValue() const
+    {
+        if (is_object())
+        {
+            JsonObject members;
+            for (const auto &[key, member] : std::get<object_t>(node_->value))
+                members[key] = member.toJsonValue();
+            return members;
+        }
+        if (is_array())
+        {
+            JsonValue::array_t elements;
+            elements.reserve(size());
+            for (const CowValue &element : std::get<array_t>(node_->value))
+                elements.push_back(element.toJsonValue());
+            return elements;
+        }
+        return value();
+    }
+
+    bool operator==(const CowValue &lhs, const CowValue &rhs)
+    {
+        if (lhs.shares(rhs))
+            return true;
+        if (lhs.is_object() != rhs.is_object() || lhs.is_array() != rhs.is_array())
+            return false;
+        if (lhs.is_object())
+        {
+            if (lhs.size() != rhs.size())
+                return false;
+            for (const auto &[key, member] : lhs.object())
+            {
+                const CowValue *other = rhs.find(std::string_view(key));
+                if (!other || !(member == *other))
+                    return false;
+            }
+            return true;
+        }
+        if (lhs.is_array())
+            return lhs.array() == rhs.array();
+        return lhs.value() == rhs.value();
+    }
+}
@@ -0,0 +1,100 @@
+#include "json/DecodeCache.h"
+#include "json/Hash.h"
+#include "json/Memory.h"
+
+namespace json
+{
+    namespace
+    {
+        constexpr size_t entryOverhead = sizeof(void *) * 8;
+    }
+
+    DecodeCache::DecodeCache(const DecodeCacheOptions &options)
+        : options_(options), shards_(options.shards == 0 ? 1 : options.shards)
+    {
+        shardCapacity_ = options_.maxBytes / shards_.size();
+    }
+
+    std::expected<DecodeCache::Document, ParseError> DecodeCache::decode(std::string_view input)
+    {
+        uint64_t hash = hashBytes(input);
+        Shard &shard = shardFor(hash);
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(hash);
+            if (it != shard.index.end() && it->second->input == input)
+            {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second->document;
+            }
+        }
+
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        auto result = jsonTryDecode(input, options_.limits);
+        if (!result)
+            return std::unexpected(result.error());
+
+        auto document = std::make_shared<const JsonValue>(std::move(*result));
+        size_t charge = input.size() + sizeof(JsonValue) + memory_usage(*document).total() + entryOverhead;
+        if (charge <= shardCapacity_)
+            insert(shard, Entry{hash, std::string(input), document, charge});
+        return document;
+    }
+
+    void DecodeCache::insert(Shard &shard, Entry entry)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // Another thread may have decoded the same input meanwhile, or a
+        // different input may collide on the hash; either way the newest wins.
+        auto existing = shard.index.find(entry.hash);
+        if (existing != shard.index.end())
+        {
+            shard.bytes -= existing->second->charge;
+            shard.lru.erase(existing->second);
+            shard.index.erase(existing);
+        }
+
+        while (!shard.lru.empty() && shard.bytes + entry.charge > shardCapacity_)
+        {
+            Entry &victim = shard.lru.back();
+            shard.bytes -= victim.charge;
+            shard.index.erase(victim.hash);
+            shard.lru.pop_back();
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shard.bytes += entry.charge;
+        shard.lru.push_front(std::move(entry));
+        shard.index[shard.lru.front().hash] = shard.lru.begin();
+    }
+
+    DecodeCacheStats DecodeCache::stats() const
+    {
+        DecodeCacheStats stats;
+        for (const Shard &shard : shards_)
+        {
+            stats.hits += shard.hits.load(std::memory_order_relaxed);
+            stats.misses += shard.misses.load(std::memory_order_relaxed);
+            stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.entries += shard.lru.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+    void DecodeCache::clear()
+    {
+        for (Shard &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.lru.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "json/DocumentStream.h"
+
+namespace json
+{
+    DocumentStream::DocumentStream(std::string_view input, const ParseLimits &limits)
+        : input_(input), limits_(limits), lexer_(input), parser_({}, limits) {}
+
+    // Appends up to batchSize tokens to the parser's buffer. Returns false
+    // once the input has nothing left to lex.
+    bool DocumentStream::refill()
+    {
+        if (exhausted_)
+            return false;
+
+        std::vector<Token> &tokens = parser_.tokens();
+        size_t added = 0;
+        while (added < batchSize)
+        {
+            if (!lexer_.next(tokens))
+            {
+                exhausted_ = true;
+                break;
+            }
+            ++added;
+            // Nothing after an invalid token can be parsed.
+            if (tokens.back().type == TokenType::Invalid)
+            {
+                exhausted_ = true;
+                break;
+            }
+        }
+        return added > 0;
+    }
+
+    bool DocumentStream::fail(const ParseError &error)
+    {
+        failed_ = true;
+        error_ = error;
+        error_.locate(input_);
+        return false;
+    }
+
+    size_t DocumentStream::tokenEnd(const Token &token) const
+    {
+        switch (token.type)
+        {
+        case TokenType::String:
+            // Token::value is decoded; find the closing quote in the source.
+            return Lexer::scanString(input_, token.position);
+        case TokenType::Number:
+        case TokenType::True:
+        case TokenType::False:
+        case TokenType::Null:
+            return token.position + token.value.size();
+        default:
+            return token.position + 1;
+        }
+    }
+
+    bool DocumentStream::next(Document &out)
+    {
+        if (failed_)
+            return false;
+
+        // Tokens left over from the previous batch start this document.
+        parser_.discardConsumed();
+        if (parser_.tokens().empty() && !refill())
+            return false;
+
+        out.begin = parser_.tokens().front().position;
+        parser_.begin(out.value);
+        while (true)
+        {
+            Parser::Progress progress = parser_.resume(exhausted_);
+            if (progress == Parser::Progress::Complete)
+                break;
+            if (progress == Parser::Progress::Failed)
+            {
+                ParseError error = parser_.error();
+                if (error.code == ParseErrorCode::UnexpectedEndOfInput)
+                    error.offset = input_.size();
+                return fail(error);
+            }
+            // Stop before parsing a batch that starts past the size limit,
+            // so an oversized document costs at most one batch beyond it.
+            refill();
+            if (parser_.tokens().back().position - out.begin > limits_.maxDocumentSize)
+                return fail(ParseError{ParseErrorCode::DocumentTooLarge, out.begin});
+        }
+
+        out.end = tokenEnd(parser_.tokens()[parser_.position() - 1]);
+        if (out.end - out.begin > limits_.maxDocumentSize)
+            return fail(ParseError{ParseErrorCode::DocumentTooLarge, out.begin});
+
+        ++count_;
+        return true;
+    }
+}
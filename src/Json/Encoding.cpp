@@ -0,0 +1,202 @@
+#include "Encoding.h"
+#include "parser/Kernels.h"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace json::detail
+{
+    void appendEscaped(std::string &out, std::string_view str)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        const Kernels &k = kernels::active();
+        out.push_back('"');
+        size_t run = 0;
+        for (size_t i = k.findStringSpecial(str.data(), str.size(), 0); i < str.size();
+             i = k.findStringSpecial(str.data(), str.size(), i + 1))
+        {
+            unsigned char c = static_cast<unsigned char>(str[i]);
+            out.append(str.data() + run, i - run);
+            run = i + 1;
+            switch (c)
+            {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\b':
+                out.append("\\b");
+                break;
+            case '\f':
+                out.append("\\f");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                out.append("\\u00");
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0xF]);
+                break;
+            }
+        }
+        out.append(str.data() + run, str.size() - run);
+        out.push_back('"');
+    }
+
+    void appendShortestNumber(std::string &out, double value)
+    {
+        if (!std::isfinite(value))
+            throw std::runtime_error("NaN and Infinity cannot be encoded as JSON");
+        if (value == 0)
+        {
+            out.push_back('0');
+            return;
+        }
+
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific);
+        (void)ec;
+
+        // buf holds "[-]d[.ddd]e±xx"; split it into sign, digits and exponent.
+        const char *p = buf;
+        if (*p == '-')
+        {
+            out.push_back('-');
+            ++p;
+        }
+        char digits[20];
+        int k = 0;
+        for (; *p != 'e'; ++p)
+            if (*p != '.')
+                digits[k++] = *p;
+        int exp = 0;
+        std::from_chars(p + 1 + (p[1] == '+'), end, exp);
+        int n = exp + 1;
+
+        if (k <= n && n <= 21)
+        {
+            out.append(digits, k);
+            out.append(n - k, '0');
+        }
+        else if (0 < n && n <= 21)
+        {
+            out.append(digits, n);
+            out.push_back('.');
+            out.append(digits + n, k - n);
+        }
+        else if (-6 < n && n <= 0)
+        {
+            out.append("0.");
+            out.append(-n, '0');
+            out.append(digits, k);
+        }
+        else
+        {
+            out.push_back(digits[0]);
+            if (k > 1)
+            {
+                out.push_back('.');
+                out.append(digits + 1, k - 1);
+            }
+            out.push_back('e');
+            out.push_back(n - 1 < 0 ? '-' : '+');
+            char expBuf[8];
+            auto [expEnd, expEc] = std::to_chars(expBuf, expBuf + sizeof(expBuf), std::abs(n - 1));
+            (void)expEc;
+            out.append(expBuf, expEnd);
+        }
+    }
+
+    void appendInteger(std::string &out, int64_t value)
+    {
+        char buf[24];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        (void)ec;
+        out.append(buf, end);
+    }
+
+    namespace
+    {
+        uint32_t decodeAt(std::string_view s, size_t pos)
+        {
+            unsigned char c = static_cast<unsigned char>(s[pos]);
+            int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+            uint32_t cp = extra == 0 ? c : c & (0x3F >> extra);
+            for (int i = 1; i <= extra && pos + i < s.size(); ++i)
+                cp = (cp << 6) | (static_cast<unsigned char>(s[pos + i]) & 0x3F);
+            return cp;
+        }
+
+        uint32_t firstUtf16Unit(uint32_t cp)
+        {
+            return cp >= 0x10000 ? 0xD800 + ((cp - 0x10000) >> 10) : cp;
+        }
+    }
+
+    bool utf16Less(std::string_view a, std::string_view b)
+    {
+        size_t n = a.size() < b.size() ? a.size() : b.size();
+        size_t i = 0;
+        while (i < n && a[i] == b[i])
+            ++i;
+        if (i == n)
+            return a.size() < b.size();
+
+        // Back up to the start of the code point that differs; byte order and
+        // UTF-16 order only disagree for supplementary vs U+E000..U+FFFF.
+        while (i > 0 && (static_cast<unsigned char>(a[i]) & 0xC0) == 0x80)
+            --i;
+        uint32_t ca = decodeAt(a, i);
+        uint32_t cb = decodeAt(b, i);
+        if ((ca >= 0x10000) == (cb >= 0x10000))
+            return ca < cb;
+        return firstUtf16Unit(ca) < firstUtf16Unit(cb);
+    }
+
+    std::vector<std::string> parsePointer(std::string_view pointer)
+    {
+        std::vector<std::string> path;
+        if (pointer.empty())
+            return path;
+        if (pointer.front() != '/')
+            throw std::runtime_error("JSON pointer must start with '/': " + std::string(pointer));
+
+        size_t pos = 1;
+        while (true)
+        {
+            size_t end = pointer.find('/', pos);
+            std::string_view raw = pointer.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+
+            std::string token;
+            token.reserve(raw.size());
+            for (size_t i = 0; i < raw.size(); ++i)
+            {
+                if (raw[i] != '~')
+                {
+                    token.push_back(raw[i]);
+                    continue;
+                }
+                if (i + 1 < raw.size() && (raw[i + 1] == '0' || raw[i + 1] == '1'))
+                    token.push_back(raw[++i] == '0' ? '~' : '/');
+                else
+                    throw std::runtime_error("Invalid escape in JSON pointer: " + std::string(pointer));
+            }
+            path.push_back(std::move(token));
+
+            if (end == std::string_view::npos)
+                return path;
+            pos = end + 1;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json::detail
+{
+    // Appends `str` as a quoted JSON string, escaping quotes, backslashes and
+    // control characters; other bytes (including UTF-8) pass through.
+    void appendEscaped(std::string &out, std::string_view str);
+
+    // Shortest round-trip spelling of `value` in ECMAScript Number.toString
+    // form (RFC 8785 section 3.2.2.3). Throws for NaN and infinities.
+    void appendShortestNumber(std::string &out, double value);
+
+    void appendInteger(std::string &out, int64_t value);
+
+    // Orders UTF-8 strings by their UTF-16 code units, as RFC 8785 requires
+    // for object keys.
+    bool utf16Less(std::string_view a, std::string_view b);
+
+    // Splits an RFC 6901 JSON pointer into unescaped reference tokens.
+    // Throws std::runtime_error for malformed pointers.
+    std::vector<std::string> parsePointer(std::string_view pointer);
+}
+
+#endif // ENCODING_H
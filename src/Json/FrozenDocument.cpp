@@ -0,0 +1,36 @@
+#include "json/FrozenDocument.h"
+
+namespace json
+{
+    namespace
+    {
+        // Replaces lazy strings with owned ones, the only state a const
+        // JsonValue can still mutate.
+        void materialise(JsonValue &value)
+        {
+            auto &v = value.get_value();
+            if (auto *lazy = std::get_if<JsonValue::lazy_string_t>(&v))
+                v = JsonValue::string_t(lazy->view());
+            else if (auto *object = std::get_if<JsonValue::object_t>(&v))
+                for (auto &member : *object)
+                    materialise(member.second);
+            else if (auto *array = std::get_if<JsonValue::array_t>(&v))
+                for (JsonValue &element : *array)
+                    materialise(element);
+        }
+    }
+
+    FrozenDocument::FrozenDocument(JsonValue value)
+    {
+        materialise(value);
+        root_ = std::make_shared<const JsonValue>(std::move(value));
+    }
+
+    std::expected<FrozenDocument, ParseError> FrozenDocument::decode(std::string_view text, const ParseLimits &limits)
+    {
+        auto result = jsonTryDecodeValue(text, limits);
+        if (!result)
+            return std::unexpected(result.error());
+        return FrozenDocument(std::move(*result));
+    }
+}
@@ -0,0 +1,84 @@
+#include "json/Hash.h"
+
+#include <cstring>
+
+namespace json
+{
+    namespace
+    {
+        enum Tag : uint64_t
+        {
+            NullTag = 0x6e756c6c,
+            BooleanTag,
+            NumberTag,
+            StringTag,
+            ArrayTag,
+            ObjectTag
+        };
+
+        uint64_t hashNumber(double value)
+        {
+            if (value == 0)
+                value = 0; // fold -0.0 into 0.0
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return hashCombine(NumberTag, bits);
+        }
+
+        template <typename Recurse>
+        uint64_t hashNode(const JsonValue &value, Recurse &&recurse)
+        {
+            const auto &v = value.get_value();
+
+            if (std::holds_alternative<std::nullptr_t>(v))
+                return hashCombine(NullTag, 0);
+            if (std::holds_alternative<JsonValue::boolean_t>(v))
+                return hashCombine(BooleanTag, std::get<JsonValue::boolean_t>(v));
+            if (std::holds_alternative<JsonValue::number_float_t>(v))
+                return hashNumber(std::get<JsonValue::number_float_t>(v));
+            // Integers are compared and canonicalised as doubles, so they
+            // must hash as doubles too, even beyond 2^53.
+            if (std::holds_alternative<JsonValue::number_integer_t>(v))
+                return hashNumber(static_cast<double>(std::get<JsonValue::number_integer_t>(v)));
+            if (value.is_string())
+                return hashBytes(value.get_string(), StringTag);
+
+            if (std::holds_alternative<JsonValue::array_t>(v))
+            {
+                const auto &arr = std::get<JsonValue::array_t>(v);
+                uint64_t h = hashCombine(ArrayTag, arr.size());
+                for (const auto &element : arr)
+                    h = hashCombine(h, recurse(element));
+                return h;
+            }
+
+            const auto &obj = std::get<JsonObject>(v);
+            uint64_t sum = 0;
+            uint64_t count = 0;
+            for (const auto &pair : obj)
+            {
+                sum += hashCombine(hashBytes(pair.first, StringTag), recurse(pair.second));
+                ++count;
+            }
+            return hashCombine(hashCombine(ObjectTag, count), sum);
+        }
+    }
+
+    uint64_t structuralHash(const JsonValue &value)
+    {
+        return hashNode(value, [](const JsonValue &child)
+                        { return structuralHash(child); });
+    }
+
+    uint64_t HashCache::hash(const JsonValue &value)
+    {
+        auto it = cache_.find(&value);
+        if (it != cache_.end())
+            return it->second;
+
+        uint64_t h = hashNode(value, [this](const JsonValue &child)
+                              { return hash(child); });
+        cache_.emplace(&value, h);
+        return h;
+    }
+}
@@ -1,5 +1,6 @@
 #include "json/Json.h"
 #include "parser/Parser.h"
+#include "parser/ParserContext.h"
 #include "parser/Lexer.h"
 
 #include <sstream>
@@ -39,9 +40,9 @@ namespace json
         {
             return "null";
         }
-        else if (std::holds_alternative<std::string>(v))
+        else if (value.is_string())
         {
-            return "\"" + std::get<std::string>(v) + "\"";
+            return "\"" + std::string(value.get_string()) + "\"";
         }
         else if (std::holds_alternative<double>(v))
         {
@@ -73,11 +74,139 @@ namespace json
         throw std::runtime_error("Unsupported JsonValue type");
     }
 
-    JsonObject jsonDecode(std::string_view jsonStr)
+    bool operator==(const JsonObject &lhs, const JsonObject &rhs)
     {
-        Lexer lexer(jsonStr);
-        Parser parser(lexer.tokenise());
-        return parser.parse();
+        if (lhs.size() != rhs.size())
+            return false;
+        for (const auto &pair : lhs)
+        {
+            auto it = rhs.find(pair.first);
+            if (it == rhs.end() || !(it->second == pair.second))
+                return false;
+        }
+        return true;
+    }
+
+    bool operator==(const JsonValue &lhs, const JsonValue &rhs)
+    {
+        const auto &a = lhs.get_value();
+        const auto &b = rhs.get_value();
+
+        bool aNumber = lhs.is_number_integer() || lhs.is_number_float();
+        bool bNumber = rhs.is_number_integer() || rhs.is_number_float();
+        if (aNumber && bNumber && a.index() != b.index())
+        {
+            auto toDouble = [](const JsonValue::value_t &v)
+            {
+                return std::holds_alternative<JsonValue::number_float_t>(v)
+                           ? std::get<JsonValue::number_float_t>(v)
+                           : static_cast<double>(std::get<JsonValue::number_integer_t>(v));
+            };
+            return toDouble(a) == toDouble(b);
+        }
+
+        if (lhs.is_string() && rhs.is_string())
+            return lhs.get_string() == rhs.get_string();
+
+        if (a.index() != b.index())
+            return false;
+
+        return std::visit(
+            [&b](const auto &value)
+            {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, JsonValue::array_t>)
+                {
+                    const auto &other = std::get<JsonValue::array_t>(b);
+                    if (value.size() != other.size())
+                        return false;
+                    for (size_t i = 0; i < value.size(); ++i)
+                        if (!(value[i] == other[i]))
+                            return false;
+                    return true;
+                }
+                else if constexpr (std::is_same_v<T, JsonValue::lazy_string_t>)
+                {
+                    return false; // handled above
+                }
+                else
+                {
+                    return value == std::get<T>(b);
+                }
+            },
+            a);
+    }
+
+    JsonObject jsonDecode(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        auto result = jsonTryDecode(jsonStr, limits);
+        if (!result)
+            throw ParseException(result.error());
+        return std::get<JsonObject>(std::move(result->get_value()));
+    }
+
+    std::expected<JsonValue, ParseError> jsonTryDecode(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        return ParserContext::local().decode(jsonStr, limits);
+    }
+
+    JsonValue jsonDecodeValue(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        auto result = jsonTryDecodeValue(jsonStr, limits);
+        if (!result)
+            throw ParseException(result.error());
+        return std::move(*result);
+    }
+
+    std::expected<JsonValue, ParseError> jsonTryDecodeValue(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        return ParserContext::local().decodeValue(jsonStr, limits);
+    }
+
+    JsonObject jsonDecode(std::string_view jsonStr, const Projection &projection, const ParseLimits &limits)
+    {
+        auto result = jsonTryDecode(jsonStr, projection, limits);
+        if (!result)
+            throw ParseException(result.error());
+        return std::get<JsonObject>(std::move(result->get_value()));
+    }
+
+    std::expected<JsonValue, ParseError> jsonTryDecode(std::string_view jsonStr, const Projection &projection,
+                                                       const ParseLimits &limits)
+    {
+        return ParserContext::local().decode(jsonStr, projection, limits);
+    }
+
+    template <unsigned Flags>
+    JsonObject jsonDecodeWith(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        auto result = jsonTryDecodeWith<Flags>(jsonStr, limits);
+        if (!result)
+            throw ParseException(result.error());
+        return std::get<JsonObject>(std::move(result->get_value()));
+    }
+
+    template <unsigned Flags>
+    std::expected<JsonValue, ParseError> jsonTryDecodeWith(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        return ParserContext::local().decodeWith<Flags>(jsonStr, limits);
+    }
+
+#define JSON_INSTANTIATE_DECODE_WITH(F)                                                        \
+    template JsonObject jsonDecodeWith<F>(std::string_view, const ParseLimits &);              \
+    template std::expected<JsonValue, ParseError> jsonTryDecodeWith<F>(std::string_view, const ParseLimits &);
+    JSON_FOR_EACH_PARSE_FLAGS(JSON_INSTANTIATE_DECODE_WITH)
+#undef JSON_INSTANTIATE_DECODE_WITH
+
+    std::expected<JsonValue, ParseError> jsonTryDecodeLazy(std::string_view jsonStr, const ParseLimits &limits)
+    {
+        return ParserContext::local().decode(jsonStr, limits, StringStorage::Lazy);
+    }
+
+    void LazyString::decode() const
+    {
+        value_ = Lexer::unescape(raw_);
+        decoded_ = true;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "json/LargePages.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace json
+{
+    namespace
+    {
+        // Every mapping is at least this aligned; LargePageResource sends
+        // stricter requests upstream.
+        constexpr size_t mappingAlignment = 4096;
+
+#ifdef __linux__
+        // From <numaif.h>, which needs libnuma's headers.
+        constexpr int mpolPreferred = 1;
+
+        std::string readSysFile(const char *path)
+        {
+            std::ifstream file(path);
+            std::string text;
+            std::getline(file, text, '\0');
+            return text;
+        }
+
+        size_t detectHugePageSize()
+        {
+            std::string meminfo = readSysFile("/proc/meminfo");
+            size_t at = meminfo.find("Hugepagesize:");
+            if (at == std::string::npos)
+                return 0;
+            return std::strtoull(meminfo.c_str() + at + std::strlen("Hugepagesize:"), nullptr, 10) * 1024;
+        }
+
+        int currentNode()
+        {
+            unsigned cpu = 0, node = 0;
+            if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+                return -1;
+            return static_cast<int>(node);
+        }
+
+        size_t roundUp(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+        // Anonymous mapping of at least `bytes`, aligned to `alignment` (a
+        // multiple of the page size) by trimming an over-sized mapping.
+        void *mapAligned(size_t bytes, size_t alignment)
+        {
+            size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t slack = alignment > page ? alignment : 0;
+            void *p = ::mmap(nullptr, bytes + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+                return nullptr;
+            if (!slack)
+                return p;
+
+            auto begin = reinterpret_cast<uintptr_t>(p);
+            uintptr_t aligned = (begin + alignment - 1) / alignment * alignment;
+            if (aligned > begin)
+                ::munmap(p, aligned - begin);
+            size_t tail = begin + bytes + slack - (aligned + bytes);
+            if (tail)
+                ::munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+            return reinterpret_cast<void *>(aligned);
+        }
+
+        void *mapPages(size_t bytes, const LargePageOptions &options, size_t &mapped, LargePagePlacement &placement)
+        {
+            const LargePageSupport &support = largePageSupport();
+            size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            void *p = nullptr;
+
+            if (options.hugePages && support.hugetlb)
+            {
+                mapped = roundUp(bytes, support.hugePageSize);
+                p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p == MAP_FAILED)
+                    p = nullptr;
+                else
+                    placement.hugetlb = true;
+            }
+
+            if (!p)
+            {
+                bool transparent = options.hugePages && support.transparent && support.hugePageSize;
+                mapped = roundUp(bytes, transparent ? support.hugePageSize : page);
+                p = mapAligned(mapped, transparent ? support.hugePageSize : page);
+                if (!p)
+                    return nullptr;
+                placement.transparent = transparent && ::madvise(p, mapped, MADV_HUGEPAGE) == 0;
+            }
+
+            // Pages are not touched yet, so the policy decides where every
+            // one of them is placed.
+            int node = options.localNode && support.numa ? currentNode() : -1;
+            if (node >= 0 && node < 1024)
+            {
+                unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {};
+                mask[node / (8 * sizeof(unsigned long))] = 1ul << (node % (8 * sizeof(unsigned long)));
+                if (::syscall(SYS_mbind, p, mapped, mpolPreferred, mask, 1024, 0) == 0)
+                    placement.node = node;
+            }
+            return p;
+        }
+
+        void unmapPages(void *p, size_t mapped) { ::munmap(p, mapped); }
+#else
+        void *mapPages(size_t bytes, const LargePageOptions &, size_t &mapped, LargePagePlacement &)
+        {
+            mapped = bytes;
+            return ::operator new(bytes, std::align_val_t(mappingAlignment), std::nothrow);
+        }
+
+        void unmapPages(void *p, size_t) { ::operator delete(p, std::align_val_t(mappingAlignment)); }
+#endif
+
+        LargePageSupport detectSupport()
+        {
+            LargePageSupport support;
+#ifdef __linux__
+            support.hugePageSize = detectHugePageSize();
+            support.hugetlb = support.hugePageSize && std::strtol(readSysFile("/proc/sys/vm/nr_hugepages").c_str(), nullptr, 10) > 0;
+
+            std::string thp = readSysFile("/sys/kernel/mm/transparent_hugepage/enabled");
+            support.transparent = thp.find("[always]") != std::string::npos || thp.find("[madvise]") != std::string::npos;
+
+            int mode = 0;
+            bool node1 = static_cast<bool>(std::ifstream("/sys/devices/system/node/node1/meminfo"));
+            support.numa = node1 && ::syscall(SYS_get_mempolicy, &mode, nullptr, 0, nullptr, 0) == 0;
+#endif
+            return support;
+        }
+    }
+
+    const LargePageSupport &largePageSupport()
+    {
+        static const LargePageSupport support = detectSupport();
+        return support;
+    }
+
+    LargeBuffer::LargeBuffer(size_t size, const LargePageOptions &options) : size_(size)
+    {
+        if (size == 0)
+            return;
+        data_ = static_cast<char *>(mapPages(size, options, mapped_, placement_));
+        if (!data_)
+            throw std::bad_alloc();
+    }
+
+    LargeBuffer::~LargeBuffer()
+    {
+        if (data_)
+            unmapPages(data_, mapped_);
+    }
+
+    LargeBuffer::LargeBuffer(LargeBuffer &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          mapped_(std::exchange(other.mapped_, 0)), placement_(other.placement_) {}
+
+    LargeBuffer &LargeBuffer::operator=(LargeBuffer &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (data_)
+                unmapPages(data_, mapped_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_ = std::exchange(other.mapped_, 0);
+            placement_ = other.placement_;
+        }
+        return *this;
+    }
+
+    LargeBuffer LargeBuffer::readFile(const std::string &path, const LargePageOptions &options)
+    {
+        // ftell's long is 32 bits on LLP64 and 32-bit targets.
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec || size > std::numeric_limits<size_t>::max())
+            throw std::runtime_error("Failed to stat file: " + path);
+
+        LargeBuffer buffer(static_cast<size_t>(size), options);
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            throw std::runtime_error("Failed to open file: " + path);
+        size_t read = buffer.size_ ? std::fread(buffer.data_, 1, buffer.size_, file) : 0;
+        std::fclose(file);
+        if (read != buffer.size_)
+            throw std::runtime_error("Failed to read file: " + path);
+        return buffer;
+    }
+
+    LargePageResource::LargePageResource(const LargePageOptions &options, std::pmr::memory_resource *upstream)
+        : options_(options), upstream_(upstream) {}
+
+    LargePageResource::~LargePageResource()
+    {
+        for (auto &[p, mapped] : mapped_)
+            unmapPages(p, mapped);
+    }
+
+    size_t LargePageResource::mappings() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mapped_.size();
+    }
+
+    void *LargePageResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        if (bytes < options_.minBytes || alignment > mappingAlignment)
+            return upstream_->allocate(bytes, alignment);
+
+        size_t mapped = 0;
+        LargePagePlacement placement;
+        void *p = mapPages(bytes, options_, mapped, placement);
+        if (!p)
+            return upstream_->allocate(bytes, alignment);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            mapped_.emplace(p, mapped);
+        }
+        catch (...)
+        {
+            unmapPages(p, mapped);
+            throw;
+        }
+        return p;
+    }
+
+    void LargePageResource::do_deallocate(void *p, size_t bytes, size_t alignment)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = mapped_.find(p);
+            if (it != mapped_.end())
+            {
+                size_t mapped = it->second;
+                mapped_.erase(it);
+                unmapPages(p, mapped);
+                return;
+            }
+        }
+        upstream_->deallocate(p, bytes, alignment);
+    }
+}
@@ -0,0 +1,200 @@
+#include "json/Memory.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace json
+{
+    namespace
+    {
+        const size_t inlineStringCapacity = std::string().capacity();
+
+        size_t stringBytes(size_t length) { return length > inlineStringCapacity ? length + 1 : 0; }
+
+        size_t stringBytes(const std::string &s)
+        {
+            // Inline (SSO) buffers live inside the string object.
+            const char *data = s.data();
+            const char *self = reinterpret_cast<const char *>(&s);
+            if (data >= self && data < self + sizeof(s))
+                return 0;
+            return s.capacity() + 1;
+        }
+
+        // One allocation per member. Approximates the node of a node-based
+        // hash map (std::unordered_map in every mainstream library): a next
+        // pointer, the key/value pair and a cached hash, rounded up to the
+        // pair's alignment. Implementations that do not cache the hash use
+        // one word less.
+        constexpr size_t hashNodeBytes()
+        {
+            using value_type = JsonObject::map_t::value_type;
+            constexpr size_t unaligned = sizeof(void *) + sizeof(value_type) + sizeof(size_t);
+            return (unaligned + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+
+        size_t bucketBytes(size_t buckets)
+        {
+            // libstdc++ keeps a single bucket inside the map object.
+            return buckets > 1 ? buckets * sizeof(void *) : 0;
+        }
+
+        // Bucket count after inserting n members one at a time, following
+        // libstdc++'s prime policy (13, 29, 59, 127, ...) approximately.
+        size_t expectedBuckets(size_t members)
+        {
+            if (members == 0)
+                return 1;
+            size_t buckets = 13;
+            while (buckets < members)
+                buckets = buckets * 2 + 3;
+            return buckets;
+        }
+
+        // Capacity after n emplace_backs from empty.
+        size_t expectedCapacity(size_t elements) { return elements ? std::bit_ceil(elements) : 0; }
+
+        void account(const JsonValue &value, MemoryUsage &usage)
+        {
+            const auto &v = value.get_value();
+            if (auto *s = std::get_if<JsonValue::string_t>(&v))
+                usage.strings += stringBytes(*s);
+            else if (auto *lazy = std::get_if<JsonValue::lazy_string_t>(&v))
+            {
+                if (const std::string *decoded = lazy->decoded())
+                    usage.strings += stringBytes(*decoded);
+            }
+            else if (auto *array = std::get_if<JsonValue::array_t>(&v))
+            {
+                usage.arrays += array->capacity() * sizeof(JsonValue);
+                for (const JsonValue &element : *array)
+                    account(element, usage);
+            }
+            else if (auto *object = std::get_if<JsonObject>(&v))
+            {
+                usage.objects += object->size() * hashNodeBytes() + bucketBytes(object->bucket_count());
+                for (const auto &[key, member] : *object)
+                {
+                    usage.keys += stringBytes(key);
+                    account(member, usage);
+                }
+            }
+        }
+
+        struct ScanFrame
+        {
+            bool object;
+            bool expectKey;
+            bool nonEmpty;
+            size_t count; // members, or commas for arrays
+        };
+    }
+
+    MemoryUsage memory_usage(const JsonValue &value)
+    {
+        MemoryUsage usage;
+        account(value, usage);
+        return usage;
+    }
+
+    MemoryEstimate estimate_memory_usage(std::string_view input, size_t maxDepth)
+    {
+        MemoryEstimate estimate;
+        std::vector<ScanFrame> stack;
+        stack.reserve(std::min<size_t>(maxDepth, 64));
+
+        auto markValue = [&]()
+        {
+            if (!stack.empty())
+                stack.back().nonEmpty = true;
+        };
+        auto close = [&]()
+        {
+            ScanFrame frame = stack.back();
+            stack.pop_back();
+            if (frame.object)
+            {
+                ++estimate.objects;
+                estimate.members += frame.count;
+                estimate.bytes += frame.count * hashNodeBytes() + bucketBytes(expectedBuckets(frame.count));
+            }
+            else
+            {
+                size_t elements = frame.nonEmpty ? frame.count + 1 : 0;
+                ++estimate.arrays;
+                estimate.elements += elements;
+                estimate.bytes += expectedCapacity(elements) * sizeof(JsonValue);
+            }
+        };
+        // Containers left open are counted as if closed where the scan stopped.
+        auto stop = [&](ParseErrorCode error)
+        {
+            estimate.error = error;
+            while (!stack.empty())
+                close();
+            return estimate;
+        };
+
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            char c = input[i];
+            switch (c)
+            {
+            case '"':
+            {
+                size_t start = ++i;
+                while (i < input.size() && input[i] != '"')
+                    i += input[i] == '\\' ? 2 : 1;
+                size_t length = std::min(i, input.size()) - start;
+                if (!stack.empty() && stack.back().object && stack.back().expectKey)
+                {
+                    stack.back().expectKey = false;
+                    estimate.bytes += stringBytes(length);
+                }
+                else
+                {
+                    markValue();
+                    ++estimate.strings;
+                    estimate.bytes += stringBytes(length);
+                }
+                break;
+            }
+            case '{':
+            case '[':
+                if (stack.size() >= maxDepth)
+                    return stop(ParseErrorCode::DepthLimitExceeded);
+                markValue();
+                stack.push_back({c == '{', c == '{', false, 0});
+                break;
+            case ':':
+                if (!stack.empty() && stack.back().object)
+                    ++stack.back().count;
+                break;
+            case ',':
+                if (!stack.empty())
+                {
+                    if (stack.back().object)
+                        stack.back().expectKey = true;
+                    else
+                        ++stack.back().count;
+                }
+                break;
+            case '}':
+            case ']':
+                if (!stack.empty())
+                    close();
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                break;
+            default:
+                markValue();
+                break;
+            }
+        }
+        return stack.empty() ? estimate : stop(ParseErrorCode::UnexpectedEndOfInput);
+    }
+}
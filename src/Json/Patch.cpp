@@ -0,0 +1,433 @@
+#include "json/Patch.h"
+#include "Encoding.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace json
+{
+    namespace
+    {
+        using Path = std::vector<std::string>;
+        using detail::parsePointer;
+
+        size_t parseIndex(const std::string &token, size_t limit)
+        {
+            if (token.empty() || (token.size() > 1 && token[0] == '0') ||
+                !std::all_of(token.begin(), token.end(), [](char c)
+                             { return c >= '0' && c <= '9'; }))
+                throw std::runtime_error("Invalid array index: " + token);
+
+            size_t index = std::stoull(token);
+            if (index > limit)
+                throw std::runtime_error("Array index out of range: " + token);
+            return index;
+        }
+
+        JsonValue &resolve(JsonValue &root, const Path &path, size_t count)
+        {
+            JsonValue *node = &root;
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto &v = node->get_value();
+                if (auto *object = std::get_if<JsonObject>(&v))
+                {
+                    auto it = object->find(path[i]);
+                    if (it == object->end())
+                        throw std::runtime_error("Path not found: " + path[i]);
+                    node = &it->second;
+                }
+                else if (auto *array = std::get_if<JsonValue::array_t>(&v))
+                {
+                    size_t index = parseIndex(path[i], array->size());
+                    if (index == array->size())
+                        throw std::runtime_error("Array index out of range: " + path[i]);
+                    node = &(*array)[index];
+                }
+                else
+                {
+                    throw std::runtime_error("Cannot descend into a scalar at: " + path[i]);
+                }
+            }
+            return *node;
+        }
+
+        JsonValue &resolve(JsonValue &root, const Path &path)
+        {
+            return resolve(root, path, path.size());
+        }
+
+        /*
+         * Inverse of one primitive edit, replayed in reverse order to roll a
+         * failed patch back without having copied the document up front.
+         */
+        struct Undo
+        {
+            enum Kind
+            {
+                Remove,  // remove the value now at `path`
+                Insert,  // put `value` back at `path`
+                Restore, // overwrite the value at `path` with `value`
+                Move     // move the value at `path` back to `from`
+            };
+
+            Kind kind;
+            Path path;
+            Path from;
+            JsonValue value;
+            bool overwrote = false; // Move: `value` was displaced at `path`
+        };
+
+        using UndoLog = std::vector<Undo>;
+
+        // Leaves `value` untouched when it throws, so callers can put it back.
+        void insert(JsonValue &root, Path path, JsonValue &&value, UndoLog *undo)
+        {
+            if (path.empty())
+            {
+                if (undo)
+                    undo->push_back({Undo::Restore, {}, {}, std::move(root)});
+                root = std::move(value);
+                return;
+            }
+
+            JsonValue &parent = resolve(root, path, path.size() - 1);
+            auto &v = parent.get_value();
+            if (auto *object = std::get_if<JsonObject>(&v))
+            {
+                auto it = object->find(path.back());
+                if (it != object->end())
+                {
+                    if (undo)
+                        undo->push_back({Undo::Restore, path, {}, std::move(it->second)});
+                    it->second = std::move(value);
+                }
+                else
+                {
+                    (*object)[path.back()] = std::move(value);
+                    if (undo)
+                        undo->push_back({Undo::Remove, std::move(path), {}, {}});
+                }
+            }
+            else if (auto *array = std::get_if<JsonValue::array_t>(&v))
+            {
+                size_t index = path.back() == "-" ? array->size() : parseIndex(path.back(), array->size());
+                array->insert(array->begin() + static_cast<std::ptrdiff_t>(index), std::move(value));
+                if (undo)
+                {
+                    path.back() = std::to_string(index);
+                    undo->push_back({Undo::Remove, std::move(path), {}, {}});
+                }
+            }
+            else
+            {
+                throw std::runtime_error("Cannot add a member to a scalar");
+            }
+        }
+
+        JsonValue take(JsonValue &root, const Path &path)
+        {
+            if (path.empty())
+                throw std::runtime_error("Cannot remove the document root");
+
+            JsonValue &parent = resolve(root, path, path.size() - 1);
+            auto &v = parent.get_value();
+            if (auto *object = std::get_if<JsonObject>(&v))
+            {
+                auto it = object->find(path.back());
+                if (it == object->end())
+                    throw std::runtime_error("Path not found: " + path.back());
+                JsonValue value = std::move(it->second);
+                object->erase(path.back());
+                return value;
+            }
+            if (auto *array = std::get_if<JsonValue::array_t>(&v))
+            {
+                size_t index = parseIndex(path.back(), array->size());
+                if (index == array->size())
+                    throw std::runtime_error("Array index out of range: " + path.back());
+                JsonValue value = std::move((*array)[index]);
+                array->erase(array->begin() + static_cast<std::ptrdiff_t>(index));
+                return value;
+            }
+            throw std::runtime_error("Cannot remove a member of a scalar");
+        }
+
+        void rollback(JsonValue &root, UndoLog &undo)
+        {
+            for (auto it = undo.rbegin(); it != undo.rend(); ++it)
+            {
+                switch (it->kind)
+                {
+                case Undo::Remove:
+                    take(root, it->path);
+                    break;
+                case Undo::Insert:
+                    insert(root, it->path, std::move(it->value), nullptr);
+                    break;
+                case Undo::Restore:
+                    resolve(root, it->path) = std::move(it->value);
+                    break;
+                case Undo::Move:
+                {
+                    JsonValue moved;
+                    if (it->overwrote)
+                    {
+                        JsonValue &slot = resolve(root, it->path);
+                        moved = std::move(slot);
+                        slot = std::move(it->value);
+                    }
+                    else
+                    {
+                        moved = take(root, it->path);
+                    }
+                    insert(root, it->from, std::move(moved), nullptr);
+                    break;
+                }
+                }
+            }
+        }
+
+        bool isProperPrefix(const Path &prefix, const Path &path)
+        {
+            return prefix.size() < path.size() && std::equal(prefix.begin(), prefix.end(), path.begin());
+        }
+
+        std::string member(const JsonObject &op, const std::string &name)
+        {
+            auto it = op.find(name);
+            if (it == op.end() || !it->second.is_string())
+                throw std::runtime_error("Missing string member '" + name + "'");
+            return std::string(it->second.get_string());
+        }
+
+        // Patch is `const JsonValue` or `JsonValue`; values are moved out of a
+        // mutable patch and copied out of a const one.
+        template <typename Patch>
+        void applyPatchImpl(JsonValue &target, Patch &patch)
+        {
+            auto *ops = std::get_if<JsonValue::array_t>(&patch.get_value());
+            if (!ops)
+                throw PatchException(0, "patch document must be an array");
+
+            UndoLog undo;
+            for (size_t i = 0; i < ops->size(); ++i)
+            {
+                try
+                {
+                    auto *op = std::get_if<JsonObject>(&(*ops)[i].get_value());
+                    if (!op)
+                        throw std::runtime_error("operation must be an object");
+
+                    std::string name = member(*op, "op");
+                    Path path = parsePointer(member(*op, "path"));
+
+                    auto value = [op]() -> JsonValue
+                    {
+                        auto it = op->find("value");
+                        if (it == op->end())
+                            throw std::runtime_error("Missing member 'value'");
+                        return std::move(it->second);
+                    };
+
+                    if (name == "add")
+                    {
+                        insert(target, std::move(path), value(), &undo);
+                    }
+                    else if (name == "remove")
+                    {
+                        JsonValue removed = take(target, path);
+                        undo.push_back({Undo::Insert, std::move(path), {}, std::move(removed)});
+                    }
+                    else if (name == "replace")
+                    {
+                        JsonValue &slot = resolve(target, path);
+                        JsonValue replacement = value();
+                        undo.push_back({Undo::Restore, std::move(path), {}, std::move(slot)});
+                        slot = std::move(replacement);
+                    }
+                    else if (name == "move")
+                    {
+                        Path from = parsePointer(member(*op, "from"));
+                        if (isProperPrefix(from, path))
+                            throw std::runtime_error("Cannot move a value into one of its children");
+                        if (from == path)
+                            continue;
+
+                        JsonValue moved = take(target, from);
+                        UndoLog placed;
+                        try
+                        {
+                            insert(target, path, std::move(moved), &placed);
+                        }
+                        catch (...)
+                        {
+                            insert(target, from, std::move(moved), nullptr);
+                            throw;
+                        }
+
+                        Undo &landed = placed.back();
+                        Undo entry{Undo::Move, std::move(landed.path), std::move(from), {}};
+                        if (landed.kind == Undo::Restore)
+                        {
+                            entry.value = std::move(landed.value);
+                            entry.overwrote = true;
+                        }
+                        undo.push_back(std::move(entry));
+                    }
+                    else if (name == "copy")
+                    {
+                        Path from = parsePointer(member(*op, "from"));
+                        JsonValue copied = resolve(target, from);
+                        insert(target, std::move(path), std::move(copied), &undo);
+                    }
+                    else if (name == "test")
+                    {
+                        if (!(resolve(target, path) == value()))
+                            throw std::runtime_error("Test failed at " + member(*op, "path"));
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Unknown operation '" + name + "'");
+                    }
+                }
+                catch (const std::exception &e)
+                {
+                    rollback(target, undo);
+                    throw PatchException(i, e.what());
+                }
+            }
+        }
+
+        template <typename Patch>
+        void mergePatchImpl(JsonValue &target, Patch &patch)
+        {
+            auto *members = std::get_if<JsonObject>(&patch.get_value());
+            if (!members)
+            {
+                target = std::move(patch);
+                return;
+            }
+
+            if (!target.is_object())
+                target.get_value().template emplace<JsonObject>();
+            auto &object = std::get<JsonObject>(target.get_value());
+
+            for (auto &pair : *members)
+            {
+                if (std::holds_alternative<std::nullptr_t>(pair.second.get_value()))
+                    object.erase(pair.first);
+                else
+                    mergePatchImpl(object[pair.first], pair.second);
+            }
+        }
+
+        void appendOp(JsonValue::array_t &ops, const char *op, const std::string &path, const JsonValue *value)
+        {
+            JsonObject entry;
+            entry["op"] = op;
+            entry["path"] = path;
+            if (value)
+                entry["value"] = *value;
+            ops.emplace_back(std::move(entry));
+        }
+
+        void diffInto(JsonValue::array_t &ops, const std::string &path, const JsonValue &from, const JsonValue &to)
+        {
+            const auto &a = from.get_value();
+            const auto &b = to.get_value();
+
+            if (from.is_object() && to.is_object())
+            {
+                const auto &lhs = std::get<JsonObject>(a);
+                const auto &rhs = std::get<JsonObject>(b);
+                for (const auto &pair : lhs)
+                    if (!rhs.contains(pair.first))
+                        appendOp(ops, "remove", path + "/" + escapePointerToken(pair.first), nullptr);
+                for (const auto &pair : rhs)
+                {
+                    std::string child = path + "/" + escapePointerToken(pair.first);
+                    auto it = lhs.find(pair.first);
+                    if (it == lhs.end())
+                        appendOp(ops, "add", child, &pair.second);
+                    else
+                        diffInto(ops, child, it->second, pair.second);
+                }
+                return;
+            }
+
+            if (from.is_array() && to.is_array())
+            {
+                const auto &lhs = std::get<JsonValue::array_t>(a);
+                const auto &rhs = std::get<JsonValue::array_t>(b);
+
+                // Skip the unchanged prefix and suffix, then edit the middle.
+                size_t prefix = 0;
+                while (prefix < lhs.size() && prefix < rhs.size() && lhs[prefix] == rhs[prefix])
+                    ++prefix;
+                size_t suffix = 0;
+                while (suffix < lhs.size() - prefix && suffix < rhs.size() - prefix &&
+                       lhs[lhs.size() - 1 - suffix] == rhs[rhs.size() - 1 - suffix])
+                    ++suffix;
+
+                size_t lhsEnd = lhs.size() - suffix;
+                size_t rhsEnd = rhs.size() - suffix;
+                size_t common = std::min(lhsEnd, rhsEnd);
+
+                for (size_t i = prefix; i < common; ++i)
+                    diffInto(ops, path + "/" + std::to_string(i), lhs[i], rhs[i]);
+                for (size_t i = lhsEnd; i > common; --i)
+                    appendOp(ops, "remove", path + "/" + std::to_string(common), nullptr);
+                for (size_t i = common; i < rhsEnd; ++i)
+                    appendOp(ops, "add", path + "/" + std::to_string(i), &rhs[i]);
+                return;
+            }
+
+            if (!(from == to))
+                appendOp(ops, "replace", path, &to);
+        }
+    }
+
+    std::string escapePointerToken(std::string_view token)
+    {
+        std::string out;
+        out.reserve(token.size());
+        for (char c : token)
+        {
+            if (c == '~')
+                out.append("~0");
+            else if (c == '/')
+                out.append("~1");
+            else
+                out.push_back(c);
+        }
+        return out;
+    }
+
+    void mergePatch(JsonValue &target, const JsonValue &patch)
+    {
+        mergePatchImpl(target, patch);
+    }
+
+    void mergePatch(JsonValue &target, JsonValue &&patch)
+    {
+        mergePatchImpl(target, patch);
+    }
+
+    void applyPatch(JsonValue &target, const JsonValue &patch)
+    {
+        applyPatchImpl(target, patch);
+    }
+
+    void applyPatch(JsonValue &target, JsonValue &&patch)
+    {
+        applyPatchImpl(target, patch);
+    }
+
+    JsonValue diff(const JsonValue &from, const JsonValue &to)
+    {
+        JsonValue::array_t ops;
+        diffInto(ops, "", from, to);
+        return ops;
+    }
+}
@@ -0,0 +1,631 @@
+#include "Pattern.h"
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace json::detail
+{
+    namespace
+    {
+        constexpr char32_t maxCodePoint = 0x10FFFF;
+        constexpr size_t unbounded = static_cast<size_t>(-1);
+        constexpr size_t maxNesting = 256;
+
+        using Ranges = std::vector<std::pair<char32_t, char32_t>>;
+
+        // Decodes one UTF-8 sequence at `pos` and advances past it. Bytes
+        // that do not start a complete sequence stand for themselves.
+        char32_t decode(std::string_view text, size_t &pos)
+        {
+            auto byte = static_cast<unsigned char>(text[pos]);
+            size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+            if (length == 1 || pos + length > text.size())
+            {
+                ++pos;
+                return byte;
+            }
+            char32_t c = byte & (0x7F >> length);
+            for (size_t i = 1; i < length; ++i)
+            {
+                auto next = static_cast<unsigned char>(text[pos + i]);
+                if ((next & 0xC0) != 0x80)
+                {
+                    ++pos;
+                    return byte;
+                }
+                c = (c << 6) | (next & 0x3F);
+            }
+            pos += length;
+            return c;
+        }
+
+        const Ranges digitRanges = {{'0', '9'}};
+        const Ranges wordRanges = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+        const Ranges spaceRanges = {{'\t', '\r'},     {' ', ' '},       {0xA0, 0xA0},     {0x1680, 0x1680},
+                                    {0x2000, 0x200A}, {0x2028, 0x2029}, {0x202F, 0x202F}, {0x205F, 0x205F},
+                                    {0x3000, 0x3000}, {0xFEFF, 0xFEFF}};
+        const Ranges lineTerminators = {{'\n', '\n'}, {'\r', '\r'}, {0x2028, 0x2029}};
+
+        // Code points outside `ranges`, which must be sorted and disjoint.
+        Ranges complement(const Ranges &ranges)
+        {
+            Ranges out;
+            char32_t next = 0;
+            for (auto [lo, hi] : ranges)
+            {
+                if (lo > next)
+                    out.emplace_back(next, lo - 1);
+                next = hi + 1;
+            }
+            if (next <= maxCodePoint)
+                out.emplace_back(next, maxCodePoint);
+            return out;
+        }
+
+        int hexDigit(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+    }
+
+    bool Pattern::CharClass::matches(char32_t c) const
+    {
+        if (c < 128)
+            return ascii[c];
+        bool in = std::any_of(ranges.begin(), ranges.end(), [c](const auto &r) { return c >= r.first && c <= r.second; });
+        return in != negated;
+    }
+
+    /*
+     * Recursive descent over the pattern into a small syntax tree, then code
+     * generation. Recursion follows group nesting in the pattern, which is
+     * capped, never the text being matched.
+     */
+    class Pattern::Compiler
+    {
+    public:
+        Compiler(Pattern &pattern, std::string_view source) : pattern_(pattern), source_(source) {}
+
+        void run()
+        {
+            Node root = alternation();
+            if (pos_ < source_.size())
+                fail("unmatched ')'");
+            emit(root);
+            push({Op::Match});
+            pattern_.anchored_ = pattern_.program_.front().op == Op::LineStart;
+        }
+
+    private:
+        struct Node
+        {
+            enum Kind : uint8_t
+            {
+                Empty,
+                Class,
+                LineStart,
+                LineEnd,
+                Sequence,
+                Alternation,
+                Repeat
+            };
+
+            explicit Node(Kind k = Empty) : kind(k) {}
+
+            Kind kind;
+            uint32_t cls = 0;
+            size_t min = 0, max = 0; // Repeat; max may be unbounded
+            bool greedy = true;
+            std::vector<Node> children;
+        };
+
+        Pattern &pattern_;
+        std::string_view source_;
+        size_t pos_ = 0;
+        size_t depth_ = 0;
+
+        [[noreturn]] void fail(const std::string &message) const
+        {
+            throw std::runtime_error("Invalid pattern at offset " + std::to_string(pos_) + ": " + message);
+        }
+
+        bool atEnd() const { return pos_ >= source_.size(); }
+        bool peek(char c) const { return !atEnd() && source_[pos_] == c; }
+
+        Node alternation()
+        {
+            if (++depth_ > maxNesting)
+                fail("groups nested too deeply");
+            Node alt(Node::Alternation);
+            alt.children.push_back(sequence());
+            while (peek('|'))
+            {
+                ++pos_;
+                alt.children.push_back(sequence());
+            }
+            --depth_;
+            return alt.children.size() == 1 ? std::move(alt.children.front()) : std::move(alt);
+        }
+
+        Node sequence()
+        {
+            Node seq(Node::Sequence);
+            while (!atEnd() && source_[pos_] != '|' && source_[pos_] != ')')
+            {
+                Node node = atom();
+                quantifier(node);
+                seq.children.push_back(std::move(node));
+            }
+            return seq;
+        }
+
+        // Parses a {n}, {n,} or {n,m} quantifier at pos_; returns false and
+        // leaves pos_ alone if there is none, in which case '{' is a literal.
+        bool braces(size_t &min, size_t &max)
+        {
+            size_t at = pos_;
+            auto number = [&](size_t &out)
+            {
+                size_t start = at;
+                out = 0;
+                while (at < source_.size() && source_[at] >= '0' && source_[at] <= '9')
+                    out = std::min(out * 10 + (source_[at++] - '0'), maxInstructions + 1);
+                return at > start;
+            };
+            if (source_[at++] != '{' || !number(min))
+                return false;
+            max = min;
+            if (at < source_.size() && source_[at] == ',')
+            {
+                ++at;
+                if (!number(max))
+                    max = unbounded;
+            }
+            if (at >= source_.size() || source_[at] != '}')
+                return false;
+            pos_ = at + 1;
+            return true;
+        }
+
+        void quantifier(Node &node)
+        {
+            if (atEnd())
+                return;
+            size_t min = 0, max = unbounded;
+            char c = source_[pos_];
+            if (c == '*' || c == '+' || c == '?')
+            {
+                ++pos_;
+                min = c == '+' ? 1 : 0;
+                max = c == '?' ? 1 : unbounded;
+            }
+            else if (c != '{' || !braces(min, max))
+                return;
+
+            if (node.kind == Node::LineStart || node.kind == Node::LineEnd)
+                fail("nothing to repeat");
+            if (max < min)
+                fail("numbers out of order in {} quantifier");
+            Node repeat(Node::Repeat);
+            repeat.min = min;
+            repeat.max = max;
+            if (peek('?'))
+            {
+                ++pos_;
+                repeat.greedy = false;
+            }
+            repeat.children.push_back(std::move(node));
+            node = std::move(repeat);
+        }
+
+        Node atom()
+        {
+            char c = source_[pos_];
+            switch (c)
+            {
+            case '(':
+            {
+                ++pos_;
+                if (peek('?'))
+                {
+                    if (pos_ + 1 < source_.size() && source_[pos_ + 1] == ':')
+                        pos_ += 2;
+                    else
+                        fail("lookaround and named groups are not supported");
+                }
+                Node inner = alternation();
+                if (!peek(')'))
+                    fail("missing ')'");
+                ++pos_;
+                return inner;
+            }
+            case '[':
+                ++pos_;
+                return classNode(bracket());
+            case '.':
+            {
+                ++pos_;
+                CharClass any;
+                any.ranges = lineTerminators;
+                any.negated = true;
+                return classNode(std::move(any));
+            }
+            case '^':
+                ++pos_;
+                return Node(Node::LineStart);
+            case '$':
+                ++pos_;
+                return Node(Node::LineEnd);
+            case '*':
+            case '+':
+            case '?':
+                fail("nothing to repeat");
+            case '{':
+            {
+                size_t min, max;
+                if (braces(min, max))
+                    fail("nothing to repeat");
+                ++pos_;
+                return literal('{');
+            }
+            case '\\':
+            {
+                ++pos_;
+                CharClass shorthand;
+                if (classEscape(shorthand.ranges, shorthand.negated))
+                    return classNode(std::move(shorthand));
+                return literal(characterEscape(false));
+            }
+            default:
+                return literal(decode(source_, pos_));
+            }
+        }
+
+        Node literal(char32_t c)
+        {
+            CharClass single;
+            single.ranges = {{c, c}};
+            return classNode(std::move(single));
+        }
+
+        Node classNode(CharClass cls)
+        {
+            std::sort(cls.ranges.begin(), cls.ranges.end());
+            for (auto [lo, hi] : cls.ranges)
+                for (char32_t c = lo; c <= hi && c < 128; ++c)
+                    cls.ascii.set(c);
+            if (cls.negated)
+                cls.ascii.flip();
+            Node node(Node::Class);
+            node.cls = static_cast<uint32_t>(pattern_.classes_.size());
+            pattern_.classes_.push_back(std::move(cls));
+            return node;
+        }
+
+        // \d \D \w \W \s \S after the backslash. Returns false, consuming
+        // nothing, for any other escape.
+        bool classEscape(Ranges &ranges, bool &negated)
+        {
+            if (atEnd())
+                fail("\\ at end of pattern");
+            const Ranges *set = nullptr;
+            switch (source_[pos_])
+            {
+            case 'd':
+            case 'D':
+                set = &digitRanges;
+                break;
+            case 'w':
+            case 'W':
+                set = &wordRanges;
+                break;
+            case 's':
+            case 'S':
+                set = &spaceRanges;
+                break;
+            default:
+                return false;
+            }
+            negated = source_[pos_++] < 'a';
+            ranges = *set;
+            return true;
+        }
+
+        // A single-character escape after the backslash.
+        char32_t characterEscape(bool inClass)
+        {
+            if (atEnd())
+                fail("\\ at end of pattern");
+            char c = source_[pos_++];
+            switch (c)
+            {
+            case 'n':
+                return '\n';
+            case 'r':
+                return '\r';
+            case 't':
+                return '\t';
+            case 'f':
+                return '\f';
+            case 'v':
+                return '\v';
+            case '0':
+                if (peek('0') || (!atEnd() && source_[pos_] >= '1' && source_[pos_] <= '9'))
+                    fail("octal escapes are not supported");
+                return 0;
+            case 'b':
+                if (inClass)
+                    return '\b';
+                fail("word boundaries are not supported");
+            case 'B':
+                fail("word boundaries are not supported");
+            case 'c':
+                if (atEnd() || !std::isalpha(static_cast<unsigned char>(source_[pos_])))
+                    fail("invalid control escape");
+                return static_cast<char32_t>(source_[pos_++] % 32);
+            case 'x':
+                return hex(2);
+            case 'u':
+                if (peek('{'))
+                {
+                    ++pos_;
+                    char32_t value = 0;
+                    size_t digits = 0;
+                    for (; !peek('}'); ++digits)
+                    {
+                        int d = atEnd() ? -1 : hexDigit(source_[pos_++]);
+                        if (d < 0 || (value = value * 16 + d) > maxCodePoint)
+                            fail("invalid \\u{} escape");
+                    }
+                    ++pos_;
+                    if (digits == 0)
+                        fail("invalid \\u{} escape");
+                    return value;
+                }
+                return hex(4);
+            default:
+                if (c >= '1' && c <= '9')
+                    fail("backreferences are not supported");
+                if (std::isalnum(static_cast<unsigned char>(c)))
+                    fail(std::string("unknown escape \\") + c);
+                --pos_;
+                return decode(source_, pos_);
+            }
+        }
+
+        char32_t hex(size_t digits)
+        {
+            char32_t value = 0;
+            for (size_t i = 0; i < digits; ++i)
+            {
+                int d = atEnd() ? -1 : hexDigit(source_[pos_++]);
+                if (d < 0)
+                    fail("invalid hex escape");
+                value = value * 16 + d;
+            }
+            return value;
+        }
+
+        // Body of a [...] class, after the '['.
+        CharClass bracket()
+        {
+            CharClass cls;
+            if (peek('^'))
+            {
+                ++pos_;
+                cls.negated = true;
+            }
+            while (true)
+            {
+                if (atEnd())
+                    fail("missing ']'");
+                if (peek(']'))
+                {
+                    ++pos_;
+                    return cls;
+                }
+                auto lo = classAtom(cls.ranges);
+                if (lo && peek('-') && pos_ + 1 < source_.size() && source_[pos_ + 1] != ']')
+                {
+                    ++pos_;
+                    auto hi = classAtom(cls.ranges);
+                    if (!hi)
+                        fail("invalid character class range");
+                    if (*hi < *lo)
+                        fail("character class range out of order");
+                    cls.ranges.emplace_back(*lo, *hi);
+                }
+                else if (lo)
+                    cls.ranges.emplace_back(*lo, *lo);
+            }
+        }
+
+        // One class member: a code point, or a shorthand escape whose ranges
+        // are added directly (returning nullopt).
+        std::optional<char32_t> classAtom(Ranges &ranges)
+        {
+            if (!peek('\\'))
+                return decode(source_, pos_);
+            ++pos_;
+            Ranges shorthand;
+            bool negated = false;
+            if (classEscape(shorthand, negated))
+            {
+                if (negated)
+                    shorthand = complement(shorthand);
+                ranges.insert(ranges.end(), shorthand.begin(), shorthand.end());
+                return std::nullopt;
+            }
+            return characterEscape(true);
+        }
+
+        size_t push(Instruction instruction)
+        {
+            auto &program = pattern_.program_;
+            if (program.size() >= maxInstructions)
+                fail("pattern is too complex");
+            program.push_back(instruction);
+            return program.size() - 1;
+        }
+
+        uint32_t here() const { return static_cast<uint32_t>(pattern_.program_.size()); }
+
+        // Sets a Split's preferred and alternative targets.
+        void patchSplit(size_t split, uint32_t preferred, uint32_t other, bool greedy)
+        {
+            auto &instruction = pattern_.program_[split];
+            instruction.x = greedy ? preferred : other;
+            instruction.y = greedy ? other : preferred;
+        }
+
+        void emit(const Node &node)
+        {
+            auto &program = pattern_.program_;
+            switch (node.kind)
+            {
+            case Node::Empty:
+                break;
+            case Node::Class:
+                push({Op::Class, node.cls});
+                break;
+            case Node::LineStart:
+                push({Op::LineStart});
+                break;
+            case Node::LineEnd:
+                push({Op::LineEnd});
+                break;
+            case Node::Sequence:
+                for (const Node &child : node.children)
+                    emit(child);
+                break;
+            case Node::Alternation:
+            {
+                std::vector<size_t> exits;
+                for (size_t i = 0; i < node.children.size(); ++i)
+                {
+                    if (i + 1 == node.children.size())
+                    {
+                        emit(node.children[i]);
+                        break;
+                    }
+                    size_t split = push({Op::Split});
+                    emit(node.children[i]);
+                    exits.push_back(push({Op::Jump}));
+                    patchSplit(split, static_cast<uint32_t>(split + 1), here(), true);
+                }
+                for (size_t exit : exits)
+                    program[exit].x = here();
+                break;
+            }
+            case Node::Repeat:
+            {
+                const Node &body = node.children.front();
+                for (size_t i = 0; i < node.min; ++i)
+                    emit(body);
+                if (node.max == unbounded)
+                {
+                    size_t loop = push({Op::Split});
+                    emit(body);
+                    push({Op::Jump, static_cast<uint32_t>(loop)});
+                    patchSplit(loop, static_cast<uint32_t>(loop + 1), here(), node.greedy);
+                }
+                else
+                {
+                    for (size_t i = node.min; i < node.max; ++i)
+                    {
+                        size_t split = push({Op::Split});
+                        emit(body);
+                        patchSplit(split, static_cast<uint32_t>(split + 1), here(), node.greedy);
+                    }
+                }
+                break;
+            }
+            }
+        }
+    };
+
+    Pattern::Pattern(std::string_view source)
+    {
+        Compiler(*this, source).run();
+    }
+
+    bool Pattern::search(std::string_view text) const
+    {
+        // Thread lists hold Class instructions waiting for the next code
+        // point. `added[pc]` stamps the position a pc was last added at, so
+        // each list holds a pc at most once and epsilon loops terminate.
+        std::vector<uint32_t> current, next, stack;
+        std::vector<size_t> added(program_.size(), static_cast<size_t>(-1));
+        current.reserve(program_.size());
+        next.reserve(program_.size());
+
+        // Follows Split/Jump/assertions from `start` at text offset `pos`;
+        // returns true on reaching Match.
+        auto add = [&](std::vector<uint32_t> &list, uint32_t start, size_t pos)
+        {
+            stack.push_back(start);
+            while (!stack.empty())
+            {
+                uint32_t pc = stack.back();
+                stack.pop_back();
+                if (added[pc] == pos)
+                    continue;
+                added[pc] = pos;
+                const Instruction &instruction = program_[pc];
+                switch (instruction.op)
+                {
+                case Op::Class:
+                    list.push_back(pc);
+                    break;
+                case Op::Split:
+                    stack.push_back(instruction.y);
+                    stack.push_back(instruction.x);
+                    break;
+                case Op::Jump:
+                    stack.push_back(instruction.x);
+                    break;
+                case Op::LineStart:
+                    if (pos == 0)
+                        stack.push_back(pc + 1);
+                    break;
+                case Op::LineEnd:
+                    if (pos == text.size())
+                        stack.push_back(pc + 1);
+                    break;
+                case Op::Match:
+                    stack.clear();
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        size_t pos = 0;
+        while (true)
+        {
+            // Unanchored search: a new attempt starts at every position.
+            if ((pos == 0 || !anchored_) && add(current, 0, pos))
+                return true;
+            if (pos == text.size() || (current.empty() && anchored_))
+                return false;
+
+            size_t following = pos;
+            char32_t c = decode(text, following);
+            next.clear();
+            for (uint32_t pc : current)
+                if (classes_[program_[pc].x].matches(c) && add(next, pc + 1, following))
+                    return true;
+            std::swap(current, next);
+            pos = following;
+        }
+    }
+}
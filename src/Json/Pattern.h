@@ -0,0 +1,73 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json::detail
+{
+    /*
+     * ECMAScript regular expression subset for the schema "pattern" keyword,
+     * compiled to a Thompson NFA and run as a Pike VM. Matching never
+     * recurses or backtracks: it costs O(text length * program size) time
+     * and O(program size) memory whatever the pattern or input.
+     *
+     * Supported: literals, ., classes ([a-z], [^...]), \d \D \w \W \s \S,
+     * character escapes, ^ and $, groups ((...) and (?:...)), | and the
+     * quantifiers * + ? {n} {n,} {n,m}, greedy or lazy. Backreferences,
+     * lookaround and word boundaries are rejected. Text and pattern are
+     * matched by code point, decoding UTF-8.
+     */
+    class Pattern
+    {
+    public:
+        // Upper bound on the compiled program; counted repetition expands
+        // into copies of its operand, so {n,m} counts towards it.
+        static constexpr size_t maxInstructions = 10000;
+
+        // Throws std::runtime_error for malformed, unsupported or
+        // over-sized patterns.
+        explicit Pattern(std::string_view source);
+
+        // True if the pattern matches anywhere in `text`.
+        bool search(std::string_view text) const;
+
+    private:
+        class Compiler;
+
+        struct CharClass
+        {
+            std::bitset<128> ascii;                            // resolved, negation applied
+            std::vector<std::pair<char32_t, char32_t>> ranges; // inclusive, before negation
+            bool negated = false;
+
+            bool matches(char32_t c) const;
+        };
+
+        enum class Op : uint8_t
+        {
+            Class,     // consume one code point in classes_[x]
+            Split,     // fork to x (preferred) and y
+            Jump,      // continue at x
+            LineStart, // assert start of text
+            LineEnd,   // assert end of text
+            Match
+        };
+
+        struct Instruction
+        {
+            Op op;
+            uint32_t x = 0;
+            uint32_t y = 0;
+        };
+
+        std::vector<Instruction> program_;
+        std::vector<CharClass> classes_;
+        bool anchored_ = false; // program starts with LineStart
+    };
+}
+
+#endif // PATTERN_H
@@ -0,0 +1,44 @@
+#include "json/Projection.h"
+#include "Encoding.h"
+
+namespace json
+{
+    Projection::Projection(std::initializer_list<std::string_view> paths) : nodes_(1)
+    {
+        for (std::string_view path : paths)
+            add(path);
+    }
+
+    Projection &Projection::add(std::string_view pointer)
+    {
+        return add(detail::parsePointer(pointer));
+    }
+
+    Projection &Projection::add(const std::vector<std::string> &path)
+    {
+        size_t node = 0;
+        for (const std::string &key : path)
+        {
+            if (nodes_[node].whole)
+                return *this;
+
+            auto it = nodes_[node].children.find(key);
+            if (it != nodes_[node].children.end())
+            {
+                node = it->second;
+                continue;
+            }
+
+            // Index, not reference: emplace_back may reallocate.
+            size_t child = nodes_.size();
+            nodes_.emplace_back();
+            nodes_[node].children.emplace(key, child);
+            node = child;
+        }
+
+        // A selected subtree subsumes any narrower paths below it.
+        nodes_[node].whole = true;
+        nodes_[node].children.clear();
+        return *this;
+    }
+}
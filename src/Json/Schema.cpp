@@ -0,0 +1,674 @@
+#include "json/Schema.h"
+#include "json/Patch.h"
+#include "parser/Lexer.h"
+#include "Encoding.h"
+#include "Pattern.h"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace json
+{
+    namespace
+    {
+        // Bits of Schema::Node::types.
+        enum TypeBit : uint8_t
+        {
+            IsNull = 1 << 0,
+            IsBoolean = 1 << 1,
+            IsInteger = 1 << 2,
+            IsFraction = 1 << 3, // non-integral numbers; "number" sets both bits
+            IsString = 1 << 4,
+            IsArray = 1 << 5,
+            IsObject = 1 << 6
+        };
+
+        const std::unordered_map<std::string_view, uint8_t> typeNames = {
+            {"null", IsNull},
+            {"boolean", IsBoolean},
+            {"integer", IsInteger},
+            {"number", IsInteger | IsFraction},
+            {"string", IsString},
+            {"array", IsArray},
+            {"object", IsObject},
+        };
+
+        // Keywords that carry no validation meaning.
+        bool isAnnotation(std::string_view keyword)
+        {
+            return keyword == "$schema" || keyword == "$id" || keyword == "$comment" || keyword == "title" ||
+                   keyword == "description" || keyword == "default" || keyword == "examples" ||
+                   keyword == "deprecated" || keyword == "readOnly" || keyword == "writeOnly";
+        }
+
+        std::string formatNumber(double value)
+        {
+            std::string out;
+            detail::appendShortestNumber(out, value);
+            return out;
+        }
+
+        bool isIntegral(double value)
+        {
+            return std::isfinite(value) && std::floor(value) == value;
+        }
+
+        uint8_t numberType(double value)
+        {
+            return isIntegral(value) ? IsInteger : IsFraction;
+        }
+
+        std::optional<double> numberOf(const JsonValue &value)
+        {
+            if (value.is_number_integer())
+                return static_cast<double>(static_cast<int64_t>(value));
+            if (value.is_number_float())
+                return static_cast<double>(value);
+            return std::nullopt;
+        }
+
+        uint8_t typeOf(const JsonValue &value)
+        {
+            if (value.is_string())
+                return IsString;
+            if (value.is_object())
+                return IsObject;
+            if (value.is_array())
+                return IsArray;
+            if (value.is_boolean())
+                return IsBoolean;
+            if (auto number = numberOf(value))
+                return numberType(*number);
+            return IsNull;
+        }
+
+        std::string typeList(uint8_t types)
+        {
+            std::string out;
+            for (const char *name : {"null", "boolean", "integer", "number", "string", "array", "object"})
+            {
+                uint8_t bits = typeNames.at(name);
+                // "number" covers integers; list it once if both are allowed.
+                if ((types & bits) != bits || (bits == IsInteger && (types & IsFraction)))
+                    continue;
+                out += out.empty() ? name : std::string(" or ") + name;
+            }
+            return out;
+        }
+
+        // Length in code points, as JSON Schema counts it.
+        size_t codePoints(std::string_view text)
+        {
+            size_t count = 0;
+            for (char c : text)
+                count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            return count;
+        }
+
+        std::string quoted(const std::string &key)
+        {
+            std::string out;
+            detail::appendEscaped(out, key);
+            return out;
+        }
+    }
+
+    Schema::Schema(const JsonValue &schema)
+    {
+        root_ = compile(schema, "");
+    }
+
+    size_t Schema::compile(const JsonValue &schema, const std::string &location)
+    {
+        if (auto *flag = std::get_if<bool>(&schema.get_value()))
+        {
+            if (*flag)
+                return unconstrained;
+            nodes_.emplace_back().types = 0;
+            return nodes_.size() - 1;
+        }
+        if (!schema.is_object())
+            throw SchemaException(location, "a schema must be an object or a boolean");
+
+        const JsonObject &keywords = std::get<JsonObject>(schema.get_value());
+        if (keywords.empty())
+            return unconstrained;
+
+        // Reserve the slot first: compiling subschemas appends to nodes_.
+        size_t index = nodes_.size();
+        nodes_.emplace_back();
+        Node node;
+
+        auto fail = [&](const std::string &keyword, const std::string &message)
+        { return SchemaException(location + "/" + escapePointerToken(keyword), message); };
+        auto number = [&](const std::string &keyword, const JsonValue &value)
+        {
+            auto n = numberOf(value);
+            if (!n)
+                throw fail(keyword, "must be a number");
+            return *n;
+        };
+        auto count = [&](const std::string &keyword, const JsonValue &value)
+        {
+            auto n = numberOf(value);
+            if (!n || *n < 0 || !isIntegral(*n))
+                throw fail(keyword, "must be a non-negative integer");
+            // Counts beyond size_t cannot be reached; casting them is undefined.
+            if (*n >= static_cast<double>(std::numeric_limits<size_t>::max()))
+                return std::numeric_limits<size_t>::max();
+            return static_cast<size_t>(*n);
+        };
+        auto subschema = [&](const std::string &keyword, const JsonValue &value)
+        { return compile(value, location + "/" + escapePointerToken(keyword)); };
+
+        for (const auto &[keyword, value] : keywords)
+        {
+            if (keyword == "type")
+            {
+                auto add = [&](const JsonValue &name)
+                {
+                    auto it = name.is_string() ? typeNames.find(name.get_string()) : typeNames.end();
+                    if (it == typeNames.end())
+                        throw fail(keyword, "unknown type");
+                    return it->second;
+                };
+                if (value.is_array())
+                {
+                    node.types = 0;
+                    for (const JsonValue &name : std::get<JsonValue::array_t>(value.get_value()))
+                        node.types |= add(name);
+                }
+                else
+                {
+                    node.types = add(value);
+                }
+            }
+            else if (keyword == "enum")
+            {
+                if (!value.is_array())
+                    throw fail(keyword, "must be an array");
+                node.allowed = std::get<JsonValue::array_t>(value.get_value());
+            }
+            else if (keyword == "const")
+            {
+                node.allowed = std::vector<JsonValue>{value};
+            }
+            else if (keyword == "minimum")
+                node.minimum = number(keyword, value);
+            else if (keyword == "maximum")
+                node.maximum = number(keyword, value);
+            else if (keyword == "exclusiveMinimum")
+                node.exclusiveMinimum = number(keyword, value);
+            else if (keyword == "exclusiveMaximum")
+                node.exclusiveMaximum = number(keyword, value);
+            else if (keyword == "minLength")
+                node.minLength = count(keyword, value);
+            else if (keyword == "maxLength")
+                node.maxLength = count(keyword, value);
+            else if (keyword == "minItems")
+                node.minItems = count(keyword, value);
+            else if (keyword == "maxItems")
+                node.maxItems = count(keyword, value);
+            else if (keyword == "pattern")
+            {
+                if (!value.is_string())
+                    throw fail(keyword, "must be a string");
+                node.patternSource = value.get_string();
+                try
+                {
+                    node.pattern = std::make_shared<const detail::Pattern>(node.patternSource);
+                }
+                catch (const std::runtime_error &e)
+                {
+                    throw fail(keyword, e.what());
+                }
+            }
+            else if (keyword == "properties")
+            {
+                if (!value.is_object())
+                    throw fail(keyword, "must be an object");
+                for (const auto &[name, property] : std::get<JsonObject>(value.get_value()))
+                {
+                    Member &member = node.members[name];
+                    member.declared = true;
+                    member.schema = compile(property, location + "/properties/" + escapePointerToken(name));
+                }
+            }
+            else if (keyword == "required")
+            {
+                if (!value.is_array())
+                    throw fail(keyword, "must be an array of strings");
+                for (const JsonValue &name : std::get<JsonValue::array_t>(value.get_value()))
+                {
+                    if (!name.is_string())
+                        throw fail(keyword, "must be an array of strings");
+                    Member &member = node.members[std::string(name.get_string())];
+                    if (member.required == unconstrained)
+                    {
+                        member.required = node.required.size();
+                        node.required.emplace_back(name.get_string());
+                    }
+                }
+            }
+            else if (keyword == "additionalProperties")
+                node.additional = subschema(keyword, value);
+            else if (keyword == "items")
+                node.items = subschema(keyword, value);
+            else if (!isAnnotation(keyword))
+                throw fail(keyword, "unsupported keyword");
+        }
+
+        nodes_[index] = std::move(node);
+        return index;
+    }
+
+    std::string Schema::checkType(const Node &node, uint8_t type)
+    {
+        if (node.types & type)
+            return {};
+        if (node.types == 0)
+            return "no value is allowed here";
+        return "expected " + typeList(node.types);
+    }
+
+    std::string Schema::checkNumber(const Node &node, double value)
+    {
+        if (node.minimum && value < *node.minimum)
+            return "must be at least " + formatNumber(*node.minimum);
+        if (node.maximum && value > *node.maximum)
+            return "must be at most " + formatNumber(*node.maximum);
+        if (node.exclusiveMinimum && value <= *node.exclusiveMinimum)
+            return "must be greater than " + formatNumber(*node.exclusiveMinimum);
+        if (node.exclusiveMaximum && value >= *node.exclusiveMaximum)
+            return "must be less than " + formatNumber(*node.exclusiveMaximum);
+        return {};
+    }
+
+    std::string Schema::checkString(const Node &node, std::string_view value)
+    {
+        if (node.minLength != 0 || node.maxLength != unconstrained)
+        {
+            size_t length = codePoints(value);
+            if (length < node.minLength)
+                return "must be at least " + std::to_string(node.minLength) + " characters long";
+            if (length > node.maxLength)
+                return "must be at most " + std::to_string(node.maxLength) + " characters long";
+        }
+        if (node.pattern && !node.pattern->search(value))
+            return "does not match pattern " + node.patternSource;
+        return {};
+    }
+
+    std::string Schema::checkAllowed(const Node &node, const JsonValue &value)
+    {
+        if (!node.allowed)
+            return {};
+        for (const JsonValue &candidate : *node.allowed)
+            if (candidate == value)
+                return {};
+        return "is not one of the allowed values";
+    }
+
+    std::expected<void, SchemaViolation> Schema::validate(const JsonValue &instance) const
+    {
+        std::string path;
+        SchemaViolation violation;
+        if (!walk(root_, instance, path, violation))
+            return std::unexpected(std::move(violation));
+        return {};
+    }
+
+    bool Schema::walk(size_t index, const JsonValue &value, std::string &path, SchemaViolation &violation) const
+    {
+        if (index == unconstrained)
+            return true;
+
+        const Node &node = nodes_[index];
+        auto fail = [&](std::string message)
+        {
+            violation.path = path;
+            violation.message = std::move(message);
+            return false;
+        };
+
+        std::string message = checkType(node, typeOf(value));
+        if (!message.empty())
+            return fail(std::move(message));
+
+        if (auto number = numberOf(value))
+        {
+            message = checkNumber(node, *number);
+        }
+        else if (value.is_string())
+        {
+            message = checkString(node, value.get_string());
+        }
+        else if (auto *array = std::get_if<JsonValue::array_t>(&value.get_value()))
+        {
+            if (array->size() < node.minItems)
+                return fail("must have at least " + std::to_string(node.minItems) + " items");
+            if (array->size() > node.maxItems)
+                return fail("must have at most " + std::to_string(node.maxItems) + " items");
+            if (node.items != unconstrained)
+            {
+                size_t length = path.size();
+                for (size_t i = 0; i < array->size(); ++i)
+                {
+                    path += "/" + std::to_string(i);
+                    if (!walk(node.items, (*array)[i], path, violation))
+                        return false;
+                    path.resize(length);
+                }
+            }
+        }
+        else if (auto *object = std::get_if<JsonObject>(&value.get_value()))
+        {
+            for (const std::string &name : node.required)
+                if (!object->contains(name))
+                    return fail("missing required property " + quoted(name));
+
+            size_t length = path.size();
+            for (const auto &[key, member] : *object)
+            {
+                auto it = node.members.find(key);
+                size_t child = it != node.members.end() && it->second.declared ? it->second.schema : node.additional;
+                if (child == unconstrained)
+                    continue;
+
+                path += "/" + escapePointerToken(key);
+                if (nodes_[child].types == 0)
+                    return fail("property " + quoted(key) + " is not allowed");
+                if (!walk(child, member, path, violation))
+                    return false;
+                path.resize(length);
+            }
+        }
+
+        if (message.empty())
+            message = checkAllowed(node, value);
+        return message.empty() || fail(std::move(message));
+    }
+
+    /*
+     * Recursive descent over pulled tokens, enforcing the JSON grammar and
+     * the schema program together. Parse errors use the same codes and
+     * offsets as the parser. Depth is bounded by ParseLimits::maxDepth, so
+     * the recursion is too.
+     */
+    class Schema::TextValidator
+    {
+    public:
+        TextValidator(const Schema &schema, std::string_view input, const ParseLimits &limits,
+                      SchemaViolation &violation)
+            : schema_(schema), input_(input), limits_(limits), lexer_(input), violation_(violation) {}
+
+        bool run()
+        {
+            if (input_.size() > limits_.maxDocumentSize)
+            {
+                violation_.parseError = ParseErrorCode::DocumentTooLarge;
+                violation_.message = toString(violation_.parseError);
+                return false;
+            }
+            advance();
+            if (!value(schema_.root_, nullptr))
+                return false;
+            if (token().type != TokenType::EndOfFile)
+                return parseError(ParseErrorCode::TrailingContent);
+            return true;
+        }
+
+    private:
+        const Schema &schema_;
+        std::string_view input_;
+        ParseLimits limits_;
+        Lexer lexer_;
+        std::vector<Token> tokens_;
+        SchemaViolation &violation_;
+        std::string path_;
+        size_t depth_ = 0;
+        size_t elements_ = 0;
+
+        Token &token() { return tokens_.front(); }
+
+        void advance()
+        {
+            tokens_.clear();
+            if (!lexer_.next(tokens_))
+                tokens_.emplace_back(TokenType::EndOfFile, "", input_.size());
+        }
+
+        bool parseError(ParseErrorCode code)
+        {
+            if (token().type == TokenType::EndOfFile)
+                code = ParseErrorCode::UnexpectedEndOfInput;
+            else if (token().type == TokenType::Invalid)
+                code = ParseErrorCode::InvalidToken;
+            violation_.path = path_;
+            violation_.message = toString(code);
+            violation_.offset = token().position;
+            violation_.parseError = code;
+            return false;
+        }
+
+        bool schemaError(std::string message, size_t offset)
+        {
+            violation_.path = path_;
+            violation_.message = std::move(message);
+            violation_.offset = offset;
+            return false;
+        }
+
+        // Validates one value against program node `index`. When `capture`
+        // is set the value is also built there, for enum/const comparison.
+        bool value(size_t index, JsonValue *capture)
+        {
+            if (++elements_ > limits_.maxElements)
+                return parseError(ParseErrorCode::TooManyElements);
+
+            const Node *node = index == unconstrained ? nullptr : &schema_.nodes_[index];
+            JsonValue local;
+            if (node && node->allowed && !capture)
+                capture = &local;
+
+            Token &t = token();
+            size_t start = t.position;
+            uint8_t type;
+            std::string message;
+
+            switch (t.type)
+            {
+            case TokenType::LBrace:
+            case TokenType::LBracket:
+            {
+                bool isObject = t.type == TokenType::LBrace;
+                if (depth_ >= limits_.maxDepth)
+                    return parseError(ParseErrorCode::DepthLimitExceeded);
+                if (node && !(message = checkType(*node, isObject ? IsObject : IsArray)).empty())
+                    return schemaError(std::move(message), start);
+                if (capture)
+                {
+                    if (isObject)
+                        capture->get_value().emplace<JsonObject>();
+                    else
+                        capture->get_value().emplace<JsonValue::array_t>();
+                }
+                ++depth_;
+                bool ok = isObject ? object(node, capture, start) : array(node, capture, start);
+                --depth_;
+                if (!ok)
+                    return false;
+                break;
+            }
+            case TokenType::String:
+                if (t.value.size() > limits_.maxStringLength)
+                    return parseError(ParseErrorCode::StringTooLong);
+                if (node)
+                {
+                    if ((message = checkType(*node, IsString)).empty())
+                        message = checkString(*node, t.value);
+                    if (!message.empty())
+                        return schemaError(std::move(message), start);
+                }
+                if (capture)
+                    *capture = std::move(t.value);
+                advance();
+                break;
+            case TokenType::Number:
+            {
+                double number = 0;
+                auto [end, ec] = std::from_chars(t.value.data(), t.value.data() + t.value.size(), number);
+                if (ec != std::errc() || end != t.value.data() + t.value.size())
+                    return parseError(ParseErrorCode::InvalidNumber);
+                if (node)
+                {
+                    if ((message = checkType(*node, numberType(number))).empty())
+                        message = checkNumber(*node, number);
+                    if (!message.empty())
+                        return schemaError(std::move(message), start);
+                }
+                if (capture)
+                    *capture = number;
+                advance();
+                break;
+            }
+            case TokenType::True:
+            case TokenType::False:
+            case TokenType::Null:
+                type = t.type == TokenType::Null ? IsNull : IsBoolean;
+                if (node && !(message = checkType(*node, type)).empty())
+                    return schemaError(std::move(message), start);
+                if (capture)
+                {
+                    if (t.type == TokenType::Null)
+                        *capture = nullptr;
+                    else
+                        *capture = t.type == TokenType::True;
+                }
+                advance();
+                break;
+            default:
+                return parseError(ParseErrorCode::ExpectedValue);
+            }
+
+            if (node && node->allowed && !(message = checkAllowed(*node, *capture)).empty())
+                return schemaError(std::move(message), start);
+            return true;
+        }
+
+        bool object(const Node *node, JsonValue *capture, size_t start)
+        {
+            advance();
+            if (token().type == TokenType::RBrace)
+            {
+                advance();
+                return required(node, {}, start);
+            }
+
+            std::vector<bool> seen(node ? node->required.size() : 0);
+            size_t length = path_.size();
+            while (true)
+            {
+                if (token().type != TokenType::String)
+                    return parseError(ParseErrorCode::ExpectedKey);
+                if (token().value.size() > limits_.maxStringLength)
+                    return parseError(ParseErrorCode::StringTooLong);
+                std::string key = std::move(token().value);
+                size_t keyOffset = token().position;
+                advance();
+                if (token().type != TokenType::Colon)
+                    return parseError(ParseErrorCode::ExpectedColon);
+                advance();
+
+                size_t child = unconstrained;
+                if (node)
+                {
+                    auto it = node->members.find(key);
+                    bool declared = it != node->members.end() && it->second.declared;
+                    if (it != node->members.end() && it->second.required != unconstrained)
+                        seen[it->second.required] = true;
+                    child = declared ? it->second.schema : node->additional;
+                }
+
+                path_ += "/" + escapePointerToken(key);
+                if (child != unconstrained && schema_.nodes_[child].types == 0)
+                    return schemaError("property " + quoted(key) + " is not allowed", keyOffset);
+                JsonValue *slot = capture ? &std::get<JsonObject>(capture->get_value())[key] : nullptr;
+                if (!value(child, slot))
+                    return false;
+                path_.resize(length);
+
+                if (token().type == TokenType::Comma)
+                {
+                    advance();
+                    continue;
+                }
+                if (token().type != TokenType::RBrace)
+                    return parseError(ParseErrorCode::ExpectedCommaOrBrace);
+                advance();
+                return required(node, seen, start);
+            }
+        }
+
+        bool required(const Node *node, const std::vector<bool> &seen, size_t start)
+        {
+            if (!node)
+                return true;
+            for (size_t i = 0; i < node->required.size(); ++i)
+                if (i >= seen.size() || !seen[i])
+                    return schemaError("missing required property " + quoted(node->required[i]), start);
+            return true;
+        }
+
+        bool array(const Node *node, JsonValue *capture, size_t start)
+        {
+            advance();
+            size_t count = 0;
+            size_t length = path_.size();
+            if (token().type == TokenType::RBracket)
+            {
+                advance();
+            }
+            else
+            {
+                size_t items = node ? node->items : unconstrained;
+                while (true)
+                {
+                    // Too many items is known before the array ends.
+                    if (node && count == node->maxItems)
+                        return schemaError("must have at most " + std::to_string(node->maxItems) + " items", start);
+
+                    path_ += "/" + std::to_string(count++);
+                    JsonValue *slot =
+                        capture ? &std::get<JsonValue::array_t>(capture->get_value()).emplace_back() : nullptr;
+                    if (!value(items, slot))
+                        return false;
+                    path_.resize(length);
+
+                    if (token().type == TokenType::Comma)
+                    {
+                        advance();
+                        continue;
+                    }
+                    if (token().type != TokenType::RBracket)
+                        return parseError(ParseErrorCode::ExpectedCommaOrBracket);
+                    advance();
+                    break;
+                }
+            }
+
+            if (node && count < node->minItems)
+                return schemaError("must have at least " + std::to_string(node->minItems) + " items", start);
+            return true;
+        }
+    };
+
+    std::expected<void, SchemaViolation> Schema::validateText(std::string_view input, const ParseLimits &limits) const
+    {
+        SchemaViolation violation;
+        if (!TextValidator(*this, input, limits, violation).run())
+            return std::unexpected(std::move(violation));
+        return {};
+    }
+}
@@ -0,0 +1,100 @@
+#include "json/Shape.h"
+
+#include <stdexcept>
+
+namespace json
+{
+    namespace
+    {
+        JsonObject &asRecord(JsonValue &value, size_t row)
+        {
+            auto *object = std::get_if<JsonObject>(&value.get_value());
+            if (!object)
+                throw std::invalid_argument("RecordSet element " + std::to_string(row) + " is not an object");
+            return *object;
+        }
+    }
+
+    Shape::Shape(std::initializer_list<std::string_view> keys)
+    {
+        for (std::string_view key : keys)
+            add(key);
+    }
+
+    size_t Shape::add(std::string_view key)
+    {
+        auto it = slots_.find(key);
+        if (it != slots_.end())
+            return it->second;
+        keys_.emplace_back(key);
+        slots_.emplace(keys_.back(), keys_.size() - 1);
+        return keys_.size() - 1;
+    }
+
+    size_t Shape::slot(const Key &key) const
+    {
+        auto it = slots_.find(key);
+        return it == slots_.end() ? npos : it->second;
+    }
+
+    size_t Shape::slot(std::string_view key) const
+    {
+        auto it = slots_.find(key);
+        return it == slots_.end() ? npos : it->second;
+    }
+
+    RecordSet::RecordSet(std::shared_ptr<const Shape> shape, size_t rows)
+        : shape_(std::move(shape)), rows_(rows), values_(rows * shape_->size()), present_(rows * shape_->size()) {}
+
+    void RecordSet::store(size_t row, JsonObject &record)
+    {
+        size_t base = row * shape_->size();
+        for (auto &[key, value] : record)
+        {
+            size_t slot = shape_->slot(std::string_view(key));
+            if (slot == Shape::npos)
+                continue;
+            values_[base + slot] = std::move(value);
+            present_[base + slot] = true;
+        }
+    }
+
+    RecordSet RecordSet::fromArray(JsonValue::array_t records)
+    {
+        auto shape = std::make_shared<Shape>();
+        for (size_t row = 0; row < records.size(); ++row)
+            for (const auto &member : asRecord(records[row], row))
+                shape->add(member.first);
+
+        RecordSet set(std::move(shape), records.size());
+        for (size_t row = 0; row < records.size(); ++row)
+            set.store(row, asRecord(records[row], row));
+        return set;
+    }
+
+    RecordSet RecordSet::fromArray(JsonValue::array_t records, std::shared_ptr<const Shape> shape)
+    {
+        for (size_t row = 0; row < records.size(); ++row)
+            asRecord(records[row], row);
+
+        RecordSet set(std::move(shape), records.size());
+        for (size_t row = 0; row < records.size(); ++row)
+            set.store(row, asRecord(records[row], row));
+        return set;
+    }
+
+    JsonValue::array_t RecordSet::toArray() const
+    {
+        JsonValue::array_t records;
+        records.reserve(rows_);
+        for (size_t row = 0; row < rows_; ++row)
+        {
+            JsonObject record;
+            for (size_t slot = 0; slot < shape_->size(); ++slot)
+                if (const JsonValue *value = get(row, slot))
+                    record[Key(shape_->key(slot))] = *value;
+            records.emplace_back(std::move(record));
+        }
+        return records;
+    }
+}
@@ -0,0 +1,438 @@
+#include "json/Snapshot.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace json
+{
+    using namespace snapshot;
+
+    namespace
+    {
+        class SnapshotBuilder
+        {
+        public:
+            std::string build(const JsonValue &value)
+            {
+                buffer_.assign(sizeof(SnapshotHeader), '\0');
+                size_t root = allocate(sizeof(SnapshotNode));
+                writeNode(root, value);
+
+                size_t strings = buffer_.size();
+                buffer_.append(strings_);
+                buffer_.resize(align(buffer_.size()), '\0');
+
+                for (size_t patch : stringPatches_)
+                {
+                    uint64_t offset;
+                    std::memcpy(&offset, buffer_.data() + patch, sizeof(offset));
+                    offset += strings;
+                    std::memcpy(buffer_.data() + patch, &offset, sizeof(offset));
+                }
+
+                SnapshotHeader header{};
+                std::memcpy(header.magic, magic, sizeof(magic));
+                header.version = version;
+                header.size = buffer_.size();
+                header.root = root;
+                header.strings = strings;
+                std::memcpy(buffer_.data(), &header, sizeof(header));
+
+                return std::move(buffer_);
+            }
+
+        private:
+            std::string buffer_;
+            std::string strings_;
+            std::unordered_map<std::string_view, uint64_t> interned_;
+            std::vector<size_t> stringPatches_;
+
+            static size_t align(size_t n) { return (n + 7) & ~size_t(7); }
+
+            size_t allocate(size_t bytes)
+            {
+                size_t at = buffer_.size();
+                buffer_.resize(at + bytes, '\0');
+                return at;
+            }
+
+            uint64_t intern(std::string_view str)
+            {
+                auto it = interned_.find(str);
+                if (it != interned_.end())
+                    return it->second;
+
+                uint64_t offset = strings_.size();
+                strings_.append(str);
+                strings_.push_back('\0');
+                interned_.emplace(str, offset);
+                return offset;
+            }
+
+            // Lengths and counts are 32-bit fields in the format.
+            static uint32_t narrow(size_t n)
+            {
+                if (n > std::numeric_limits<uint32_t>::max())
+                    throw std::length_error("Snapshot size field overflow: " + std::to_string(n));
+                return static_cast<uint32_t>(n);
+            }
+
+            void store(size_t at, const void *record, size_t bytes)
+            {
+                std::memcpy(buffer_.data() + at, record, bytes);
+            }
+
+            void writeNode(size_t at, const JsonValue &value)
+            {
+                SnapshotNode node{};
+                const auto &v = value.get_value();
+
+                if (std::holds_alternative<std::nullptr_t>(v))
+                {
+                    node.type = Null;
+                }
+                else if (std::holds_alternative<JsonValue::boolean_t>(v))
+                {
+                    node.type = Boolean;
+                    node.payload = std::get<JsonValue::boolean_t>(v) ? 1 : 0;
+                }
+                else if (std::holds_alternative<JsonValue::number_integer_t>(v))
+                {
+                    node.type = Integer;
+                    std::memcpy(&node.payload, &std::get<JsonValue::number_integer_t>(v), sizeof(node.payload));
+                }
+                else if (std::holds_alternative<JsonValue::number_float_t>(v))
+                {
+                    node.type = Float;
+                    std::memcpy(&node.payload, &std::get<JsonValue::number_float_t>(v), sizeof(node.payload));
+                }
+                else if (value.is_string())
+                {
+                    std::string_view str = value.get_string();
+                    node.type = String;
+                    node.count = narrow(str.size());
+                    node.payload = intern(str);
+                    stringPatches_.push_back(at + offsetof(SnapshotNode, payload));
+                }
+                else if (std::holds_alternative<JsonValue::array_t>(v))
+                {
+                    const auto &arr = std::get<JsonValue::array_t>(v);
+                    node.type = Array;
+                    node.count = narrow(arr.size());
+                    node.payload = allocate(arr.size() * sizeof(SnapshotNode));
+                    for (size_t i = 0; i < arr.size(); ++i)
+                        writeNode(node.payload + i * sizeof(SnapshotNode), arr[i]);
+                }
+                else if (std::holds_alternative<JsonValue::object_t>(v))
+                {
+                    std::vector<std::pair<std::string_view, const JsonValue *>> members;
+                    for (const auto &pair : std::get<JsonValue::object_t>(v))
+                        members.emplace_back(pair.first, &pair.second);
+                    std::sort(members.begin(), members.end(),
+                              [](const auto &a, const auto &b)
+                              { return a.first < b.first; });
+
+                    node.type = Object;
+                    node.count = narrow(members.size());
+                    node.payload = allocate(members.size() * (sizeof(SnapshotEntry) + sizeof(SnapshotNode)));
+
+                    size_t values = node.payload + members.size() * sizeof(SnapshotEntry);
+                    for (size_t i = 0; i < members.size(); ++i)
+                    {
+                        SnapshotEntry entry{};
+                        entry.key = intern(members[i].first);
+                        entry.length = narrow(members[i].first.size());
+
+                        size_t entryAt = node.payload + i * sizeof(SnapshotEntry);
+                        store(entryAt, &entry, sizeof(entry));
+                        stringPatches_.push_back(entryAt + offsetof(SnapshotEntry, key));
+                        writeNode(values + i * sizeof(SnapshotNode), *members[i].second);
+                    }
+                }
+
+                store(at, &node, sizeof(node));
+            }
+        };
+    }
+
+    std::string snapshotEncode(const JsonValue &value)
+    {
+        SnapshotBuilder builder;
+        return builder.build(value);
+    }
+
+    void snapshotWrite(const std::string &path, const JsonValue &value)
+    {
+        std::string data = snapshotEncode(value);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.write(data.data(), static_cast<std::streamsize>(data.size())))
+            throw std::runtime_error("Failed to write snapshot: " + path);
+    }
+
+    // ---------------------------
+    // Read-only view
+    // ---------------------------
+
+    namespace
+    {
+        std::string_view entryKey(const char *base, size_t size, const SnapshotEntry &entry)
+        {
+            if (entry.key > size || entry.length > size - entry.key)
+                throw std::runtime_error("Snapshot is corrupt");
+            return std::string_view(base + entry.key, entry.length);
+        }
+    }
+
+    SnapshotView::SnapshotView(const void *data, size_t size)
+        : base_(static_cast<const char *>(data)), size_(size)
+    {
+        if (reinterpret_cast<uintptr_t>(base_) % alignof(SnapshotNode) != 0)
+            throw std::runtime_error("Snapshot buffer is not 8-byte aligned");
+        if (size_ < sizeof(SnapshotHeader))
+            throw std::runtime_error("Snapshot is truncated");
+
+        const auto *header = reinterpret_cast<const SnapshotHeader *>(base_);
+        if (std::memcmp(header->magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("Not a JSON snapshot");
+        if (header->version != version)
+            throw std::runtime_error("Unsupported snapshot version: " + std::to_string(header->version));
+        if (header->size != size_ || header->root < sizeof(SnapshotHeader) || header->root > size_ - sizeof(SnapshotNode) ||
+            header->root % alignof(SnapshotNode) != 0 || header->strings > size_)
+            throw std::runtime_error("Snapshot is corrupt");
+    }
+
+    SnapshotValue SnapshotView::root() const
+    {
+        const auto *header = reinterpret_cast<const SnapshotHeader *>(base_);
+        return SnapshotValue(base_, size_, reinterpret_cast<const SnapshotNode *>(base_ + header->root));
+    }
+
+    void SnapshotValue::expect(NodeType type) const
+    {
+        if (!type_is(type))
+            throw std::runtime_error("Snapshot value has a different type");
+    }
+
+    const char *SnapshotValue::payload(uint64_t bytes) const
+    {
+        // The builder places children and strings after their node, so
+        // accepting only forward references also rules out cycles.
+        uint64_t end = static_cast<uint64_t>(reinterpret_cast<const char *>(node_) - base_) + sizeof(SnapshotNode);
+        uint64_t offset = node_->payload;
+        bool aligned = is_string() || offset % alignof(SnapshotNode) == 0;
+        if (offset < end || offset > size_ || bytes > size_ - offset || !aligned)
+            throw std::runtime_error("Snapshot is corrupt");
+        return base_ + offset;
+    }
+
+    size_t SnapshotValue::size() const
+    {
+        return (is_array() || is_object() || is_string()) ? node_->count : 0;
+    }
+
+    SnapshotValue SnapshotValue::operator[](std::string_view key) const
+    {
+        if (!is_object())
+            return {};
+
+        uint64_t count = node_->count;
+        const auto *entries = reinterpret_cast<const SnapshotEntry *>(payload(count * (sizeof(SnapshotEntry) + sizeof(SnapshotNode))));
+        const auto *values = reinterpret_cast<const SnapshotNode *>(entries + count);
+
+        size_t lo = 0;
+        size_t hi = count;
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            int cmp = entryKey(base_, size_, entries[mid]).compare(key);
+            if (cmp == 0)
+                return SnapshotValue(base_, size_, values + mid);
+            if (cmp < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return {};
+    }
+
+    SnapshotValue SnapshotValue::operator[](size_t index) const
+    {
+        if (!is_array() || index >= node_->count)
+            return {};
+        const auto *first = reinterpret_cast<const SnapshotNode *>(payload(uint64_t(node_->count) * sizeof(SnapshotNode)));
+        return SnapshotValue(base_, size_, first + index);
+    }
+
+    SnapshotObject SnapshotValue::items() const
+    {
+        expect(Object);
+        uint64_t count = node_->count;
+        const auto *entries = reinterpret_cast<const SnapshotEntry *>(payload(count * (sizeof(SnapshotEntry) + sizeof(SnapshotNode))));
+        for (uint64_t i = 0; i < count; ++i)
+            entryKey(base_, size_, entries[i]);
+        return SnapshotObject(base_, size_, entries, count);
+    }
+
+    SnapshotArray SnapshotValue::elements() const
+    {
+        expect(Array);
+        uint64_t count = node_->count;
+        return SnapshotArray(base_, size_, reinterpret_cast<const SnapshotNode *>(payload(count * sizeof(SnapshotNode))), count);
+    }
+
+    SnapshotValue::operator std::string_view() const
+    {
+        expect(String);
+        return std::string_view(payload(node_->count), node_->count);
+    }
+
+    SnapshotValue::operator JsonValue::boolean_t() const
+    {
+        expect(Boolean);
+        return node_->payload != 0;
+    }
+
+    SnapshotValue::operator JsonValue::number_integer_t() const
+    {
+        expect(Integer);
+        JsonValue::number_integer_t value;
+        std::memcpy(&value, &node_->payload, sizeof(value));
+        return value;
+    }
+
+    SnapshotValue::operator JsonValue::number_float_t() const
+    {
+        expect(Float);
+        JsonValue::number_float_t value;
+        std::memcpy(&value, &node_->payload, sizeof(value));
+        return value;
+    }
+
+    JsonValue SnapshotValue::toJsonValue() const
+    {
+        if (!node_ || is_null())
+            return JsonValue();
+        if (is_boolean())
+            return static_cast<JsonValue::boolean_t>(*this);
+        if (is_number_integer())
+            return static_cast<JsonValue::number_integer_t>(*this);
+        if (is_number_float())
+            return static_cast<JsonValue::number_float_t>(*this);
+        if (is_string())
+            return static_cast<JsonValue::string_t>(*this);
+
+        if (is_array())
+        {
+            JsonValue::array_t arr;
+            arr.reserve(node_->count);
+            for (SnapshotValue element : elements())
+                arr.push_back(element.toJsonValue());
+            return arr;
+        }
+
+        JsonObject obj;
+        for (auto [key, member] : items())
+            obj[std::string(key)] = member.toJsonValue();
+        return obj;
+    }
+
+    // ---------------------------
+    // Memory-mapped files
+    // ---------------------------
+
+#ifdef _WIN32
+    MappedSnapshot::MappedSnapshot(const std::string &path)
+    {
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to open snapshot: " + path);
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<size_t>(size.QuadPart);
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data_)
+        {
+            if (mapping_)
+                CloseHandle(mapping_);
+            CloseHandle(file_);
+            throw std::runtime_error("Failed to map snapshot: " + path);
+        }
+
+        try
+        {
+            view();
+        }
+        catch (...)
+        {
+            UnmapViewOfFile(data_);
+            CloseHandle(mapping_);
+            CloseHandle(file_);
+            throw;
+        }
+    }
+
+    MappedSnapshot::~MappedSnapshot()
+    {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+    }
+#else
+    MappedSnapshot::MappedSnapshot(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Failed to open snapshot: " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat snapshot: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data_ == MAP_FAILED)
+        {
+            data_ = nullptr;
+            throw std::runtime_error("Failed to map snapshot: " + path);
+        }
+
+        try
+        {
+            view();
+        }
+        catch (...)
+        {
+            ::munmap(data_, size_);
+            throw;
+        }
+    }
+
+    MappedSnapshot::~MappedSnapshot()
+    {
+        if (data_)
+            ::munmap(data_, size_);
+    }
+#endif
+}
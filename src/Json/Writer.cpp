@@ -0,0 +1,225 @@
+#include "json/Writer.h"
+#include "Encoding.h"
+
+#include <cerrno>
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace json
+{
+    void StreamSink::write(std::string_view data)
+    {
+        out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out_)
+            throw std::runtime_error("Failed to write JSON to stream");
+    }
+
+    void FdSink::write(std::string_view data)
+    {
+        while (!data.empty())
+        {
+#ifdef _WIN32
+            int n = _write(fd_, data.data(), static_cast<unsigned>(data.size()));
+#else
+            ssize_t n = ::write(fd_, data.data(), data.size());
+#endif
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "Failed to write JSON to fd");
+            }
+            data.remove_prefix(static_cast<size_t>(n));
+        }
+    }
+
+    Writer::Writer(Sink &sink, size_t bufferSize) : sink_(sink), bufferSize_(bufferSize ? bufferSize : 1)
+    {
+        // Slack for the separators and short values appended past the
+        // threshold before the next flush check.
+        buffer_.reserve(bufferSize_ + 64);
+    }
+
+    Writer::~Writer()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void Writer::flush()
+    {
+        if (buffer_.empty())
+            return;
+        sink_.write(buffer_);
+        buffer_.clear();
+    }
+
+    void Writer::prefix([[maybe_unused]] bool isKey)
+    {
+#if JSON_WRITER_CHECKS
+        if (stack_.empty() && done_)
+            throw std::logic_error("Writer: only one root value may be written");
+        if (isKey && (stack_.empty() || !stack_.back().object || afterKey_))
+            throw std::logic_error("Writer: key() is only valid directly inside an object");
+        if (!isKey && !stack_.empty() && stack_.back().object && !afterKey_)
+            throw std::logic_error("Writer: object members need a key() first");
+#endif
+        if (afterKey_)
+        {
+            afterKey_ = false;
+            return;
+        }
+        if (stack_.empty())
+            return;
+        if (!stack_.back().empty)
+            buffer_.push_back(',');
+        stack_.back().empty = false;
+    }
+
+    void Writer::close(bool object)
+    {
+#if JSON_WRITER_CHECKS
+        if (stack_.empty() || stack_.back().object != object)
+            throw std::logic_error(object ? "Writer: end_object() without a matching begin_object()"
+                                          : "Writer: end_array() without a matching begin_array()");
+        if (afterKey_)
+            throw std::logic_error("Writer: key() without a value");
+#endif
+        buffer_.push_back(object ? '}' : ']');
+        stack_.pop_back();
+        done_ = stack_.empty();
+        maybeFlush();
+    }
+
+    Writer &Writer::begin_object()
+    {
+        prefix(false);
+        buffer_.push_back('{');
+        stack_.push_back({true});
+        return *this;
+    }
+
+    Writer &Writer::end_object()
+    {
+        close(true);
+        return *this;
+    }
+
+    Writer &Writer::begin_array()
+    {
+        prefix(false);
+        buffer_.push_back('[');
+        stack_.push_back({false});
+        return *this;
+    }
+
+    Writer &Writer::end_array()
+    {
+        close(false);
+        return *this;
+    }
+
+    Writer &Writer::key(std::string_view name)
+    {
+        prefix(true);
+        detail::appendEscaped(buffer_, name);
+        buffer_.push_back(':');
+        afterKey_ = true;
+        return *this;
+    }
+
+    Writer &Writer::value(std::nullptr_t)
+    {
+        prefix(false);
+        buffer_.append("null");
+        done_ = stack_.empty();
+        maybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::value(bool b)
+    {
+        prefix(false);
+        buffer_.append(b ? "true" : "false");
+        done_ = stack_.empty();
+        maybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::value(double d)
+    {
+        prefix(false);
+        detail::appendShortestNumber(buffer_, d);
+        done_ = stack_.empty();
+        maybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::integer(int64_t n, bool isUnsigned)
+    {
+        prefix(false);
+        if (isUnsigned)
+        {
+            char buf[24];
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), static_cast<uint64_t>(n));
+            (void)ec;
+            buffer_.append(buf, end);
+        }
+        else
+        {
+            detail::appendInteger(buffer_, n);
+        }
+        done_ = stack_.empty();
+        maybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::value(std::string_view s)
+    {
+        prefix(false);
+        detail::appendEscaped(buffer_, s);
+        done_ = stack_.empty();
+        maybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::value(const JsonValue &v)
+    {
+        const auto &variant = v.get_value();
+        if (auto *object = std::get_if<JsonObject>(&variant))
+        {
+            begin_object();
+            for (const auto &[name, member] : *object)
+                key(name).value(member);
+            return end_object();
+        }
+        if (auto *array = std::get_if<JsonValue::array_t>(&variant))
+        {
+            begin_array();
+            for (const JsonValue &element : *array)
+                value(element);
+            return end_array();
+        }
+        if (v.is_string())
+            return value(v.get_string());
+        if (auto *b = std::get_if<JsonValue::boolean_t>(&variant))
+            return value(*b);
+        if (auto *n = std::get_if<JsonValue::number_integer_t>(&variant))
+            return value(*n);
+        if (auto *d = std::get_if<JsonValue::number_float_t>(&variant))
+            return value(*d);
+        return value(nullptr);
+    }
+}
@@ -0,0 +1,118 @@
+#include "parser/Formatter.h"
+#include "parser/Kernels.h"
+#include "parser/Lexer.h"
+
+using namespace json;
+
+namespace
+{
+    bool isStructural(char c)
+    {
+        return c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':' || c == '"';
+    }
+
+    // Appends the string starting at `pos` verbatim and returns the index
+    // after it; an unterminated string is copied through to the end.
+    size_t copyString(std::string_view input, size_t pos, std::string &out, const Kernels &k = kernels::active())
+    {
+        size_t end = Lexer::scanString(input, pos, k);
+        if (end == std::string_view::npos)
+            end = input.size();
+        out.append(input.data() + pos, end - pos);
+        return end;
+    }
+
+    void minifyRuns(std::string_view input, std::string &out, const Kernels &k)
+    {
+        size_t pos = 0;
+        while (pos < input.size())
+        {
+            size_t run = k.findWhitespaceOrQuote(input.data(), input.size(), pos);
+            out.append(input.data() + pos, run - pos);
+            pos = run;
+
+            if (pos >= input.size())
+                break;
+            if (input[pos] == '"')
+                pos = copyString(input, pos, out, k);
+            else
+                pos = k.skipWhitespace(input.data(), input.size(), pos);
+        }
+    }
+
+    void newline(std::string &out, size_t depth, const formatter::PrettyOptions &options)
+    {
+        out.push_back('\n');
+        out.append(depth * options.indent, options.indentChar);
+    }
+}
+
+void formatter::minify(std::string_view input, std::string &out, MinifyMode mode)
+{
+    out.clear();
+    out.reserve(input.size());
+    minifyRuns(input, out, mode == MinifyMode::Simd ? kernels::active() : *kernels::forIsa(Isa::Scalar));
+}
+
+void formatter::prettify(std::string_view input, std::string &out, const PrettyOptions &options)
+{
+    out.clear();
+    out.reserve(input.size() + input.size() / 2);
+
+    size_t depth = 0;
+    size_t pos = Lexer::scanWhitespace(input, 0);
+
+    while (pos < input.size())
+    {
+        char c = input[pos];
+
+        switch (c)
+        {
+        case '"':
+            pos = copyString(input, pos, out);
+            continue;
+        case '{':
+        case '[':
+        {
+            size_t next = Lexer::scanWhitespace(input, pos + 1);
+            char close = c == '{' ? '}' : ']';
+            out.push_back(c);
+            if (next < input.size() && input[next] == close)
+            {
+                out.push_back(close);
+                pos = next + 1;
+                continue;
+            }
+            newline(out, ++depth, options);
+            break;
+        }
+        case '}':
+        case ']':
+            newline(out, depth > 0 ? --depth : 0, options);
+            out.push_back(c);
+            break;
+        case ',':
+            out.push_back(',');
+            newline(out, depth, options);
+            break;
+        case ':':
+            out.append(": ");
+            break;
+        default:
+            if (Lexer::isWhitespace(c))
+            {
+                pos = Lexer::scanWhitespace(input, pos);
+                continue;
+            }
+
+            // Numbers and literals: copy up to the next delimiter.
+            size_t end = pos;
+            while (end < input.size() && !Lexer::isWhitespace(input[end]) && !isStructural(input[end]))
+                ++end;
+            out.append(input.data() + pos, end - pos);
+            pos = end;
+            continue;
+        }
+        ++pos;
+    }
+}
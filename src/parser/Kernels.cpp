@@ -0,0 +1,195 @@
+#include "KernelsImpl.h"
+
+#include <atomic>
+#include <cstdlib>
+
+using namespace json;
+
+size_t detail::skipWhitespaceScalar(const char *data, size_t size, size_t pos)
+{
+    while (pos < size && (data[pos] == ' ' || data[pos] == '\n' || data[pos] == '\r' || data[pos] == '\t'))
+        ++pos;
+    return pos;
+}
+
+size_t detail::findStringSpecialScalar(const char *data, size_t size, size_t pos)
+{
+    while (pos < size && data[pos] != '"' && data[pos] != '\\' && static_cast<unsigned char>(data[pos]) >= 0x20)
+        ++pos;
+    return pos;
+}
+
+size_t detail::findWhitespaceOrQuoteScalar(const char *data, size_t size, size_t pos)
+{
+    while (pos < size && data[pos] != '"' && data[pos] != ' ' && data[pos] != '\n' && data[pos] != '\r' &&
+           data[pos] != '\t')
+        ++pos;
+    return pos;
+}
+
+size_t detail::skipDigitsScalar(const char *data, size_t size, size_t pos)
+{
+    while (pos < size && data[pos] >= '0' && data[pos] <= '9')
+        ++pos;
+    return pos;
+}
+
+size_t detail::validateUtf8Sequence(const char *data, size_t size, size_t pos)
+{
+    auto byte = [&](size_t i)
+    { return static_cast<unsigned char>(data[i]); };
+    auto continuation = [&](size_t i)
+    { return i < size && (byte(i) & 0xC0) == 0x80; };
+
+    unsigned char lead = byte(pos);
+    if (lead < 0x80)
+        return pos + 1;
+
+    size_t length;
+    unsigned char min = 0x80, max = 0xBF; // allowed range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF)
+        length = 2;
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        if (lead == 0xE0)
+            min = 0xA0; // overlong
+        else if (lead == 0xED)
+            max = 0x9F; // surrogates
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        if (lead == 0xF0)
+            min = 0x90; // overlong
+        else if (lead == 0xF4)
+            max = 0x8F; // above U+10FFFF
+    }
+    else
+        return 0;
+
+    if (pos + 1 >= size || byte(pos + 1) < min || byte(pos + 1) > max)
+        return 0;
+    for (size_t i = 2; i < length; ++i)
+        if (!continuation(pos + i))
+            return 0;
+    return pos + length;
+}
+
+bool detail::validateUtf8Scalar(const char *data, size_t size)
+{
+    size_t pos = 0;
+    while (pos < size)
+    {
+        pos = validateUtf8Sequence(data, size, pos);
+        if (pos == 0)
+            return false;
+    }
+    return true;
+}
+
+namespace
+{
+    const Kernels scalarKernels = {
+        Isa::Scalar,
+        detail::skipWhitespaceScalar,
+        detail::findStringSpecialScalar,
+        detail::findWhitespaceOrQuoteScalar,
+        detail::skipDigitsScalar,
+        detail::validateUtf8Scalar,
+    };
+
+    bool cpuSupports(Isa isa)
+    {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return true;
+        case Isa::Sse42:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+        }
+        return false;
+#else
+        return isa == Isa::Scalar;
+#endif
+    }
+
+    const Kernels *initialKernels()
+    {
+        Isa isa = kernels::best();
+        if (const char *env = std::getenv("JSONPARSER_ISA"))
+        {
+            // The variable caps the choice, so it is safe on any machine.
+            if (auto requested = kernels::parseIsa(env); requested && *requested < isa)
+                isa = *requested;
+            while (!kernels::supported(isa))
+                isa = static_cast<Isa>(static_cast<int>(isa) - 1);
+        }
+        return kernels::forIsa(isa);
+    }
+
+    std::atomic<const Kernels *> &activeKernels()
+    {
+        static std::atomic<const Kernels *> active{initialKernels()};
+        return active;
+    }
+}
+
+bool kernels::supported(Isa isa)
+{
+    return forIsa(isa) != nullptr;
+}
+
+Isa kernels::best()
+{
+    for (Isa isa : {Isa::Avx512, Isa::Avx2, Isa::Sse42})
+        if (supported(isa))
+            return isa;
+    return Isa::Scalar;
+}
+
+const Kernels *kernels::forIsa(Isa isa)
+{
+    if (!cpuSupports(isa))
+        return nullptr;
+    switch (isa)
+    {
+    case Isa::Scalar:
+        return &scalarKernels;
+    case Isa::Sse42:
+        return detail::sse42Kernels();
+    case Isa::Avx2:
+        return detail::avx2Kernels();
+    case Isa::Avx512:
+        return detail::avx512Kernels();
+    }
+    return nullptr;
+}
+
+const Kernels &kernels::active()
+{
+    return *activeKernels().load(std::memory_order_relaxed);
+}
+
+bool kernels::select(Isa isa)
+{
+    const Kernels *table = forIsa(isa);
+    if (!table)
+        return false;
+    activeKernels().store(table, std::memory_order_relaxed);
+    return true;
+}
+
+std::optional<Isa> kernels::parseIsa(std::string_view name)
+{
+    for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+        if (name == toString(isa))
+            return isa;
+    return std::nullopt;
+}
@@ -0,0 +1,26 @@
+#ifndef KERNELS_IMPL_H
+#define KERNELS_IMPL_H
+
+#include "parser/Kernels.h"
+
+// Shared between the scalar kernels and the vector variants, which finish
+// their tails and hard cases with the scalar code.
+namespace json::detail
+{
+    size_t skipWhitespaceScalar(const char *data, size_t size, size_t pos);
+    size_t findStringSpecialScalar(const char *data, size_t size, size_t pos);
+    size_t findWhitespaceOrQuoteScalar(const char *data, size_t size, size_t pos);
+    size_t skipDigitsScalar(const char *data, size_t size, size_t pos);
+
+    // Validates one code point at `pos`; returns the index after it, or 0
+    // (never a valid end) when it is malformed.
+    size_t validateUtf8Sequence(const char *data, size_t size, size_t pos);
+    bool validateUtf8Scalar(const char *data, size_t size);
+
+    // nullptr when the build has no kernels for that instruction set.
+    const Kernels *sse42Kernels();
+    const Kernels *avx2Kernels();
+    const Kernels *avx512Kernels();
+}
+
+#endif // KERNELS_IMPL_H
@@ -0,0 +1,303 @@
+#include "KernelsImpl.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_KERNELS_X86 1
+#include <immintrin.h>
+#include <bit>
+#include <cstdint>
+#endif
+
+using namespace json;
+
+#ifdef JSON_KERNELS_X86
+
+// Each function is compiled for its own instruction set via target
+// attributes, so one binary carries every variant and the baseline build
+// flags stay untouched. They are only called once cpuid has confirmed support.
+#define JSON_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#define JSON_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+namespace
+{
+    // SSE4.2: the packed string-compare instructions match byte sets and
+    // ranges directly.
+    constexpr int anyOf = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+    constexpr int noneOf = anyOf | _SIDD_NEGATIVE_POLARITY;
+    constexpr int inRanges = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT;
+    constexpr int outsideRanges = inRanges | _SIDD_NEGATIVE_POLARITY;
+
+    template <int Mode>
+    JSON_TARGET_SSE42 size_t scanSse42(const char *data, size_t size, size_t pos, const char *set, int setSize)
+    {
+        const __m128i needles = _mm_loadu_si128(reinterpret_cast<const __m128i *>(set));
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            int index = _mm_cmpestri(needles, setSize, block, 16, Mode);
+            if (index < 16)
+                return pos + static_cast<size_t>(index);
+        }
+        return pos;
+    }
+
+    // Needle sets are padded to 16 bytes for the unaligned load.
+    alignas(16) const char whitespaceSet[16] = {' ', '\t', '\n', '\r'};
+    alignas(16) const char whitespaceQuoteSet[16] = {' ', '\t', '\n', '\r', '"'};
+    alignas(16) const char stringSpecialRanges[16] = {'\0', '\x1f', '"', '"', '\\', '\\'};
+    alignas(16) const char digitRange[16] = {'0', '9'};
+
+    JSON_TARGET_SSE42 size_t skipWhitespaceSse42(const char *data, size_t size, size_t pos)
+    {
+        pos = scanSse42<noneOf>(data, size, pos, whitespaceSet, 4);
+        return detail::skipWhitespaceScalar(data, size, pos);
+    }
+
+    JSON_TARGET_SSE42 size_t findStringSpecialSse42(const char *data, size_t size, size_t pos)
+    {
+        pos = scanSse42<inRanges>(data, size, pos, stringSpecialRanges, 6);
+        return detail::findStringSpecialScalar(data, size, pos);
+    }
+
+    JSON_TARGET_SSE42 size_t findWhitespaceOrQuoteSse42(const char *data, size_t size, size_t pos)
+    {
+        pos = scanSse42<anyOf>(data, size, pos, whitespaceQuoteSet, 5);
+        return detail::findWhitespaceOrQuoteScalar(data, size, pos);
+    }
+
+    JSON_TARGET_SSE42 size_t skipDigitsSse42(const char *data, size_t size, size_t pos)
+    {
+        pos = scanSse42<outsideRanges>(data, size, pos, digitRange, 2);
+        return detail::skipDigitsScalar(data, size, pos);
+    }
+
+    // UTF-8: skip ASCII blocks with one test each and validate the rest code
+    // point by code point. Sequences may straddle blocks since validation
+    // always resumes on a code point boundary.
+    JSON_TARGET_SSE42 bool validateUtf8Sse42(const char *data, size_t size)
+    {
+        size_t pos = 0;
+        while (pos + 16 <= size)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            if (_mm_movemask_epi8(block) == 0)
+            {
+                pos += 16;
+                continue;
+            }
+            for (size_t end = pos + 16; pos < end;)
+                if ((pos = detail::validateUtf8Sequence(data, size, pos)) == 0)
+                    return false;
+        }
+        return detail::validateUtf8Scalar(data + pos, size - pos);
+    }
+
+    const Kernels sse42 = {
+        Isa::Sse42,
+        skipWhitespaceSse42,
+        findStringSpecialSse42,
+        findWhitespaceOrQuoteSse42,
+        skipDigitsSse42,
+        validateUtf8Sse42,
+    };
+
+    // AVX2: 32-byte compares reduced to a bit mask per block.
+    JSON_TARGET_AVX2 inline uint32_t whitespaceMaskAvx2(__m256i block)
+    {
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+    }
+
+    JSON_TARGET_AVX2 inline __m256i loadAvx2(const char *data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    }
+
+    JSON_TARGET_AVX2 size_t skipWhitespaceAvx2(const char *data, size_t size, size_t pos)
+    {
+        for (; pos + 32 <= size; pos += 32)
+        {
+            uint32_t other = ~whitespaceMaskAvx2(loadAvx2(data + pos));
+            if (other)
+                return pos + static_cast<size_t>(std::countr_zero(other));
+        }
+        return detail::skipWhitespaceScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX2 size_t findStringSpecialAvx2(const char *data, size_t size, size_t pos)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1f);
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i block = loadAvx2(data + pos);
+            // Unsigned block <= 0x1f exactly when max(block, 0x1f) == 0x1f.
+            __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash)),
+                _mm256_cmpeq_epi8(_mm256_max_epu8(block, control), control));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+            if (mask)
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+        return detail::findStringSpecialScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX2 size_t findWhitespaceOrQuoteAvx2(const char *data, size_t size, size_t pos)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i block = loadAvx2(data + pos);
+            uint32_t mask = whitespaceMaskAvx2(block) |
+                            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, quote)));
+            if (mask)
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+        return detail::findWhitespaceOrQuoteScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX2 size_t skipDigitsAvx2(const char *data, size_t size, size_t pos)
+    {
+        const __m256i zero = _mm256_set1_epi8('0');
+        const __m256i nine = _mm256_set1_epi8(9);
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i offset = _mm256_sub_epi8(loadAvx2(data + pos), zero);
+            __m256i digits = _mm256_cmpeq_epi8(_mm256_max_epu8(offset, nine), nine);
+            uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(digits));
+            if (other)
+                return pos + static_cast<size_t>(std::countr_zero(other));
+        }
+        return detail::skipDigitsScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX2 bool validateUtf8Avx2(const char *data, size_t size)
+    {
+        size_t pos = 0;
+        while (pos + 32 <= size)
+        {
+            if (_mm256_movemask_epi8(loadAvx2(data + pos)) == 0)
+            {
+                pos += 32;
+                continue;
+            }
+            for (size_t end = pos + 32; pos < end;)
+                if ((pos = detail::validateUtf8Sequence(data, size, pos)) == 0)
+                    return false;
+        }
+        return detail::validateUtf8Scalar(data + pos, size - pos);
+    }
+
+    const Kernels avx2 = {
+        Isa::Avx2,
+        skipWhitespaceAvx2,
+        findStringSpecialAvx2,
+        findWhitespaceOrQuoteAvx2,
+        skipDigitsAvx2,
+        validateUtf8Avx2,
+    };
+
+    // AVX-512BW: 64-byte compares straight into mask registers.
+    JSON_TARGET_AVX512 inline __m512i loadAvx512(const char *data)
+    {
+        return _mm512_loadu_si512(data);
+    }
+
+    JSON_TARGET_AVX512 inline __mmask64 whitespaceMaskAvx512(__m512i block)
+    {
+        return _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8(' ')) |
+               _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('\t')) |
+               _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('\n')) |
+               _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('\r'));
+    }
+
+    JSON_TARGET_AVX512 size_t skipWhitespaceAvx512(const char *data, size_t size, size_t pos)
+    {
+        for (; pos + 64 <= size; pos += 64)
+        {
+            uint64_t other = ~static_cast<uint64_t>(whitespaceMaskAvx512(loadAvx512(data + pos)));
+            if (other)
+                return pos + static_cast<size_t>(std::countr_zero(other));
+        }
+        return detail::skipWhitespaceScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX512 size_t findStringSpecialAvx512(const char *data, size_t size, size_t pos)
+    {
+        for (; pos + 64 <= size; pos += 64)
+        {
+            __m512i block = loadAvx512(data + pos);
+            uint64_t mask = _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('"')) |
+                            _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('\\')) |
+                            _mm512_cmple_epu8_mask(block, _mm512_set1_epi8(0x1f));
+            if (mask)
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+        return detail::findStringSpecialScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX512 size_t findWhitespaceOrQuoteAvx512(const char *data, size_t size, size_t pos)
+    {
+        for (; pos + 64 <= size; pos += 64)
+        {
+            __m512i block = loadAvx512(data + pos);
+            uint64_t mask = whitespaceMaskAvx512(block) | _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('"'));
+            if (mask)
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+        return detail::findWhitespaceOrQuoteScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX512 size_t skipDigitsAvx512(const char *data, size_t size, size_t pos)
+    {
+        for (; pos + 64 <= size; pos += 64)
+        {
+            __m512i offset = _mm512_sub_epi8(loadAvx512(data + pos), _mm512_set1_epi8('0'));
+            uint64_t other = ~static_cast<uint64_t>(_mm512_cmple_epu8_mask(offset, _mm512_set1_epi8(9)));
+            if (other)
+                return pos + static_cast<size_t>(std::countr_zero(other));
+        }
+        return detail::skipDigitsScalar(data, size, pos);
+    }
+
+    JSON_TARGET_AVX512 bool validateUtf8Avx512(const char *data, size_t size)
+    {
+        size_t pos = 0;
+        while (pos + 64 <= size)
+        {
+            if (_mm512_movepi8_mask(loadAvx512(data + pos)) == 0)
+            {
+                pos += 64;
+                continue;
+            }
+            for (size_t end = pos + 64; pos < end;)
+                if ((pos = detail::validateUtf8Sequence(data, size, pos)) == 0)
+                    return false;
+        }
+        return detail::validateUtf8Scalar(data + pos, size - pos);
+    }
+
+    const Kernels avx512 = {
+        Isa::Avx512,
+        skipWhitespaceAvx512,
+        findStringSpecialAvx512,
+        findWhitespaceOrQuoteAvx512,
+        skipDigitsAvx512,
+        validateUtf8Avx512,
+    };
+}
+
+const Kernels *detail::sse42Kernels() { return &sse42; }
+const Kernels *detail::avx2Kernels() { return &avx2; }
+const Kernels *detail::avx512Kernels() { return &avx512; }
+
+#else
+
+const Kernels *detail::sse42Kernels() { return nullptr; }
+const Kernels *detail::avx2Kernels() { return nullptr; }
+const Kernels *detail::avx512Kernels() { return nullptr; }
+
+#endif
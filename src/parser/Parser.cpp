@@ -1,140 +1,283 @@
 #include "parser/Parser.h"
 
+#include <charconv>
+
 using namespace json;
 
 JsonObject Parser::parse()
 {
-    return parseObject();
+    JsonValue root;
+    if (!parseDocument(root, false))
+        throw ParseException(error_);
+    return std::get<JsonObject>(std::move(root.get_value()));
 }
 
-const Token &Parser::current()
+std::expected<JsonValue, ParseError> Parser::tryParse()
 {
-    if (pos_ >= tokens_.size())
-    {
-        static Token eof{TokenType::EndOfFile};
-        return eof;
-    }
-    return tokens_[pos_];
+    JsonValue root;
+    if (!parseDocument(root, false))
+        return std::unexpected(error_);
+    return root;
 }
 
-void Parser::consume(TokenType expectedType)
+std::expected<JsonValue, ParseError> Parser::tryParseValue()
 {
-    if (current().type != expectedType)
-    {
-        throw std::runtime_error("Unexpected token: " + current().value);
-    }
-    ++pos_;
+    JsonValue root;
+    if (!parseDocument(root, true))
+        return std::unexpected(error_);
+    return root;
 }
 
-JsonValue Parser::parseValue()
+// Makes tokens_[pos_] available, pulling it from the source when parsing
+// a projection.
+bool Parser::fill()
 {
-    switch (current().type)
-    {
-    case TokenType::LBrace:
-        return parseObject();
-    case TokenType::LBracket:
-        return parseArray();
-    case TokenType::String:
-        return parseString();
-    case TokenType::Number:
-        return parseNumber();
-    case TokenType::True:
-    case TokenType::False:
-    case TokenType::Null:
-        return parseLiteral();
-    default:
-        throw std::runtime_error("Invalid JSON value: " + current().value);
-    }
+    if (pos_ < tokens_.size())
+        return true;
+    if (!source_)
+        return false;
+    tokens_.clear();
+    pos_ = 0;
+    return source_->next(tokens_);
 }
 
-JsonObject Parser::parseObject()
+const Token &Parser::current()
 {
-    consume(TokenType::LBrace);
-    JsonObject object;
-
-    while (current().type != TokenType::RBrace)
+    if (!fill())
     {
-        if (current().type == TokenType::EndOfFile)
-        {
-            throw std::runtime_error("Unexpected end of input while parsing object");
-        }
-
-        std::string key = current().value;
-        consume(TokenType::String);
-        consume(TokenType::Colon);
-        object[key] = parseValue();
-
-        if (current().type == TokenType::Comma)
-        {
-            consume(TokenType::Comma);
-        }
-        else if (current().type != TokenType::RBrace)
-        {
-            throw std::runtime_error("Expected ',' or '}' in object");
-        }
+        static Token eof{TokenType::EndOfFile};
+        return eof;
     }
-
-    consume(TokenType::RBrace);
-    return object;
+    return tokens_[pos_];
 }
 
-JsonValue Parser::parseString()
+bool Parser::fail(ParseErrorCode code)
 {
-    JsonValue str = JsonValue(current().value);
-    consume(TokenType::String);
-    return str;
+    const Token &token = current();
+    if (token.type == TokenType::EndOfFile)
+    {
+        // Lexer::tokenise positions its EndOfFile at the input size. A
+        // projection has no such token, but its source stops there too;
+        // incremental callers substitute their own buffer size.
+        code = ParseErrorCode::UnexpectedEndOfInput;
+        error_.offset = source_ ? source_->position() : token.position;
+    }
+    else
+    {
+        if (token.type == TokenType::Invalid)
+            code = ParseErrorCode::InvalidToken;
+        error_.offset = token.position;
+    }
+    error_.code = code;
+    return false;
 }
 
-JsonValue Parser::parseNumber()
+bool Parser::checkString(const Token &token)
 {
-    double num = std::stod(current().value);
-    consume(TokenType::Number);
-    return num;
+    size_t length = storage_ == StringStorage::Lazy ? token.raw.size() : token.value.size();
+    if (length > limits_.maxStringLength)
+        return fail(ParseErrorCode::StringTooLong);
+    return true;
 }
 
-JsonValue Parser::parseLiteral()
+bool Parser::parseDocument(JsonValue &out, bool anyRoot)
 {
-    bool b = (current().type == TokenType::True);
-    if (b)
-    {
-        consume(current().type);
-        return b;
-    }
-    b = (current().type == TokenType::False);
-    if (b)
+    if (!anyRoot && current().type != TokenType::LBrace)
     {
-        consume(current().type);
-        return !b;
+        error_ = ParseError{};
+        return fail(ParseErrorCode::UnexpectedToken);
     }
 
-    b = (current().type == TokenType::Null);
-    if (b)
-    {
-        consume(current().type);
-        return nullptr;
-    }
-    throw std::runtime_error("Invalid JSON value: " + current().value);
+    begin(out);
+    if (resume(true) != Progress::Complete)
+        return false;
+    if (current().type != TokenType::EndOfFile)
+        return fail(ParseErrorCode::TrailingContent);
+    return true;
 }
 
-JsonValue Parser::parseArray()
+void Parser::begin(JsonValue &out)
 {
-    consume(TokenType::LBracket);
-    std::vector<JsonValue> array;
+    error_ = ParseError{};
+    elements_ = 0;
+    stack_.clear();
+    target_ = &out;
+    state_ = State::Value;
+    node_ = projection_ && !projection_->root()->whole ? projection_->root() : nullptr;
+}
 
-    while (current().type != TokenType::RBracket && current().type != TokenType::EndOfFile)
+Parser::Progress Parser::resume(bool final)
+{
+    while (true)
     {
-        array.push_back(parseValue());
+        if (state_ == State::AfterValue && stack_.empty())
+            return Progress::Complete;
+        if (pos_ >= tokens_.size() && !final)
+            return Progress::NeedInput;
 
-        if (current().type == TokenType::Comma)
+        switch (state_)
+        {
+        case State::Value:
         {
-            consume(TokenType::Comma);
+            if (++elements_ > limits_.maxElements)
+                return fail(ParseErrorCode::TooManyElements), Progress::Failed;
+            if (!fill())
+                return fail(ParseErrorCode::ExpectedValue), Progress::Failed;
+
+            Token &token = tokens_[pos_];
+            switch (token.type)
+            {
+            case TokenType::LBrace:
+                if (stack_.size() >= limits_.maxDepth)
+                    return fail(ParseErrorCode::DepthLimitExceeded), Progress::Failed;
+                ++pos_;
+                stack_.push_back({&target_->get_value().emplace<JsonObject>(), nullptr, node_});
+                state_ = State::ObjectStart;
+                break;
+            case TokenType::LBracket:
+                if (stack_.size() >= limits_.maxDepth)
+                    return fail(ParseErrorCode::DepthLimitExceeded), Progress::Failed;
+                ++pos_;
+                stack_.push_back({nullptr, &target_->get_value().emplace<JsonValue::array_t>(), node_});
+                state_ = State::ArrayStart;
+                break;
+            case TokenType::String:
+                if (!checkString(token))
+                    return Progress::Failed;
+                if (storage_ == StringStorage::Lazy)
+                    target_->get_value().emplace<JsonValue::lazy_string_t>(token.raw, token.escaped);
+                else
+                    target_->get_value().emplace<JsonValue::string_t>(std::move(token.value));
+                ++pos_;
+                state_ = State::AfterValue;
+                break;
+            case TokenType::Number:
+            {
+                const std::string &text = token.value;
+                double num = 0;
+                auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), num);
+                if (ec != std::errc() || end != text.data() + text.size())
+                    return fail(ParseErrorCode::InvalidNumber), Progress::Failed;
+                target_->get_value().emplace<JsonValue::number_float_t>(num);
+                ++pos_;
+                state_ = State::AfterValue;
+                break;
+            }
+            case TokenType::True:
+            case TokenType::False:
+                target_->get_value().emplace<JsonValue::boolean_t>(token.type == TokenType::True);
+                ++pos_;
+                state_ = State::AfterValue;
+                break;
+            case TokenType::Null:
+                target_->get_value().emplace<std::nullptr_t>(nullptr);
+                ++pos_;
+                state_ = State::AfterValue;
+                break;
+            default:
+                return fail(ParseErrorCode::ExpectedValue), Progress::Failed;
+            }
+            break;
         }
-        else
+
+        case State::ObjectStart:
+            if (current().type == TokenType::RBrace)
+            {
+                ++pos_;
+                stack_.pop_back();
+                state_ = State::AfterValue;
+            }
+            else
+            {
+                state_ = State::Key;
+            }
+            break;
+
+        case State::ArrayStart:
+            if (current().type == TokenType::RBracket)
+            {
+                ++pos_;
+                stack_.pop_back();
+                state_ = State::AfterValue;
+            }
+            else
+            {
+                target_ = &stack_.back().array->emplace_back();
+                node_ = stack_.back().node;
+                state_ = State::Value;
+            }
+            break;
+
+        case State::Key:
+            if (current().type != TokenType::String)
+                return fail(ParseErrorCode::ExpectedKey), Progress::Failed;
+            if (!checkString(tokens_[pos_]))
+                return Progress::Failed;
+            if (storage_ == StringStorage::Lazy)
+                key_ = tokens_[pos_].escaped ? Lexer::unescape(tokens_[pos_].raw) : std::string(tokens_[pos_].raw);
+            else
+                key_ = std::move(tokens_[pos_].value);
+            ++pos_;
+            state_ = State::Colon;
+            break;
+
+        case State::Colon:
+            if (current().type != TokenType::Colon)
+                return fail(ParseErrorCode::ExpectedColon), Progress::Failed;
+            ++pos_;
+            if (const Projection::Node *node = stack_.back().node)
+            {
+                node_ = projection_->find(node, key_);
+                if (!node_)
+                {
+                    // The colon was the last token pulled, so the source is
+                    // positioned at the start of the unwanted value.
+                    if (!source_->skipValue())
+                    {
+                        error_.code = source_->eof() ? ParseErrorCode::UnexpectedEndOfInput : ParseErrorCode::ExpectedValue;
+                        error_.offset = source_->position();
+                        return Progress::Failed;
+                    }
+                    state_ = State::AfterValue;
+                    break;
+                }
+                if (node_->whole)
+                    node_ = nullptr;
+            }
+            target_ = &(*stack_.back().object)[key_];
+            state_ = State::Value;
+            break;
+
+        case State::AfterValue:
         {
+            Frame &top = stack_.back();
+            TokenType type = current().type;
+            if (type == TokenType::Comma)
+            {
+                ++pos_;
+                if (top.object)
+                {
+                    state_ = State::Key;
+                }
+                else
+                {
+                    target_ = &top.array->emplace_back();
+                    node_ = top.node;
+                    state_ = State::Value;
+                }
+            }
+            else if ((top.object && type == TokenType::RBrace) || (top.array && type == TokenType::RBracket))
+            {
+                ++pos_;
+                stack_.pop_back();
+            }
+            else
+            {
+                return fail(top.object ? ParseErrorCode::ExpectedCommaOrBrace : ParseErrorCode::ExpectedCommaOrBracket),
+                       Progress::Failed;
+            }
             break;
         }
+        }
     }
-
-    consume(TokenType::RBracket);
-    return array;
 }
@@ -0,0 +1,87 @@
+#include "parser/ParserContext.h"
+
+using namespace json;
+
+namespace
+{
+    // Oversized input is rejected before anything is lexed.
+    std::expected<void, ParseError> checkSize(std::string_view input, const ParseLimits &limits)
+    {
+        if (input.size() <= limits.maxDocumentSize)
+            return {};
+        ParseError error{ParseErrorCode::DocumentTooLarge, limits.maxDocumentSize};
+        error.locate(input);
+        return std::unexpected(error);
+    }
+}
+
+void ParserContext::prepare(std::string_view input, const ParseLimits &limits, StringStorage storage)
+{
+    lexer_.reset(input);
+    lexer_.setStringStorage(storage);
+    parser_.reset(limits);
+    parser_.setStringStorage(storage);
+}
+
+template <unsigned Flags>
+std::expected<JsonValue, ParseError> ParserContext::run(std::string_view input, const ParseLimits &limits,
+                                                       StringStorage storage, bool anyRoot)
+{
+    if (auto size = checkSize(input, limits); !size)
+        return std::unexpected(size.error());
+    prepare(input, limits, storage);
+    lexer_.tokenise<Flags>(parser_.tokens());
+    return finish(input, anyRoot);
+}
+
+std::expected<JsonValue, ParseError> ParserContext::decode(std::string_view input, const ParseLimits &limits,
+                                                          StringStorage storage)
+{
+    return run<ParseFlags::Strict>(input, limits, storage, false);
+}
+
+std::expected<JsonValue, ParseError> ParserContext::decodeValue(std::string_view input, const ParseLimits &limits,
+                                                               StringStorage storage)
+{
+    return run<ParseFlags::Strict>(input, limits, storage, true);
+}
+
+template <unsigned Flags>
+std::expected<JsonValue, ParseError> ParserContext::decodeWith(std::string_view input, const ParseLimits &limits)
+{
+    return run<Flags>(input, limits, StringStorage::Copy, false);
+}
+
+#define JSON_INSTANTIATE_DECODE_WITH(F) \
+    template std::expected<JsonValue, ParseError> ParserContext::decodeWith<F>(std::string_view, const ParseLimits &);
+JSON_FOR_EACH_PARSE_FLAGS(JSON_INSTANTIATE_DECODE_WITH)
+#undef JSON_INSTANTIATE_DECODE_WITH
+
+std::expected<JsonValue, ParseError> ParserContext::decode(std::string_view input, const Projection &projection,
+                                                          const ParseLimits &limits)
+{
+    if (auto size = checkSize(input, limits); !size)
+        return std::unexpected(size.error());
+    prepare(input, limits, StringStorage::Copy);
+    parser_.tokens().clear();
+    parser_.setProjection(projection, lexer_);
+    return finish(input);
+}
+
+std::expected<JsonValue, ParseError> ParserContext::finish(std::string_view input, bool anyRoot)
+{
+    auto result = anyRoot ? parser_.tryParseValue() : parser_.tryParse();
+    if (!result)
+        result.error().locate(input);
+
+    std::vector<Token> &tokens = parser_.tokens();
+    if (tokens.capacity() > retainedTokens_)
+        std::vector<Token>().swap(tokens);
+    return result;
+}
+
+ParserContext &ParserContext::local()
+{
+    thread_local ParserContext context;
+    return context;
+}
@@ -1,37 +1,217 @@
 #include "parser/Lexer.h"
+#include "parser/Kernels.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 
 using namespace json;
 
+size_t Lexer::scanWhitespace(std::string_view input, size_t pos)
+{
+    // Most gaps between tokens are empty or a single byte; only longer runs
+    // (indentation) are worth a kernel call.
+    if (pos + 1 >= input.size() || !isWhitespace(input[pos]) || !isWhitespace(input[pos + 1]))
+        return pos < input.size() && isWhitespace(input[pos]) ? pos + 1 : pos;
+    return kernels::active().skipWhitespace(input.data(), input.size(), pos + 2);
+}
+
+// `pos` is the opening quote; returns the index just past the closing quote,
+// or npos when the string is unterminated. Escapes are skipped, not checked.
+size_t Lexer::scanString(std::string_view input, size_t pos)
+{
+    return scanString(input, pos, kernels::active());
+}
+
+size_t Lexer::scanString(std::string_view input, size_t pos, const Kernels &k)
+{
+    ++pos;
+    while (pos < input.size())
+    {
+        size_t hit = k.findStringSpecial(input.data(), input.size(), pos);
+        if (hit >= input.size())
+            return std::string_view::npos;
+        if (input[hit] == '"')
+            return hit + 1;
+        pos = input[hit] == '\\' ? hit + 2 : hit + 1;
+    }
+    return std::string_view::npos;
+}
+
 void Lexer::skipWhitespace()
 {
-    while (!eof() && std::isspace(static_cast<unsigned char>(peek())))
-        get();
+    pos_ = scanWhitespace(input_, pos_);
 }
 
 std::vector<Token> Lexer::tokenise()
 {
     std::vector<Token> tokens;
-    Token token(TokenType::Invalid);
-    if (input_.empty())
-        return {Token(TokenType::EndOfFile)};
+    tokenise(tokens);
+    return tokens;
+}
+
+template <unsigned Flags>
+void Lexer::tokenise(std::vector<Token> &tokens)
+{
+    static_assert((Flags & ~ParseFlags::Json5Lite) == 0, "unknown ParseFlags bit");
 
+    tokens.clear();
     while (!eof())
+    {
+        if constexpr ((Flags & ParseFlags::Comments) != 0)
+            skipWhitespaceAndComments();
+        else
+            skipWhitespace();
+        if (eof())
+            break;
+
+        if constexpr (Flags == ParseFlags::Strict)
+            tokens.push_back(nextToken());
+        else
+            tokens.push_back(nextRelaxedToken<Flags>());
+
+        // Anything after an invalid token is meaningless; stop so the parser
+        // and validator reject the input at the first bad byte.
+        if (tokens.back().type == TokenType::Invalid)
+            return;
+
+        // Drop a comma that directly precedes a closer, unless it follows
+        // the opener ("[,]" stays an error).
+        if constexpr ((Flags & ParseFlags::TrailingCommas) != 0)
+        {
+            size_t n = tokens.size();
+            TokenType type = tokens[n - 1].type;
+            if ((type == TokenType::RBrace || type == TokenType::RBracket) && n >= 3 &&
+                tokens[n - 2].type == TokenType::Comma && tokens[n - 3].type != TokenType::LBrace &&
+                tokens[n - 3].type != TokenType::LBracket)
+                tokens.erase(tokens.end() - 2);
+        }
+    }
+
+    // Marks where the input ends, so end-of-input errors have an offset.
+    tokens.emplace_back(TokenType::EndOfFile, "", input_.size());
+}
+
+// Looks for the end of the string at pos_, continuing from `pos`. Returns
+// npos once the closing quote, or a byte that makes the string invalid, is
+// in the buffer, else the offset to continue from when more arrives.
+size_t Lexer::scanPartialString(size_t pos) const
+{
+    const Kernels &k = kernels::active();
+    while (pos < input_.size())
+    {
+        size_t hit = k.findStringSpecial(input_.data(), input_.size(), pos);
+        if (hit >= input_.size())
+            return input_.size();
+        if (input_[hit] != '\\')
+            return std::string_view::npos;
+        if (hit + 1 >= input_.size())
+            return hit; // the escaped byte has not arrived yet
+        pos = hit + 2;
+    }
+    return pos;
+}
+
+size_t Lexer::tokeniseAvailable(std::vector<Token> &tokens, bool final)
+{
+    size_t added = 0;
+    if (!tokens.empty() && tokens.back().type == TokenType::Invalid)
+        return added;
+
+    while (true)
     {
         skipWhitespace();
         if (eof())
             break;
 
-        token = nextToken();
+        size_t start = pos_;
+        if (!final && peek() == '"')
+        {
+            size_t resume = scanPartialString(start + std::max<size_t>(partial_, 1));
+            if (resume != std::string_view::npos)
+            {
+                partial_ = resume - start;
+                break;
+            }
+        }
+        partial_ = 0;
+        Token token = nextToken();
 
-        if (token.type == TokenType::Invalid)
-            continue;
+        // Punctuation and closed strings are complete as soon as they are
+        // seen; numbers, literals and errors at the end may just be cut off.
+        bool complete = token.type <= TokenType::Comma || token.type == TokenType::String;
+        if (!final && !complete && eof())
+        {
+            pos_ = start;
+            break;
+        }
 
-        tokens.push_back(token);
+        tokens.push_back(std::move(token));
+        ++added;
+        if (tokens.back().type == TokenType::Invalid)
+            break;
     }
+    return added;
+}
 
-    return tokens;
+bool Lexer::next(std::vector<Token> &tokens)
+{
+    skipWhitespace();
+    if (eof())
+        return false;
+    tokens.push_back(nextToken());
+    return true;
+}
+
+bool Lexer::skipValue()
+{
+    skipWhitespace();
+    if (eof())
+        return false;
+
+    char c = peek();
+    if (c == '"')
+    {
+        size_t end = scanString(input_, pos_);
+        pos_ = end == std::string_view::npos ? input_.size() : end;
+        return end != std::string_view::npos;
+    }
+    if (c != '{' && c != '[')
+    {
+        size_t start = pos_;
+        TokenType type = nextToken().type;
+        if (type == TokenType::Number || type == TokenType::True || type == TokenType::False ||
+            type == TokenType::Null)
+            return true;
+        pos_ = start;
+        return false;
+    }
+
+    size_t depth = 0;
+    while (true)
+    {
+        size_t hit = input_.find_first_of("\"{}[]", pos_);
+        if (hit == std::string_view::npos)
+        {
+            pos_ = input_.size();
+            return false;
+        }
+
+        if (input_[hit] == '"')
+        {
+            size_t end = scanString(input_, hit);
+            pos_ = end == std::string_view::npos ? input_.size() : end;
+            if (end == std::string_view::npos)
+                return false;
+            continue;
+        }
+
+        pos_ = hit + 1;
+        if (input_[hit] == '{' || input_[hit] == '[')
+            ++depth;
+        else if (--depth == 0)
+            return true;
+    }
 }
 
 Token Lexer::nextToken()
@@ -81,102 +261,350 @@ Token Lexer::nextToken()
     }
 }
 
-Token Lexer::parseString()
+// Block comments must be closed; an unterminated one is left in place so
+// the '/' is reported as an invalid token.
+void Lexer::skipWhitespaceAndComments()
 {
-    size_t start = pos_;
-    get(); // consume opening quote
+    while (true)
+    {
+        skipWhitespace();
+        if (peek() != '/' || pos_ + 1 >= input_.size())
+            return;
+
+        if (input_[pos_ + 1] == '/')
+        {
+            size_t end = input_.find('\n', pos_ + 2);
+            pos_ = end == std::string_view::npos ? input_.size() : end + 1;
+        }
+        else if (input_[pos_ + 1] == '*')
+        {
+            size_t end = input_.find("*/", pos_ + 2);
+            if (end == std::string_view::npos)
+                return;
+            pos_ = end + 2;
+        }
+        else
+        {
+            return;
+        }
+    }
+}
 
-    std::ostringstream value;
-    bool escaped = false;
+template <unsigned Flags>
+Token Lexer::nextRelaxedToken()
+{
+    if constexpr ((Flags & ParseFlags::SingleQuotes) != 0)
+    {
+        if (peek() == '\'')
+            return parseSingleQuotedString();
+    }
 
-    while (!eof())
+    if constexpr ((Flags & ParseFlags::NonFinite) != 0)
+    {
+        // Spelled out in the token so the parser's from_chars accepts them.
+        char c = peek();
+        for (std::string_view word : {"NaN", "Infinity", "-Infinity"})
+        {
+            if (c != word.front())
+                continue;
+            if (input_.compare(pos_, word.size(), word) == 0 &&
+                !std::isalnum(static_cast<unsigned char>(pos_ + word.size() < input_.size() ? input_[pos_ + word.size()] : ' ')))
+            {
+                Token token(TokenType::Number, std::string(word), pos_);
+                pos_ += word.size();
+                return token;
+            }
+        }
+    }
+
+    return nextToken();
+}
+
+namespace
+{
+    int hexValue(char c)
     {
-        char c = get();
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
 
-        if (escaped)
+    void appendUtf8(std::string &out, uint32_t cp)
+    {
+        if (cp < 0x80)
         {
-            switch (c)
+            out.push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+}
+
+namespace
+{
+    bool parseHex4(std::string_view input, size_t &pos, uint32_t &out)
+    {
+        out = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            int digit = pos < input.size() ? hexValue(input[pos]) : -1;
+            if (digit < 0)
+                return false;
+            ++pos;
+            out = (out << 4) | static_cast<uint32_t>(digit);
+        }
+        return true;
+    }
+
+    // Decodes up to the closing `Quote`. Single-quoted strings also accept
+    // the "\'" escape. Quote == '\0' decodes already-validated raw text of
+    // either style, which has no terminator and cannot contain a NUL.
+    template <char Quote>
+    bool decodeQuoted(std::string_view input, size_t &pos, std::string *out, size_t &error)
+    {
+        auto get = [&]()
+        { return pos < input.size() ? input[pos++] : '\0'; };
+        auto put = [out](char c)
+        {
+            if (out)
+                out->push_back(c);
+        };
+
+        while (pos < input.size())
+        {
+            char c = get();
+
+            if (c == Quote)
+                return true;
+
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                error = pos - 1;
+                return false;
+            }
+
+            if (c != '\\')
+            {
+                put(c);
+                continue;
+            }
+
+            char escape = get();
+            if (Quote != '"' && escape == '\'')
+            {
+                put('\'');
+                continue;
+            }
+
+            switch (escape)
             {
             case '"':
-                value << '"';
+                put('"');
                 break;
             case '\\':
-                value << '\\';
+                put('\\');
                 break;
             case '/':
-                value << '/';
+                put('/');
                 break;
             case 'b':
-                value << '\b';
+                put('\b');
                 break;
             case 'f':
-                value << '\f';
+                put('\f');
                 break;
             case 'n':
-                value << '\n';
+                put('\n');
                 break;
             case 'r':
-                value << '\r';
+                put('\r');
                 break;
             case 't':
-                value << '\t';
+                put('\t');
                 break;
             case 'u':
-                for (int i = 0; i < 4 && !eof(); ++i)
-                    get();
-                value << '?';
+            {
+                uint32_t cp;
+                if (!parseHex4(input, pos, cp))
+                {
+                    error = pos;
+                    return false;
+                }
+
+                if (cp >= 0xD800 && cp <= 0xDBFF)
+                {
+                    uint32_t low;
+                    if (get() != '\\' || get() != 'u' || !parseHex4(input, pos, low) || low < 0xDC00 || low > 0xDFFF)
+                    {
+                        error = pos;
+                        return false;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                else if (cp >= 0xDC00 && cp <= 0xDFFF)
+                {
+                    error = pos;
+                    return false;
+                }
+                if (out)
+                    appendUtf8(*out, cp);
                 break;
+            }
             default:
-                value << c;
-                break;
+                error = pos - 1;
+                return false;
             }
-            escaped = false;
-        }
-        else if (c == '\\')
-        {
-            escaped = true;
-        }
-        else if (c == '"')
-        {
-            return Token(TokenType::String, value.str(), start);
         }
+
+        error = std::string_view::npos;
+        return false;
+    }
+}
+
+bool Lexer::decodeString(std::string_view input, size_t &pos, std::string *out, size_t &error)
+{
+    return decodeQuoted<'"'>(input, pos, out, error);
+}
+
+std::string Lexer::unescape(std::string_view raw)
+{
+    // Decoding stops at the end of `raw`, having consumed all of it.
+    std::string value;
+    size_t pos = 0;
+    size_t error;
+    decodeQuoted<'\0'>(raw, pos, &value, error);
+    return value;
+}
+
+Token Lexer::parseString()
+{
+    size_t start = pos_;
+    get(); // consume opening quote
+
+    // Fast path: no escapes, so the value is a verbatim slice of the input.
+    // String contents must be well-formed UTF-8 (RFC 8259 section 8.1).
+    const Kernels &k = kernels::active();
+    size_t end = k.findStringSpecial(input_.data(), input_.size(), pos_);
+    if (end < input_.size() && input_[end] == '"')
+    {
+        if (!k.validateUtf8(input_.data() + pos_, end - pos_))
+            return Token(TokenType::Invalid, {}, start);
+        Token token(TokenType::String, {}, start);
+        if (storage_ == StringStorage::Lazy)
+            token.raw = input_.substr(pos_, end - pos_);
         else
-        {
-            value << c;
-        }
+            token.value.assign(input_.substr(pos_, end - pos_));
+        pos_ = end + 1;
+        return token;
     }
 
-    return Token(TokenType::Invalid, value.str(), start);
+    // Slow path: decode into the reusable scratch buffer, then copy it out
+    // at its exact size. Lazy storage only validates the escapes.
+    std::string *value = storage_ == StringStorage::Lazy ? nullptr : &scratch_;
+    if (value)
+        value->assign(input_.substr(pos_, end - pos_));
+    pos_ = end;
+
+    size_t error;
+    if (!decodeString(input_, pos_, value, error))
+        return Token(TokenType::Invalid, value ? *value : std::string(), error == std::string_view::npos ? start : error);
+    // Escapes are ASCII, so the source bytes can be checked as they stand.
+    if (!k.validateUtf8(input_.data() + start + 1, pos_ - start - 2))
+        return Token(TokenType::Invalid, {}, start);
+
+    Token token(TokenType::String, value ? *value : std::string(), start);
+    if (!value)
+    {
+        token.raw = input_.substr(start + 1, pos_ - start - 2);
+        token.escaped = true;
+    }
+    return token;
+}
+
+// Relaxed-mode 'strings', decoded without the fast path.
+Token Lexer::parseSingleQuotedString()
+{
+    size_t start = pos_;
+    get(); // consume opening quote
+
+    std::string *value = storage_ == StringStorage::Lazy ? nullptr : &scratch_;
+    if (value)
+        value->clear();
+
+    size_t error;
+    if (!decodeQuoted<'\''>(input_, pos_, value, error))
+        return Token(TokenType::Invalid, value ? *value : std::string(), error == std::string_view::npos ? start : error);
+    if (!kernels::active().validateUtf8(input_.data() + start + 1, pos_ - start - 2))
+        return Token(TokenType::Invalid, {}, start);
+
+    Token token(TokenType::String, value ? *value : std::string(), start);
+    if (!value)
+    {
+        token.raw = input_.substr(start + 1, pos_ - start - 2);
+        token.escaped = token.raw.find('\\') != std::string_view::npos;
+    }
+    return token;
 }
 
 Token Lexer::parseNumber()
 {
     size_t start = pos_;
-    std::ostringstream value;
+    const Kernels &k = kernels::active();
+    auto digits = [&]()
+    {
+        size_t end = k.skipDigits(input_.data(), input_.size(), pos_);
+        bool any = end != pos_;
+        pos_ = end;
+        return any;
+    };
+    auto invalid = [&]()
+    { return Token(TokenType::Invalid, std::string(input_.substr(start, pos_ - start)), start); };
 
     if (peek() == '-')
-        value << get();
+        get();
 
-    while (std::isdigit(peek()))
-        value << get();
+    if (peek() == '0')
+        get();
+    else if (!digits())
+        return invalid();
 
     if (peek() == '.')
     {
-        value << get();
-        while (std::isdigit(peek()))
-            value << get();
+        get();
+        if (!digits())
+            return invalid();
     }
 
     if (peek() == 'e' || peek() == 'E')
     {
-        value << get();
+        get();
         if (peek() == '+' || peek() == '-')
-            value << get();
-        while (std::isdigit(peek()))
-            value << get();
+            get();
+        if (!digits())
+            return invalid();
     }
 
-    return Token(TokenType::Number, value.str(), start);
+    return Token(TokenType::Number, std::string(input_.substr(start, pos_ - start)), start);
 }
 
 Token Lexer::parseLiteral()
@@ -196,3 +624,7 @@ Token Lexer::parseLiteral()
 
     return Token(TokenType::Invalid, word, start);
 }
+
+#define JSON_INSTANTIATE_TOKENISE(F) template void Lexer::tokenise<F>(std::vector<Token> &);
+JSON_FOR_EACH_PARSE_FLAGS(JSON_INSTANTIATE_TOKENISE)
+#undef JSON_INSTANTIATE_TOKENISE
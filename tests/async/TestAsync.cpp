@@ -0,0 +1,208 @@
+#include "json/Async.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <string>
+
+using namespace json;
+
+// Serves a fixed string, at most `step` bytes per read, completing inline.
+class MemoryReader : public AsyncReader
+{
+public:
+    MemoryReader(std::string data, size_t step) : data_(std::move(data)), step_(step) {}
+
+    Task<size_t> read(std::span<char> buffer) override
+    {
+        size_t n = std::min({buffer.size(), step_, data_.size() - pos_});
+        std::memcpy(buffer.data(), data_.data() + pos_, n);
+        pos_ += n;
+        co_return n;
+    }
+
+private:
+    std::string data_;
+    size_t step_;
+    size_t pos_ = 0;
+};
+
+// Pipe stand-in: read() suspends until the test writes or closes.
+class PipeReader : public AsyncReader
+{
+public:
+    Task<size_t> read(std::span<char> buffer) override
+    {
+        co_await Wait{*this, buffer};
+        co_return delivered_;
+    }
+
+    bool waiting() const { return static_cast<bool>(reader_); }
+
+    void write(std::string_view bytes)
+    {
+        size_t n = std::min(bytes.size(), pending_.size());
+        std::memcpy(pending_.data(), bytes.data(), n);
+        delivered_ = n;
+        std::exchange(reader_, {}).resume();
+    }
+
+    void close()
+    {
+        delivered_ = 0;
+        std::exchange(reader_, {}).resume();
+    }
+
+private:
+    struct Wait
+    {
+        PipeReader &pipe;
+        std::span<char> buffer;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            pipe.reader_ = handle;
+            pipe.pending_ = buffer;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::coroutine_handle<> reader_;
+    std::span<char> pending_;
+    size_t delivered_ = 0;
+};
+
+std::expected<JsonValue, ParseError> decodeFrom(AsyncReader &reader, AsyncDecodeOptions options = {})
+{
+    auto task = asyncDecode(reader, std::move(options));
+    task.start();
+    EXPECT_TRUE(task.done());
+    return task.result();
+}
+
+TEST(AsyncDecodeTest, DecodesFromInMemoryReader)
+{
+    std::string text = R"({"name": "John", "list": [1, 2.5, true, null], "inner": {"x": "y"}})";
+    for (size_t step : {size_t(1), size_t(3), size_t(7), text.size()})
+    {
+        MemoryReader reader(text, step);
+        auto result = decodeFrom(reader);
+        ASSERT_TRUE(result.has_value()) << "step " << step << ": " << result.error().describe();
+        EXPECT_TRUE(*result == JsonValue(jsonDecode(text))) << "step " << step;
+    }
+}
+
+TEST(AsyncDecodeTest, SuspendsUntilPipeHasData)
+{
+    PipeReader pipe;
+    auto task = asyncDecode(pipe);
+    task.start();
+
+    for (std::string_view piece : {"{\"ke", "y\": [12", "34, \"va", "lue\"]", "}  "})
+    {
+        ASSERT_TRUE(pipe.waiting());
+        EXPECT_FALSE(task.done());
+        pipe.write(piece);
+    }
+    EXPECT_FALSE(task.done());
+    pipe.close();
+
+    ASSERT_TRUE(task.done());
+    auto result = task.result();
+    ASSERT_TRUE(result.has_value()) << result.error().describe();
+    auto &list = std::get<JsonValue::array_t>(std::get<JsonObject>(result->get_value())["key"].get_value());
+    ASSERT_EQ(list.size(), 2);
+    EXPECT_EQ(std::get<double>(list[0].get_value()), 1234.0);
+    EXPECT_EQ(std::get<std::string>(list[1].get_value()), "value");
+}
+
+TEST(AsyncDecodeTest, YieldsToSchedulerOnLargeInput)
+{
+    std::string text = "{\"items\": [";
+    for (int i = 0; i < 20000; ++i)
+        text += (i ? ",\"item\"" : "\"item\"");
+    text += "]}";
+
+    std::deque<std::coroutine_handle<>> queue;
+    AsyncDecodeOptions options;
+    options.chunkSize = 1024;
+    options.yieldEvery = 4096;
+    options.schedule = [&](std::coroutine_handle<> handle) { queue.push_back(handle); };
+
+    MemoryReader reader(text, text.size());
+    auto task = asyncDecode(reader, options);
+    task.start();
+
+    size_t yields = 0;
+    while (!queue.empty())
+    {
+        EXPECT_FALSE(task.done());
+        auto next = queue.front();
+        queue.pop_front();
+        ++yields;
+        next.resume();
+    }
+
+    ASSERT_TRUE(task.done());
+    EXPECT_GE(yields, text.size() / options.yieldEvery);
+    auto result = task.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(std::get<JsonValue::array_t>(std::get<JsonObject>(result->get_value())["items"].get_value()).size(), 20000);
+}
+
+TEST(AsyncDecodeTest, LongStringsInSmallChunksLexInLinearTime)
+{
+    // Rescanning the open string on every chunk would touch ~9 GB here.
+    std::string value;
+    std::string text = "{\"body\": \"";
+    while (value.size() < (8u << 20))
+    {
+        value += std::string(999, 'x') + "\\";
+        text += std::string(999, 'x') + "\\\\";
+    }
+    text += "\"}";
+
+    AsyncDecodeOptions options;
+    options.chunkSize = 4096;
+    MemoryReader reader(text, options.chunkSize);
+    auto result = decodeFrom(reader, options);
+    ASSERT_TRUE(result.has_value()) << result.error().describe();
+    EXPECT_EQ(std::get<JsonObject>(result->get_value())["body"].get_string(), value);
+}
+
+TEST(AsyncDecodeTest, ErrorsReferToWholeStream)
+{
+    MemoryReader reader("{\n  \"a\": 1,\n  \"b\" 2\n}", 2);
+    auto result = decodeFrom(reader);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::ExpectedColon);
+    EXPECT_EQ(result.error().offset, 18);
+    EXPECT_EQ(result.error().line, 3);
+    EXPECT_EQ(result.error().column, 7);
+}
+
+TEST(AsyncDecodeTest, MatchesSynchronousErrors)
+{
+    for (std::string text : {"", "[1]", "{\"a\": 1", "{\"a\": 1} x", "{\"a\": tru}", "{\"a\": \"open"})
+    {
+        MemoryReader reader(text, 1);
+        auto async = decodeFrom(reader);
+        auto sync = jsonTryDecode(text);
+        ASSERT_FALSE(async.has_value()) << text;
+        EXPECT_EQ(async.error().code, sync.error().code) << text;
+        EXPECT_EQ(async.error().offset, sync.error().offset) << text;
+    }
+}
+
+TEST(AsyncDecodeTest, EnforcesDocumentSizeWhileReading)
+{
+    AsyncDecodeOptions options;
+    options.limits.maxDocumentSize = 8;
+    MemoryReader reader("{\"key\": \"a long value\"}", 4);
+    auto result = decodeFrom(reader, options);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::DocumentTooLarge);
+}
@@ -0,0 +1,85 @@
+#include "json/DecodeCache.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace json;
+
+TEST(DecodeCacheTest, IdenticalInputsShareOneDocument)
+{
+    DecodeCache cache;
+    auto first = cache.decode("{\"a\":[1,2,3]}");
+    auto second = cache.decode(std::string("{\"a\":[1,2,3]}"));
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(first->get(), second->get());
+
+    DecodeCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.entries, 1);
+}
+
+TEST(DecodeCacheTest, ParseErrorsAreReportedAndNotCached)
+{
+    DecodeCache cache;
+    auto result = cache.decode("{\"a\":}");
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::ExpectedValue);
+    EXPECT_EQ(cache.stats().entries, 0);
+}
+
+TEST(DecodeCacheTest, EvictsLeastRecentlyUsedWithinBudget)
+{
+    DecodeCacheOptions options;
+    options.shards = 1;
+    options.maxBytes = 1024;
+    DecodeCache cache(options);
+
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 20; ++i)
+        inputs.push_back("{\"key\":" + std::to_string(i) + ",\"padding\":\"xxxxxxxxxxxxxxxx\"}");
+
+    for (const auto &input : inputs)
+        ASSERT_TRUE(cache.decode(input).has_value());
+
+    DecodeCacheStats stats = cache.stats();
+    EXPECT_LE(stats.bytes, options.maxBytes);
+    EXPECT_GT(stats.evictions, 0);
+    EXPECT_LT(stats.entries, inputs.size());
+
+    // The most recent input is still cached, the oldest is not.
+    cache.decode(inputs.back());
+    EXPECT_EQ(cache.stats().hits, 1);
+    cache.decode(inputs.front());
+    EXPECT_EQ(cache.stats().hits, 1);
+}
+
+TEST(DecodeCacheTest, ConcurrentDecodesAgree)
+{
+    DecodeCache cache;
+    const std::string input = "{\"shared\":{\"values\":[1,2,3,4],\"name\":\"doc\"}}";
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failures{0};
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < 200; ++i)
+            {
+                auto doc = cache.decode(input);
+                if (!doc || !std::get<JsonObject>((*doc)->get_value()).contains("shared"))
+                    ++failures;
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    DecodeCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 1600);
+    EXPECT_EQ(stats.entries, 1);
+}
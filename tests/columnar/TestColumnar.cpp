@@ -0,0 +1,150 @@
+#include "json/Columnar.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace json;
+
+const char *sampleRecords = R"({"id": 1, "name": "ann", "score": 9.5, "ok": true, "extra": {"deep": [1, "}"]}}
+{"id": 2, "score": 7, "ok": false, "name": "böb"}
+{"name": null, "id": 3, "tags": ["x"], "ok": true}
+{}
+)";
+
+TEST(ColumnarTest, InfersSchemaInFirstSeenOrder)
+{
+    auto schema = inferColumns(sampleRecords);
+    ASSERT_TRUE(schema.has_value()) << schema.error().describe();
+    ASSERT_EQ(schema->size(), 6);
+
+    std::vector<std::pair<std::string, ColumnType>> expected = {
+        {"id", ColumnType::Int64},
+        {"name", ColumnType::String},
+        {"score", ColumnType::Float64},
+        {"ok", ColumnType::Boolean},
+        {"extra", ColumnType::String},
+        {"tags", ColumnType::String}};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ((*schema)[i].name, expected[i].first);
+        EXPECT_EQ((*schema)[i].type, expected[i].second) << expected[i].first;
+    }
+}
+
+TEST(ColumnarTest, ShredsIntoArrowLayout)
+{
+    ColumnSchema schema = {{"id", ColumnType::Int64},
+                           {"name", ColumnType::String},
+                           {"score", ColumnType::Float64},
+                           {"ok", ColumnType::Boolean},
+                           {"extra", ColumnType::String}};
+    auto batch = shredRecords(sampleRecords, schema);
+    ASSERT_TRUE(batch.has_value()) << batch.error().describe();
+    EXPECT_EQ(batch->rows, 4);
+
+    const Column *id = batch->column("id");
+    ASSERT_NE(id, nullptr);
+    EXPECT_EQ(id->length(), 4);
+    EXPECT_EQ(id->nullCount(), 1);
+    EXPECT_EQ(std::vector<int64_t>(id->int64Values().begin(), id->int64Values().end()),
+              (std::vector<int64_t>{1, 2, 3, 0}));
+    ASSERT_EQ(id->validity().size(), 1);
+    EXPECT_EQ(id->validity()[0], 0b0111);
+
+    const Column *name = batch->column("name");
+    EXPECT_EQ(name->string(0), "ann");
+    EXPECT_EQ(name->string(1), "b\xC3\xB6"
+                               "b");
+    EXPECT_FALSE(name->isValid(2));
+    EXPECT_EQ(std::vector<int32_t>(name->offsets().begin(), name->offsets().end()),
+              (std::vector<int32_t>{0, 3, 7, 7, 7}));
+    EXPECT_EQ(name->data(), "ann"
+                            "b\xC3\xB6"
+                            "b");
+
+    const Column *score = batch->column("score");
+    EXPECT_EQ(score->float64(0), 9.5);
+    EXPECT_EQ(score->float64(1), 7.0);
+    EXPECT_EQ(score->nullCount(), 2);
+
+    const Column *ok = batch->column("ok");
+    EXPECT_EQ(ok->booleanValues()[0], 0b0101);
+    EXPECT_EQ(ok->nullCount(), 1);
+
+    // Nested values in String columns keep their JSON text.
+    EXPECT_EQ(batch->column("extra")->string(0), R"({"deep": [1, "}"]})");
+    EXPECT_EQ(batch->column("tags"), nullptr);
+}
+
+TEST(ColumnarTest, MismatchedValuesBecomeNull)
+{
+    ColumnSchema schema = {{"n", ColumnType::Int64}, {"s", ColumnType::String}};
+    auto batch = shredRecords("{\"n\": \"seven\", \"s\": 7}\n{\"n\": 2.0, \"n\": 3, \"s\": false}\n{\"n\": 2.5}", schema);
+    ASSERT_TRUE(batch.has_value());
+
+    const Column *n = batch->column("n");
+    EXPECT_FALSE(n->isValid(0));
+    EXPECT_EQ(n->int64(1), 2); // first occurrence of a duplicate key wins
+    EXPECT_FALSE(n->isValid(2));
+
+    const Column *s = batch->column("s");
+    EXPECT_EQ(s->string(0), "7");
+    EXPECT_EQ(s->string(1), "false");
+}
+
+TEST(ColumnarTest, OutOfRangeFloatsBecomeNull)
+{
+    ColumnSchema schema = {{"x", ColumnType::Float64}};
+    auto batch = shredRecords("{\"x\": 1e999}\n{\"x\": -1e999}\n{\"x\": 1.5}\n", schema);
+    ASSERT_TRUE(batch.has_value()) << batch.error().describe();
+
+    const Column *x = batch->column("x");
+    EXPECT_FALSE(x->isValid(0));
+    EXPECT_FALSE(x->isValid(1));
+    EXPECT_EQ(x->float64(0), 0.0);
+    EXPECT_EQ(x->float64(2), 1.5);
+    EXPECT_EQ(x->nullCount(), 2);
+}
+
+TEST(ColumnarTest, ParallelMatchesSerial)
+{
+    std::string input;
+    for (int i = 0; i < 5000; ++i)
+        input += "{\"i\": " + std::to_string(i) + ", \"s\": \"row " + std::to_string(i) + "\", \"skip\": [1, {\"a\": 2}]}\n";
+    ColumnSchema schema = {{"i", ColumnType::Int64}, {"s", ColumnType::String}};
+
+    auto batches = shredRecordsParallel(input, schema, 4);
+    ASSERT_TRUE(batches.has_value());
+    EXPECT_GE(batches->size(), 2);
+
+    int64_t expected = 0;
+    for (const RecordBatch &batch : *batches)
+    {
+        const Column *i = batch.column("i");
+        const Column *s = batch.column("s");
+        for (size_t row = 0; row < batch.rows; ++row, ++expected)
+        {
+            ASSERT_EQ(i->int64(row), expected);
+            ASSERT_EQ(s->string(row), "row " + std::to_string(expected));
+        }
+    }
+    EXPECT_EQ(expected, 5000);
+}
+
+TEST(ColumnarTest, ReportsErrorsAgainstWholeInput)
+{
+    std::string input;
+    for (int i = 0; i < 100; ++i)
+        input += "{\"i\": 1}\n";
+    input += "{\"i\" 1}\n";
+
+    auto result = shredRecordsParallel(input, {{"i", ColumnType::Int64}}, 4);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::ExpectedColon);
+    EXPECT_EQ(result.error().line, 101);
+    EXPECT_EQ(result.error().column, 6);
+
+    EXPECT_EQ(shredRecords("[1]", {}).error().code, ParseErrorCode::UnexpectedToken);
+    EXPECT_EQ(inferColumns("{\"a\": [1, 2}").error().code, ParseErrorCode::UnexpectedEndOfInput);
+}
@@ -0,0 +1,177 @@
+#include "json/CowValue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace json;
+
+namespace
+{
+    const char *cowDocument = R"({
+        "user": {"name": "bob", "roles": ["a", "b"]},
+        "settings": {"theme": "dark", "limits": {"rate": 10}},
+        "items": [1, 2, {"id": 3}]
+    })";
+}
+
+TEST(CowValueTest, RoundTripsThroughJsonValue)
+{
+    JsonValue doc = jsonDecodeValue(cowDocument);
+    CowValue cow(doc);
+    EXPECT_TRUE(cow.is_object());
+    EXPECT_EQ(cow.size(), 3u);
+    EXPECT_EQ(cow.toJsonValue(), doc);
+    EXPECT_EQ(cow.find("settings")->find("limits")->find(Key("rate"))->value(), JsonValue(10.0));
+    EXPECT_EQ(cow.find("items")->at(2).find("id")->value(), JsonValue(3.0));
+    EXPECT_EQ(cow.find("missing"), nullptr);
+    EXPECT_EQ(cow.find("user")->find("roles")->find("x"), nullptr);
+    EXPECT_THROW(cow.find("items")->at(3), std::out_of_range);
+    EXPECT_THROW(cow.value(), std::bad_variant_access);
+
+    CowValue null;
+    EXPECT_TRUE(null.is_null());
+    EXPECT_EQ(null.toJsonValue(), JsonValue(nullptr));
+    EXPECT_TRUE(CowValue(JsonValue(nullptr)).is_null());
+}
+
+TEST(CowValueTest, CopiesShareEveryNode)
+{
+    CowValue base(jsonDecodeValue(cowDocument));
+    CowValue copy = base;
+    EXPECT_TRUE(copy.shares(base));
+    EXPECT_TRUE(copy == base);
+}
+
+TEST(CowValueTest, EditCopiesOnlyThePathToTheNode)
+{
+    CowValue base(jsonDecodeValue(cowDocument));
+    JsonValue original = base.toJsonValue();
+
+    CowValue edited = base;
+    edited["user"]["name"] = "ada";
+
+    // The snapshot is unchanged.
+    EXPECT_EQ(base.toJsonValue(), original);
+    EXPECT_EQ(edited.find("user")->find("name")->value(), JsonValue("ada"));
+
+    // Root and "user" were copied; everything off the path is shared.
+    EXPECT_FALSE(edited.shares(base));
+    EXPECT_FALSE(edited.find("user")->shares(*base.find("user")));
+    EXPECT_TRUE(edited.find("user")->find("roles")->shares(*base.find("user")->find("roles")));
+    EXPECT_TRUE(edited.find("settings")->shares(*base.find("settings")));
+    EXPECT_TRUE(edited.find("items")->shares(*base.find("items")));
+
+    // A second edit of the now-unshared path copies nothing more.
+    const CowValue *user = edited.find("user");
+    edited["user"]["age"] = 36;
+    EXPECT_EQ(edited.find("user"), user);
+    EXPECT_EQ(edited.find("user")->size(), 3u);
+    EXPECT_EQ(base.find("user")->size(), 2u);
+}
+
+TEST(CowValueTest, ArrayEditsAndErase)
+{
+    CowValue base(jsonDecodeValue(cowDocument));
+    CowValue edited = base;
+
+    edited["items"].at(2)["id"] = 4;
+    edited["items"].push_back(JsonValue(5));
+    edited["user"]["roles"].at(0) = JsonValue("admin");
+    EXPECT_EQ(edited.erase("settings"), 1u);
+    EXPECT_EQ(edited.erase("settings"), 0u);
+    EXPECT_THROW(edited["items"].at(9), std::out_of_range);
+    EXPECT_THROW(edited["user"].at(0), std::bad_variant_access);
+
+    EXPECT_EQ(edited.toJsonValue(), jsonDecodeValue(R"({
+        "user": {"name": "bob", "roles": ["admin", "b"]},
+        "items": [1, 2, {"id": 4}, 5]
+    })"));
+    EXPECT_EQ(base.toJsonValue(), jsonDecodeValue(cowDocument));
+    EXPECT_TRUE(edited.find("items")->at(0).shares(base.find("items")->at(0)));
+    EXPECT_TRUE(edited.find("user")->find("name")->shares(*base.find("user")->find("name")));
+}
+
+TEST(CowValueTest, BuildsFromScratch)
+{
+    CowValue value;
+    value["a"]["b"] = true;
+    value["list"].push_back(JsonValue(1));
+    value["list"].push_back(JsonValue("two"));
+    EXPECT_EQ(value.toJsonValue(), jsonDecodeValue(R"({"a": {"b": true}, "list": [1, "two"]})"));
+}
+
+TEST(CowValueTest, ConcurrentReadersAndWriters)
+{
+    CowValue base(jsonDecodeValue(cowDocument));
+    JsonValue expected = base.toJsonValue();
+    std::atomic<bool> mismatch{false};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back(
+            [&, t]
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    CowValue mine = base;
+                    mine["settings"]["limits"]["rate"] = t * 1000 + i;
+                    mine["user"]["roles"].push_back(JsonValue(i));
+                    if (mine.find("settings")->find("limits")->find("rate")->value() != JsonValue(t * 1000 + i) ||
+                        base.toJsonValue() != expected)
+                        mismatch = true;
+                }
+            });
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_FALSE(mismatch);
+    EXPECT_EQ(base.toJsonValue(), expected);
+}
+
+TEST(CowValueTest, HeldRefsDoNotWriteIntoLaterCopies)
+{
+    CowValue base(jsonDecodeValue(cowDocument));
+    auto user = base["user"];
+    auto roles = user["roles"];
+    CowValue snap = base;
+    user["name"] = "ada";
+    roles.at(0) = JsonValue("admin");
+
+    EXPECT_EQ(snap.toJsonValue(), jsonDecodeValue(cowDocument));
+    EXPECT_EQ(base.find("user")->toJsonValue(), jsonDecodeValue(R"({"name": "ada", "roles": ["admin", "b"]})"));
+    EXPECT_EQ(static_cast<const CowValue &>(user["name"]).value(), JsonValue("ada"));
+    EXPECT_TRUE(base.find("settings")->shares(*snap.find("settings")));
+
+    // Assigning one Ref to another copies the value, not the handle.
+    base["copy"] = base["settings"];
+    EXPECT_TRUE(base.find("copy")->shares(*base.find("settings")));
+
+    base.erase("user");
+    EXPECT_TRUE(static_cast<const CowValue &>(roles).is_null());
+}
+
+TEST(CowValueTest, PathEditsUnshareFromTheRoot)
+{
+    CowValue fresh(jsonDecodeValue(cowDocument));
+    CowValue before = fresh;
+    fresh.set("/user/name", JsonValue("ada"));
+    fresh.set("/user/roles/-", JsonValue("c"));
+    fresh.update("/settings/limits/rate", [](CowValue &rate) { rate = JsonValue(rate.value().get<double>() + 1); });
+    fresh.set("/new/nested", JsonValue(true));
+    EXPECT_EQ(before.toJsonValue(), jsonDecodeValue(cowDocument));
+    EXPECT_EQ(fresh.toJsonValue(), jsonDecodeValue(R"({
+        "user": {"name": "ada", "roles": ["a", "b", "c"]},
+        "settings": {"theme": "dark", "limits": {"rate": 11}},
+        "items": [1, 2, {"id": 3}],
+        "new": {"nested": true}
+    })"));
+    EXPECT_TRUE(fresh.find("items")->shares(*before.find("items")));
+
+    EXPECT_THROW(fresh.set("/items/3", JsonValue(0)), std::out_of_range);
+    EXPECT_THROW(fresh.set("/items/x", JsonValue(0)), std::runtime_error);
+    EXPECT_THROW(fresh.set("items", JsonValue(0)), std::runtime_error);
+}
@@ -0,0 +1,59 @@
+#include "parser/Formatter.h"
+
+#include <gtest/gtest.h>
+
+using namespace json;
+
+const char *prettyInput = "{ \"b\" : [1, 2.50, {\"k\": \"a b\\\" c\"}],\n\t\"a\": {}, \"e\": [ ], \"n\": null }";
+
+TEST(FormatterTest, MinifyPreservesOrderAndNumbers)
+{
+    EXPECT_EQ(formatter::minify(prettyInput),
+              "{\"b\":[1,2.50,{\"k\":\"a b\\\" c\"}],\"a\":{},\"e\":[],\"n\":null}");
+}
+
+TEST(FormatterTest, MinifyKeepsWhitespaceInsideStrings)
+{
+    EXPECT_EQ(formatter::minify("[ \"  spaced \\\\\" , \"x\" ]"), "[\"  spaced \\\\\",\"x\"]");
+}
+
+TEST(FormatterTest, SimdMinifyMatchesScalar)
+{
+    std::string input;
+    for (int i = 0; i < 50; ++i)
+        input += "{ \"key number " + std::to_string(i) + "\" :\t[ 1 , 2 , \"with \\\"quotes\\\" and  spaces\" ],\r\n \"x\": true }  ";
+
+    EXPECT_EQ(formatter::minify(input, formatter::MinifyMode::Simd), formatter::minify(input));
+    EXPECT_EQ(formatter::minify(prettyInput, formatter::MinifyMode::Simd), formatter::minify(prettyInput));
+}
+
+TEST(FormatterTest, Prettify)
+{
+    EXPECT_EQ(formatter::prettify(prettyInput),
+              "{\n"
+              "    \"b\": [\n"
+              "        1,\n"
+              "        2.50,\n"
+              "        {\n"
+              "            \"k\": \"a b\\\" c\"\n"
+              "        }\n"
+              "    ],\n"
+              "    \"a\": {},\n"
+              "    \"e\": [],\n"
+              "    \"n\": null\n"
+              "}");
+}
+
+TEST(FormatterTest, PrettifyWithTabs)
+{
+    formatter::PrettyOptions options;
+    options.indent = 1;
+    options.indentChar = '\t';
+    EXPECT_EQ(formatter::prettify("{\"a\":[true]}", options), "{\n\t\"a\": [\n\t\ttrue\n\t]\n}");
+}
+
+TEST(FormatterTest, PrettyThenMinifyRoundTrips)
+{
+    std::string minified = formatter::minify(prettyInput);
+    EXPECT_EQ(formatter::minify(formatter::prettify(minified)), minified);
+}
@@ -0,0 +1,75 @@
+#include "json/FrozenDocument.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace json;
+
+TEST(FrozenDocumentTest, LookupsOnTheFrozenTree)
+{
+    auto frozen = FrozenDocument::decode(R"({"service": {"port": 8080, "hosts": ["a", "b"]}})");
+    ASSERT_TRUE(frozen);
+    EXPECT_EQ(frozen->at("service").at("port"), JsonValue(8080.0));
+    EXPECT_EQ(frozen->at(Key("service")).at("hosts").at(1), JsonValue("b"));
+    EXPECT_TRUE(frozen->contains("service"));
+    EXPECT_EQ(frozen->find("other"), nullptr);
+    EXPECT_THROW(frozen->at("other"), std::out_of_range);
+
+    auto invalid = FrozenDocument::decode("{\"a\": }");
+    ASSERT_FALSE(invalid);
+    EXPECT_EQ(invalid.error().code, ParseErrorCode::ExpectedValue);
+
+    FrozenDocument scalar(JsonValue(3));
+    EXPECT_EQ(scalar.root(), JsonValue(3));
+}
+
+TEST(FrozenDocumentTest, CopiesShareTheTree)
+{
+    FrozenDocument a(jsonDecodeValue("[1, 2]"));
+    FrozenDocument b = a;
+    EXPECT_EQ(&a.root(), &b.root());
+}
+
+TEST(FrozenDocumentTest, LazyStringsAreMaterialised)
+{
+    std::string text = R"({"plain": "abc", "escaped": "tab\there", "list": ["x\ny"]})";
+    FrozenDocument frozen(*jsonTryDecodeLazy(text));
+
+    EXPECT_TRUE(std::holds_alternative<JsonValue::string_t>(frozen.at("escaped").get_value()));
+    EXPECT_TRUE(std::holds_alternative<JsonValue::string_t>(frozen.at("list").at(0).get_value()));
+    text.assign(text.size(), ' ');
+    EXPECT_EQ(frozen.at("plain").get_string(), "abc");
+    EXPECT_EQ(frozen.at("escaped").get_string(), "tab\there");
+}
+
+TEST(FrozenDocumentTest, ConcurrentReaders)
+{
+    std::string text = "{";
+    for (int i = 0; i < 256; ++i)
+        text += (i ? ",\"k" : "\"k") + std::to_string(i) + "\": \"v" + std::to_string(i) + "\\n\"";
+    text += "}";
+    FrozenDocument frozen(*jsonTryDecodeLazy(text));
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 8; ++t)
+        readers.emplace_back(
+            [&frozen, &mismatches]
+            {
+                for (int round = 0; round < 50; ++round)
+                    for (int i = 0; i < 256; ++i)
+                    {
+                        std::string key = "k" + std::to_string(i);
+                        const JsonValue *value = frozen.find(key);
+                        if (!value || value->get_string() != "v" + std::to_string(i) + "\n")
+                            ++mismatches;
+                    }
+            });
+    for (auto &reader : readers)
+        reader.join();
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(std::get<JsonObject>(frozen.root().get_value()).size(), 256u);
+}
@@ -0,0 +1,94 @@
+#include "Differential.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+using namespace json;
+
+// Random but well-formed document, with enough variety (escapes, numbers,
+// nesting, whitespace) to reach every engine's slow paths.
+std::string randomDocument(std::mt19937 &rng, int depth = 0)
+{
+    std::uniform_int_distribution<int> dice(0, 9);
+    auto ws = [&]()
+    { return std::string(dice(rng) < 7 ? 0 : dice(rng) % 3, " \n\t"[dice(rng) % 3]); };
+    auto str = [&]()
+    {
+        static const char *pieces[] = {"a", "key", "\\\"", "\\\\", "\\n", "\\u00e9", "\\ud83d\\ude00", "caf\xc3\xa9", " ", "/"};
+        std::string s = "\"";
+        for (int i = dice(rng) % 4; i > 0; --i)
+            s += pieces[dice(rng)];
+        return s + "\"";
+    };
+
+    int kind = depth == 0 ? 0 : (depth > 4 ? 2 + dice(rng) % 5 : dice(rng) % 7);
+    switch (kind)
+    {
+    case 0:
+    {
+        std::string out = "{" + ws();
+        for (int i = dice(rng) % 4; i > 0; --i)
+            out += str() + ws() + ":" + ws() + randomDocument(rng, depth + 1) + (i > 1 ? "," : "") + ws();
+        return out + "}";
+    }
+    case 1:
+    {
+        std::string out = "[" + ws();
+        for (int i = dice(rng) % 4; i > 0; --i)
+            out += randomDocument(rng, depth + 1) + ws() + (i > 1 ? "," : "") + ws();
+        return out + "]";
+    }
+    case 2:
+        return str();
+    case 3:
+    {
+        static const char *numbers[] = {"0", "-0", "7", "-12", "3.25", "1e3", "-2.5E-2", "1e308", "123456789012345678", "0.1"};
+        return numbers[dice(rng)];
+    }
+    case 4:
+        return "true";
+    case 5:
+        return "false";
+    default:
+        return "null";
+    }
+}
+
+TEST(DifferentialTest, HandwrittenCases)
+{
+    for (const char *input : {
+             "", "{}", "[]", "{\"a\":1}", "{\"a\":[1,2,{\"b\":null}]}", "{\"a\":1,}", "{\"a\" 1}", "{\"a\":1} x",
+             "{\"a\":\"\\q\"}", "{\"a\":\"\x01\"}", "{\"a\":\"\\ud800\"}", "{\"a\":01}", "{\"a\":1.}", "{\"a\":-}",
+             "{\"a\":tru}", "{\"a\":[1,2", "{\"a\":\"open", "  {  \"a\"  :  [  ]  }  ", "{\"k\":\"\\u0000\"}"})
+    {
+        EXPECT_EQ(fuzz::checkDifferential(input), "") << input;
+    }
+}
+
+TEST(DifferentialTest, RandomDocumentsAndMutations)
+{
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> dice(0, 9);
+    const std::string noise = "{}[],:\"\\ 0-1eE.tfn\x01\xff";
+
+    for (int i = 0; i < 400; ++i)
+    {
+        std::string doc = randomDocument(rng);
+        ASSERT_EQ(fuzz::checkDifferential(doc), "") << doc;
+
+        // Truncations and single-byte edits cover the error paths.
+        std::string truncated = doc.substr(0, std::uniform_int_distribution<size_t>(0, doc.size())(rng));
+        ASSERT_EQ(fuzz::checkDifferential(truncated), "") << truncated;
+
+        std::string mutated = doc;
+        size_t at = std::uniform_int_distribution<size_t>(0, mutated.size() - 1)(rng);
+        char byte = noise[std::uniform_int_distribution<size_t>(0, noise.size() - 1)(rng)];
+        if (dice(rng) < 5)
+            mutated[at] = byte;
+        else
+            mutated.insert(at, 1, byte);
+        ASSERT_EQ(fuzz::checkDifferential(mutated), "") << mutated;
+    }
+}
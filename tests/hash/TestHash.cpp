@@ -0,0 +1,114 @@
+#include "json/Hash.h"
+#include "json/Json.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace json;
+
+TEST(CanonicalEncodeTest, SortsKeysAndDropsWhitespace)
+{
+    JsonObject inner;
+    inner["z"] = 1;
+    inner["a"] = "x";
+
+    JsonObject obj;
+    obj["b"] = std::vector<JsonValue>{true, nullptr};
+    obj["a"] = inner;
+
+    EXPECT_EQ(jsonEncodeCanonical(obj), "{\"a\":{\"a\":\"x\",\"z\":1},\"b\":[true,null]}");
+}
+
+TEST(CanonicalEncodeTest, NormalisesNumbers)
+{
+    auto encode = [](double d)
+    { return jsonEncodeCanonical(JsonValue(d)); };
+
+    EXPECT_EQ(encode(0.0), "0");
+    EXPECT_EQ(encode(-0.0), "0");
+    EXPECT_EQ(encode(30.0), "30");
+    EXPECT_EQ(encode(4.5), "4.5");
+    EXPECT_EQ(encode(0.002), "0.002");
+    EXPECT_EQ(encode(0.000001), "0.000001");
+    EXPECT_EQ(encode(1e-7), "1e-7");
+    EXPECT_EQ(encode(1e21), "1e+21");
+    EXPECT_EQ(encode(123456789012345680000.0), "123456789012345680000");
+    EXPECT_EQ(encode(333333333.33333329), "333333333.3333333");
+    EXPECT_EQ(encode(-1.5e-10), "-1.5e-10");
+    EXPECT_EQ(jsonEncodeCanonical(JsonValue(int64_t(42))), "42");
+}
+
+TEST(CanonicalEncodeTest, EscapesStrings)
+{
+    EXPECT_EQ(jsonEncodeCanonical(JsonValue("a\"b\\c\n\x01/\xC3\xA9")), "\"a\\\"b\\\\c\\n\\u0001/\xC3\xA9\"");
+}
+
+TEST(CanonicalEncodeTest, SortsKeysByUtf16CodeUnits)
+{
+    JsonObject obj;
+    obj["\xEF\xBD\xA1"] = 1;         // U+FF61
+    obj["\xF0\x9F\x98\x80"] = 2;     // U+1F600, UTF-16 D83D DE00
+    obj["a"] = 3;
+
+    EXPECT_EQ(jsonEncodeCanonical(obj), "{\"a\":3,\"\xF0\x9F\x98\x80\":2,\"\xEF\xBD\xA1\":1}");
+}
+
+TEST(StructuralHashTest, IndependentOfKeyInsertionOrder)
+{
+    JsonObject first;
+    first["a"] = 1.0;
+    first["b"] = "two";
+    first["c"] = std::vector<JsonValue>{1.0, 2.0};
+
+    JsonObject second;
+    second["c"] = std::vector<JsonValue>{1.0, 2.0};
+    second["b"] = "two";
+    second["a"] = 1;
+
+    EXPECT_EQ(structuralHash(first), structuralHash(second));
+    EXPECT_EQ(structuralHash(jsonDecode("{\"x\":[1,{\"y\":null}],\"z\":true}")),
+              structuralHash(jsonDecode("{\"z\":true,\"x\":[1,{\"y\":null}]}")));
+}
+
+TEST(StructuralHashTest, LargeIntegersHashLikeEqualDoubles)
+{
+    JsonValue integer(int64_t(1) << 60);
+    JsonValue real(std::ldexp(1.0, 60));
+    ASSERT_TRUE(integer.is_number_integer());
+    EXPECT_TRUE(integer == real);
+    EXPECT_EQ(structuralHash(integer), structuralHash(real));
+
+    // 2^53 + 1 rounds to 2^53 as a double and canonicalises the same.
+    JsonValue odd((int64_t(1) << 53) + 1), even(int64_t(1) << 53);
+    EXPECT_EQ(jsonEncodeCanonical(odd), jsonEncodeCanonical(even));
+    EXPECT_EQ(structuralHash(odd), structuralHash(even));
+}
+
+TEST(StructuralHashTest, DistinguishesStructure)
+{
+    EXPECT_NE(structuralHash(jsonDecode("{\"a\":[1,2]}")), structuralHash(jsonDecode("{\"a\":[2,1]}")));
+    EXPECT_NE(structuralHash(jsonDecode("{\"a\":1,\"b\":2}")), structuralHash(jsonDecode("{\"a\":2,\"b\":1}")));
+    EXPECT_NE(structuralHash(JsonValue("1")), structuralHash(JsonValue(1)));
+    EXPECT_NE(structuralHash(JsonValue(nullptr)), structuralHash(JsonValue(false)));
+    EXPECT_NE(structuralHash(JsonValue(JsonObject{})), structuralHash(JsonValue(JsonValue::array_t{})));
+}
+
+TEST(StructuralHashTest, CacheMatchesDirectHash)
+{
+    JsonValue doc = jsonDecode("{\"a\":{\"b\":[1,2,3]},\"c\":\"d\"}");
+    HashCache cache;
+
+    EXPECT_EQ(cache.hash(doc), structuralHash(doc));
+    size_t cached = cache.size();
+    EXPECT_EQ(cache.hash(doc), structuralHash(doc));
+    EXPECT_EQ(cache.size(), cached);
+}
+
+TEST(HashBytesTest, IsConstexprAndSeeded)
+{
+    constexpr uint64_t h = hashBytes("user_id");
+    EXPECT_EQ(h, hashBytes(std::string("user_id")));
+    EXPECT_NE(hashBytes("user_id", 1), h);
+    EXPECT_NE(hashBytes("a somewhat longer key that spans blocks"), hashBytes("a somewhat longer key that spans blockz"));
+}
@@ -4,6 +4,8 @@
 #include "parser/Token.h"
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <optional>
 #include <string>
 
 using namespace json;
@@ -151,3 +153,308 @@ TEST(JsonRoundTripTest, EncodeThenDecodeSameStructure)
     EXPECT_EQ(std::get<std::string>(list[0].get_value()), "x");
     EXPECT_EQ(std::get<double>(list[1].get_value()), 5.0);
 }
+
+// ---------------------------
+// Non-throwing decode tests
+// ---------------------------
+
+TEST(JsonTryDecodeTest, ReturnsValueOnSuccess)
+{
+    auto result = jsonTryDecode("{\"a\":[1,2],\"b\":\"x\"}");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->is_object());
+    EXPECT_EQ(std::get<std::string>((*result)["b"].get_value()), "x");
+}
+
+TEST(JsonTryDecodeTest, ReportsLineAndColumn)
+{
+    auto result = jsonTryDecode("{\n  \"a\": 1,\n  \"b\": ?\n}");
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::InvalidToken);
+    EXPECT_EQ(result.error().offset, 19);
+    EXPECT_EQ(result.error().line, 3);
+    EXPECT_EQ(result.error().column, 8);
+}
+
+TEST(JsonTryDecodeTest, ReportsEndOfInputAtInputSize)
+{
+    std::string input = "{\"a\":[1,2";
+    auto result = jsonTryDecode(input);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::UnexpectedEndOfInput);
+    EXPECT_EQ(result.error().offset, input.size());
+}
+
+TEST(JsonTryDecodeTest, RejectsInsteadOfSkippingInvalidCharacters)
+{
+    EXPECT_FALSE(jsonTryDecode("{\"a\":1 # comment\n}").has_value());
+    EXPECT_FALSE(jsonTryDecode("{\"a\":[1,]}").has_value());
+    EXPECT_FALSE(jsonTryDecode("{\"a\":01}").has_value());
+    EXPECT_FALSE(jsonTryDecode("{\"a\":1}{").has_value());
+    EXPECT_FALSE(jsonTryDecode("{\"a\":\"\\q\"}").has_value());
+}
+
+TEST(JsonDecodeTest, ExceptionCarriesParseError)
+{
+    try
+    {
+        jsonDecode("{\"a\" 1}");
+        FAIL() << "expected ParseException";
+    }
+    catch (const ParseException &e)
+    {
+        EXPECT_EQ(e.error().code, ParseErrorCode::ExpectedColon);
+        EXPECT_EQ(e.error().column, 6);
+        EXPECT_NE(std::string(e.what()).find("line 1, column 6"), std::string::npos);
+    }
+}
+
+TEST(JsonTryDecodeTest, EnforcesLimits)
+{
+    ParseLimits limits;
+    limits.maxDocumentSize = 8;
+    EXPECT_EQ(jsonTryDecode("{\"key\":\"value\"}", limits).error().code, ParseErrorCode::DocumentTooLarge);
+
+    limits = ParseLimits{};
+    limits.maxStringLength = 4;
+    EXPECT_EQ(jsonTryDecode("{\"key\":\"value\"}", limits).error().code, ParseErrorCode::StringTooLong);
+    EXPECT_EQ(jsonTryDecode("{\"long key\":1}", limits).error().code, ParseErrorCode::StringTooLong);
+
+    limits = ParseLimits{};
+    limits.maxElements = 4;
+    EXPECT_TRUE(jsonTryDecode("{\"a\":[1,2]}", limits).has_value());
+    EXPECT_EQ(jsonTryDecode("{\"a\":[1,2,3]}", limits).error().code, ParseErrorCode::TooManyElements);
+
+    limits = ParseLimits{};
+    limits.maxDepth = 2;
+    EXPECT_TRUE(jsonTryDecode("{\"a\":[1]}", limits).has_value());
+    EXPECT_EQ(jsonTryDecode("{\"a\":[[1]]}", limits).error().code, ParseErrorCode::DepthLimitExceeded);
+}
+
+TEST(JsonTryDecodeTest, LazyStringsViewTheInput)
+{
+    std::string input = R"({"plain": "value", "escaped": "a\"b\u00e9", "list": ["x"]})";
+    auto result = jsonTryDecodeLazy(input);
+    ASSERT_TRUE(result.has_value());
+
+    JsonValue &plain = (*result)["plain"];
+    ASSERT_TRUE(std::holds_alternative<JsonValue::lazy_string_t>(plain.get_value()));
+    EXPECT_TRUE(plain.is_string());
+    EXPECT_EQ(plain.get_string(), "value");
+    EXPECT_GE(plain.get_string().data(), input.data());
+    EXPECT_LT(plain.get_string().data(), input.data() + input.size());
+
+    const auto &escaped = std::get<JsonValue::lazy_string_t>((*result)["escaped"].get_value());
+    EXPECT_TRUE(escaped.escaped());
+    EXPECT_EQ(escaped.raw(), "a\\\"b\\u00e9");
+    EXPECT_EQ(escaped.view(), "a\"b\xC3\xA9");
+    EXPECT_EQ(static_cast<std::string>((*result)["escaped"]), "a\"b\xC3\xA9");
+
+    // Lazy and eager decodes compare, hash and encode alike.
+    auto eager = jsonTryDecode(input);
+    EXPECT_TRUE(*result == *eager);
+    EXPECT_EQ(jsonEncodeCanonical(*result), jsonEncodeCanonical(*eager));
+}
+
+TEST(JsonTryDecodeTest, LazyDecodeReportsSameErrors)
+{
+    for (const char *input : {R"({"a": "bad\q"})", R"({"a": "open)", R"({"k\ud800": 1})"})
+    {
+        auto lazy = jsonTryDecodeLazy(input);
+        auto eager = jsonTryDecode(input);
+        ASSERT_FALSE(lazy.has_value()) << input;
+        EXPECT_EQ(lazy.error().code, eager.error().code) << input;
+        EXPECT_EQ(lazy.error().offset, eager.error().offset) << input;
+    }
+}
+
+TEST(JsonProjectionTest, KeepsOnlySelectedMembers)
+{
+    std::string input = R"({
+        "id": 7,
+        "user": {"name": "John", "email": "j@example.com", "tags": ["a", "b"]},
+        "payload": {"deep": [[1, 2], {"x": "}]"}], "text": "skip \" me"},
+        "items": [{"id": 1, "junk": [1]}, {"id": 2, "junk": {}}],
+        "flag": true
+    })";
+
+    Projection projection{"/id", "/user/name", "/items/id"};
+    JsonObject result = jsonDecode(input, projection);
+
+    EXPECT_EQ(result.size(), 3);
+    EXPECT_EQ(std::get<double>(result["id"].get_value()), 7.0);
+    auto &user = std::get<JsonObject>(result["user"].get_value());
+    EXPECT_EQ(user.size(), 1);
+    EXPECT_EQ(user["name"].get_string(), "John");
+
+    auto &items = std::get<JsonValue::array_t>(result["items"].get_value());
+    ASSERT_EQ(items.size(), 2);
+    for (auto &item : items)
+    {
+        auto &fields = std::get<JsonObject>(item.get_value());
+        EXPECT_EQ(fields.size(), 1);
+        EXPECT_TRUE(fields.contains("id"));
+    }
+    EXPECT_FALSE(result.contains("payload"));
+    EXPECT_FALSE(result.contains("flag"));
+}
+
+TEST(JsonProjectionTest, PathSelectsWholeSubtree)
+{
+    std::string input = R"({"a": {"b": {"c": 1, "d": [2]}, "e": 3}, "a~/x": 4})";
+
+    JsonObject result = jsonDecode(input, Projection{"/a/b", "/a/b/c", "/a~0~1x"});
+    JsonObject expected = jsonDecode(R"({"a": {"b": {"c": 1, "d": [2]}}, "a~/x": 4})");
+    EXPECT_TRUE(result == expected);
+
+    EXPECT_TRUE(jsonDecode(input, Projection{""}) == jsonDecode(input));
+    EXPECT_TRUE(jsonDecode(input, Projection{}).empty());
+}
+
+TEST(JsonProjectionTest, ReportsErrorsInSkippedValues)
+{
+    Projection projection{"/keep"};
+
+    auto unterminated = jsonTryDecode(R"({"skip": {"a": [1, 2}, "keep": 1)", projection);
+    ASSERT_FALSE(unterminated.has_value());
+    EXPECT_EQ(unterminated.error().code, ParseErrorCode::UnexpectedEndOfInput);
+
+    auto missing = jsonTryDecode(R"({"skip": , "keep": 1})", projection);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().code, ParseErrorCode::ExpectedValue);
+    EXPECT_EQ(missing.error().column, 10);
+
+    auto trailing = jsonTryDecode(R"({"keep": 1} [])", projection);
+    ASSERT_FALSE(trailing.has_value());
+    EXPECT_EQ(trailing.error().code, ParseErrorCode::TrailingContent);
+
+    EXPECT_THROW(Projection{"no-slash"}, std::runtime_error);
+}
+
+TEST(JsonDecodeValueTest, AcceptsAnyRoot)
+{
+    EXPECT_EQ(jsonDecodeValue("[1, \"a\", null]"), JsonValue(std::vector<JsonValue>{1.0, "a", nullptr}));
+    EXPECT_EQ(jsonDecodeValue(" \"text\" "), JsonValue("text"));
+    EXPECT_EQ(jsonDecodeValue("-2.5e1"), JsonValue(-25.0));
+    EXPECT_EQ(jsonDecodeValue("true"), JsonValue(true));
+    EXPECT_EQ(jsonDecodeValue("null"), JsonValue(nullptr));
+    EXPECT_EQ(jsonDecodeValue("{\"a\": {}}"), JsonValue(jsonDecode("{\"a\": {}}")));
+
+    // jsonDecode keeps requiring an object.
+    EXPECT_THROW(jsonDecode("[1]"), ParseException);
+}
+
+TEST(JsonDecodeValueTest, ReportsErrors)
+{
+    auto trailing = jsonTryDecodeValue("1 2");
+    ASSERT_FALSE(trailing);
+    EXPECT_EQ(trailing.error().code, ParseErrorCode::TrailingContent);
+    EXPECT_EQ(trailing.error().offset, 2u);
+
+    for (const char *input : {"", "   "})
+    {
+        auto empty = jsonTryDecodeValue(input);
+        ASSERT_FALSE(empty);
+        EXPECT_EQ(empty.error().code, ParseErrorCode::UnexpectedEndOfInput);
+    }
+
+    EXPECT_THROW(jsonDecodeValue("[1,"), ParseException);
+}
+
+TEST(JsonValueConstLookupTest, NeverInserts)
+{
+    const JsonValue doc = jsonDecodeValue(R"({"a": {"b": [10, 20]}, "n": null})");
+
+    ASSERT_NE(doc.find("a"), nullptr);
+    EXPECT_EQ(doc.find("missing"), nullptr);
+    EXPECT_TRUE(doc.contains("n"));
+    EXPECT_TRUE(doc.contains(Key("a")));
+    EXPECT_FALSE(doc.contains("b"));
+    EXPECT_EQ(doc.at("a").at(Key("b")).at(1), JsonValue(20.0));
+    EXPECT_EQ(doc.at("n"), JsonValue(nullptr));
+
+    EXPECT_THROW(doc.at("missing"), std::out_of_range);
+    EXPECT_THROW(doc.at("a").at("b").at(2), std::out_of_range);
+    EXPECT_THROW(doc.at(0), std::out_of_range);
+    EXPECT_EQ(doc.at("n").find("x"), nullptr);
+
+    EXPECT_EQ(std::get<JsonObject>(doc.get_value()).size(), 2u);
+}
+
+TEST(JsonValueTypedAccessTest, TryGetPointsAtStoredValues)
+{
+    JsonValue text("hello");
+    const std::string *s = text.try_get<std::string>();
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s, &std::get<std::string>(text.get_value()));
+    EXPECT_EQ(text.try_get<JsonValue::array_t>(), nullptr);
+    EXPECT_EQ(*text.try_get<std::string_view>(), "hello");
+    EXPECT_FALSE(text.try_get<double>());
+    EXPECT_FALSE(text.try_get<bool>());
+
+    JsonValue doc = jsonDecodeValue(R"({"list": [1, 2], "flag": false})");
+    EXPECT_EQ(doc.try_get<JsonObject>()->size(), 2u);
+    EXPECT_EQ(doc.at("list").get<JsonValue::array_t>().size(), 2u);
+    EXPECT_EQ(doc.at("flag").try_get<bool>(), std::optional<bool>(false));
+    EXPECT_FALSE(doc.at("flag").try_get<int>());
+}
+
+TEST(JsonValueTypedAccessTest, NumbersConvertWithoutThrowing)
+{
+    JsonValue integer(int64_t(42));
+    JsonValue whole(42.0);
+    JsonValue fraction(2.5);
+    JsonValue big(1e20);
+    JsonValue negative(-1);
+
+    EXPECT_EQ(integer.try_get<double>(), 42.0);
+    EXPECT_EQ(whole.try_get<int64_t>(), 42);
+    EXPECT_EQ(whole.try_get<int>(), 42);
+    EXPECT_EQ(whole.get<uint8_t>(), 42);
+    EXPECT_FALSE(fraction.try_get<int>());
+    EXPECT_EQ(fraction.get<float>(), 2.5f);
+    EXPECT_FALSE(big.try_get<int64_t>());
+    EXPECT_FALSE(negative.try_get<unsigned>());
+    EXPECT_FALSE(JsonValue(300).try_get<uint8_t>());
+    EXPECT_FALSE(JsonValue(std::nan("")).try_get<int>());
+    EXPECT_FALSE(JsonValue(nullptr).try_get<double>());
+
+    // Parsed numbers are doubles; integral ones still read as integers.
+    JsonValue parsed = jsonDecodeValue(R"({"port": 8080, "ratio": 0.75})");
+    EXPECT_EQ(parsed.at("port").get<int>(), 8080);
+    EXPECT_EQ(parsed.at("port").get_or<uint16_t>(0), 8080);
+    EXPECT_EQ(parsed.at("ratio").get_or<int>(-1), -1);
+}
+
+TEST(JsonValueTypedAccessTest, GetThrowsGetOrFallsBack)
+{
+    JsonValue value("text");
+    EXPECT_THROW(value.get<int>(), std::bad_variant_access);
+    EXPECT_THROW(value.get<JsonObject>(), std::bad_variant_access);
+    EXPECT_EQ(value.get<std::string_view>(), "text");
+    EXPECT_EQ(&value.get<std::string>(), value.try_get<std::string>());
+
+    EXPECT_EQ(value.get_or<int>(7), 7);
+    EXPECT_EQ(value.get_or<bool>(true), true);
+    EXPECT_EQ(value.get_or<std::string>("none"), "text");
+    EXPECT_EQ(JsonValue(1).get_or<std::string_view>("none"), "none");
+}
+
+TEST(JsonValueTypedAccessTest, LazyStringsResolve)
+{
+    std::string text = R"({"a": "x\ty", "b": "plain"})";
+    auto doc = jsonTryDecodeLazy(text);
+    ASSERT_TRUE(doc);
+    EXPECT_EQ(doc->at("a").get<std::string_view>(), "x\ty");
+    EXPECT_EQ(doc->at("a").get<std::string>(), "x\ty");
+
+    // Views of unescaped strings point into the input; std::string access
+    // makes one copy and keeps returning it.
+    const JsonValue &plain = doc->at("b");
+    EXPECT_EQ(plain.get<std::string_view>().data(), text.data() + text.find("plain"));
+    const std::string *s = plain.try_get<std::string>();
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(*s, "plain");
+    EXPECT_EQ(&plain.get<std::string>(), s);
+    EXPECT_EQ(plain.get_or<std::string>(""), "plain");
+}
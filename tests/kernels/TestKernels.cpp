@@ -0,0 +1,128 @@
+#include "parser/Kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+std::vector<Isa> supportedIsas()
+{
+    std::vector<Isa> isas;
+    for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+        if (kernels::supported(isa))
+            isas.push_back(isa);
+    return isas;
+}
+
+// Random text biased towards the bytes the kernels look for.
+std::string randomText(std::mt19937 &rng, size_t size)
+{
+    static const std::string alphabet = "   \t\n\r\"\\0123456789abcXYZ{}[],:\x01\x1f\x7f\x80\xc3\xa9";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> run(0, 3);
+    std::string text;
+    while (text.size() < size)
+    {
+        // Long runs of one byte class exercise the full-width loops.
+        char c = alphabet[pick(rng)];
+        text.append(run(rng) == 0 ? 40 : 1, c);
+    }
+    text.resize(size);
+    return text;
+}
+
+TEST(KernelsTest, ScalarIsAlwaysSupported)
+{
+    EXPECT_TRUE(kernels::supported(Isa::Scalar));
+    EXPECT_TRUE(kernels::supported(kernels::best()));
+    EXPECT_EQ(kernels::forIsa(Isa::Scalar)->isa, Isa::Scalar);
+}
+
+TEST(KernelsTest, ParsesIsaNames)
+{
+    for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+        EXPECT_EQ(kernels::parseIsa(toString(isa)), isa);
+    EXPECT_FALSE(kernels::parseIsa("neon").has_value());
+}
+
+TEST(KernelsTest, EverySupportedVariantMatchesScalar)
+{
+    const Kernels &scalar = *kernels::forIsa(Isa::Scalar);
+    std::mt19937 rng(42);
+
+    for (Isa isa : supportedIsas())
+    {
+        const Kernels &k = *kernels::forIsa(isa);
+        EXPECT_EQ(k.isa, isa);
+        for (size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200, 1000})
+        {
+            std::string text = randomText(rng, size);
+            const char *data = text.data();
+            for (size_t pos = 0; pos <= size; pos += 1 + pos / 4)
+            {
+                SCOPED_TRACE(testing::Message() << isa << " size " << size << " pos " << pos);
+                EXPECT_EQ(k.skipWhitespace(data, size, pos), scalar.skipWhitespace(data, size, pos));
+                EXPECT_EQ(k.findStringSpecial(data, size, pos), scalar.findStringSpecial(data, size, pos));
+                EXPECT_EQ(k.findWhitespaceOrQuote(data, size, pos), scalar.findWhitespaceOrQuote(data, size, pos));
+                EXPECT_EQ(k.skipDigits(data, size, pos), scalar.skipDigits(data, size, pos));
+            }
+            EXPECT_EQ(k.validateUtf8(data, size), scalar.validateUtf8(data, size)) << isa << " size " << size;
+        }
+
+        // Uniform runs longer than any vector width.
+        std::string spaces(150, ' ');
+        std::string digits(150, '7');
+        std::string plain(150, 'a');
+        EXPECT_EQ(k.skipWhitespace(spaces.data(), spaces.size(), 0), 150) << isa;
+        EXPECT_EQ(k.skipDigits(digits.data(), digits.size(), 3), 150) << isa;
+        EXPECT_EQ(k.findStringSpecial(plain.data(), plain.size(), 0), 150) << isa;
+        EXPECT_EQ(k.findWhitespaceOrQuote(plain.data(), plain.size(), 0), 150) << isa;
+    }
+}
+
+TEST(KernelsTest, ValidatesUtf8OnEveryVariant)
+{
+    std::string ascii(100, 'x');
+    std::vector<std::pair<std::string, bool>> cases = {
+        {ascii + "\xC3\xA9" + ascii, true},
+        {ascii + "\xF0\x9F\x98\x80" + ascii, true},
+        {ascii.substr(0, 62) + "\xE2\x82\xAC" + ascii, true}, // straddles a 64-byte block
+        {ascii + "\xC0\xAF", false},                         // overlong
+        {ascii + "\xED\xA0\x80", false},                     // surrogate
+        {ascii + "\xF4\x90\x80\x80", false},                 // above U+10FFFF
+        {ascii + "\xE2\x82", false},                         // truncated
+        {"\x80" + ascii, false},                             // stray continuation
+    };
+
+    for (Isa isa : supportedIsas())
+        for (const auto &[text, valid] : cases)
+            EXPECT_EQ(kernels::forIsa(isa)->validateUtf8(text.data(), text.size()), valid) << isa;
+}
+
+TEST(KernelsTest, SelectOverridesActiveKernels)
+{
+    Isa original = kernels::active().isa;
+
+    for (Isa isa : supportedIsas())
+    {
+        ASSERT_TRUE(kernels::select(isa));
+        EXPECT_EQ(kernels::active().isa, isa);
+        EXPECT_EQ(kernels::active().findStringSpecial("ab\"c", 4, 0), 2u);
+        EXPECT_TRUE(isValidUtf8("caf\xC3\xA9"));
+        EXPECT_FALSE(isValidUtf8("caf\xC3"));
+    }
+
+    for (Isa isa : {Isa::Sse42, Isa::Avx2, Isa::Avx512})
+    {
+        if (!kernels::supported(isa))
+        {
+            EXPECT_FALSE(kernels::select(isa));
+        }
+    }
+
+    kernels::select(original);
+    EXPECT_EQ(kernels::active().isa, original);
+}
@@ -0,0 +1,92 @@
+#include "json/Json.h"
+#include "json/LargePages.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+TEST(LargePagesTest, SupportIsConsistent)
+{
+    const LargePageSupport &support = largePageSupport();
+    if (support.hugetlb)
+    {
+        EXPECT_GT(support.hugePageSize, 0u);
+    }
+    EXPECT_EQ(&support, &largePageSupport());
+}
+
+TEST(LargePagesTest, BufferIsWritableAndFallsBackGracefully)
+{
+    const size_t size = (size_t(3) << 20) + 123;
+    LargeBuffer buffer(size);
+    ASSERT_NE(buffer.data(), nullptr);
+    EXPECT_EQ(buffer.size(), size);
+    std::memset(buffer.data(), 'x', size);
+    EXPECT_EQ(buffer.view().back(), 'x');
+
+    // Only features the host offers can have been applied.
+    const LargePageSupport &support = largePageSupport();
+    EXPECT_TRUE(!buffer.placement().hugetlb || support.hugetlb);
+    EXPECT_TRUE(!buffer.placement().transparent || support.transparent);
+    EXPECT_TRUE(buffer.placement().node < 0 || support.numa);
+
+    LargePageOptions plain;
+    plain.hugePages = false;
+    plain.localNode = false;
+    LargeBuffer small(100, plain);
+    EXPECT_FALSE(small.placement().hugetlb);
+    EXPECT_FALSE(small.placement().transparent);
+    EXPECT_EQ(small.placement().node, -1);
+
+    LargeBuffer moved = std::move(small);
+    EXPECT_EQ(moved.size(), 100u);
+    EXPECT_EQ(small.data(), nullptr);
+    EXPECT_EQ(LargeBuffer(0).size(), 0u);
+}
+
+TEST(LargePagesTest, ReadFileFeedsTheDecoder)
+{
+    std::string path = testing::TempDir() + "large_pages_test.json";
+    std::ofstream(path) << "{\"items\": [1, 2, 3], \"name\": \"big\"}";
+
+    {
+        LargeBuffer input = LargeBuffer::readFile(path);
+        JsonObject decoded = jsonDecode(input.view());
+        EXPECT_EQ(decoded["name"], JsonValue("big"));
+    }
+    std::remove(path.c_str());
+
+    EXPECT_THROW(LargeBuffer::readFile(path), std::runtime_error);
+}
+
+TEST(LargePagesTest, ResourceMapsOnlyLargeRequests)
+{
+    LargePageOptions options;
+    options.minBytes = 1 << 20;
+    LargePageResource resource(options);
+
+    {
+        std::pmr::vector<char> small(1000, 'a', &resource);
+        EXPECT_EQ(resource.mappings(), 0u);
+
+        std::pmr::vector<char> large(options.minBytes * 2, 'b', &resource);
+        EXPECT_EQ(resource.mappings(), 1u);
+        EXPECT_EQ(large.back(), 'b');
+    }
+    EXPECT_EQ(resource.mappings(), 0u);
+
+    // As the upstream of an arena.
+    std::pmr::monotonic_buffer_resource arena(&resource);
+    std::pmr::vector<int> values(&arena);
+    for (int i = 0; i < 1000000; ++i)
+        values.push_back(i);
+    EXPECT_EQ(values[999999], 999999);
+    EXPECT_GT(resource.mappings(), 0u);
+}
@@ -32,7 +32,8 @@ TEST(TestLexer, TokeniseSimpleWords)
         TokenType::String,
         TokenType::Comma,
         TokenType::String,
-        TokenType::RBracket};
+        TokenType::RBracket,
+        TokenType::EndOfFile};
 
     std::vector<std::string> expectedValues = {"[", "hello", ",", "world", "]", ""};
 
@@ -49,7 +50,8 @@ TEST(TestLexer, TokeniseBasicObject)
         TokenType::String,
         TokenType::Colon,
         TokenType::Number,
-        TokenType::RBrace};
+        TokenType::RBrace,
+        TokenType::EndOfFile};
 
     std::vector<std::string> expectedValues = {"{", "key", ":", "123", "}", ""};
     assertTokens(tokens, expectedTypes, expectedValues);
@@ -60,8 +62,8 @@ TEST(TestLexer, TokeniseEscapedString)
     Lexer lexer("[\"Hello \\\"World\\\"\"]"); // "Hello \"World\""
     auto tokens = lexer.tokenise();
 
-    std::vector<TokenType> expectedTypes = {TokenType::LBracket, TokenType::String, TokenType::RBracket};
-    std::vector<std::string> expectedValues = {"[", "Hello \"World\"", "]"};
+    std::vector<TokenType> expectedTypes = {TokenType::LBracket, TokenType::String, TokenType::RBracket, TokenType::EndOfFile};
+    std::vector<std::string> expectedValues = {"[", "Hello \"World\"", "]", ""};
     assertTokens(tokens, expectedTypes, expectedValues);
 }
 
@@ -70,8 +72,8 @@ TEST(TestLexer, TokeniseStringWithSpaces)
     Lexer lexer("[\"Hello World\"]");
     auto tokens = lexer.tokenise();
 
-    std::vector<TokenType> expectedTypes = {TokenType::LBracket, TokenType::String, TokenType::RBracket};
-    std::vector<std::string> expectedValues = {"[", "Hello World", "]"};
+    std::vector<TokenType> expectedTypes = {TokenType::LBracket, TokenType::String, TokenType::RBracket, TokenType::EndOfFile};
+    std::vector<std::string> expectedValues = {"[", "Hello World", "]", ""};
     assertTokens(tokens, expectedTypes, expectedValues);
 }
 
@@ -99,7 +101,8 @@ TEST(TestLexer, TokeniseNestedObjectsAndArrays)
         TokenType::Comma,
         TokenType::Number,
         TokenType::RBracket,
-        TokenType::RBrace};
+        TokenType::RBrace,
+        TokenType::EndOfFile};
 
     std::vector<std::string> expectedValues = {
         "{", "outer", ":", "{", "inner", ":", "42", "}", ",",
@@ -114,7 +117,8 @@ TEST(TestLexer, TokeniseMixedContent)
     auto tokens = lexer.tokenise();
 
     EXPECT_EQ(tokens.front().type, TokenType::LBrace);
-    EXPECT_EQ(tokens.back().type, TokenType::RBrace);
+    EXPECT_EQ(tokens[tokens.size() - 2].type, TokenType::RBrace);
+    EXPECT_EQ(tokens.back().type, TokenType::EndOfFile);
 
     EXPECT_EQ(tokens[23].value, "nested");
     EXPECT_EQ(tokens[30].value, "b");
@@ -129,7 +133,8 @@ TEST(TestLexer, TokeniseNumbersAndBooleans)
         TokenType::LBracket, TokenType::Number, TokenType::Comma,
         TokenType::Number, TokenType::Comma, TokenType::Number, TokenType::Comma,
         TokenType::Number, TokenType::Comma, TokenType::True, TokenType::Comma,
-        TokenType::False, TokenType::Comma, TokenType::Null, TokenType::RBracket};
+        TokenType::False, TokenType::Comma, TokenType::Null, TokenType::RBracket,
+        TokenType::EndOfFile};
 
     std::vector<std::string> expectedValues = {
         "[", "0", ",", "-1", ",", "3.14", ",", "6.022e23", ",",
@@ -137,3 +142,94 @@ TEST(TestLexer, TokeniseNumbersAndBooleans)
 
     assertTokens(tokens, expectedTypes, expectedValues);
 }
+
+TEST(TestLexer, StopsAtInvalidToken)
+{
+    Lexer lexer("[1, @, 2]");
+    auto tokens = lexer.tokenise();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens.back().type, TokenType::Invalid);
+    EXPECT_EQ(tokens.back().position, 4);
+}
+
+TEST(TestLexer, DecodesUnicodeEscapes)
+{
+    Lexer lexer("[\"\\u00e9\\ud83d\\ude00\"]");
+    auto tokens = lexer.tokenise();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].value, "\xC3\xA9\xF0\x9F\x98\x80");
+}
+
+TEST(TestLexer, RejectsMalformedNumbers)
+{
+    for (const char *input : {"-", "1.", "1e", "-x"})
+    {
+        Lexer lexer(input);
+        auto tokens = lexer.tokenise();
+        ASSERT_FALSE(tokens.empty());
+        EXPECT_EQ(tokens.front().type, TokenType::Invalid) << input;
+    }
+}
+
+TEST(TestLexer, LazyStorageRecordsSourceSpans)
+{
+    std::string input = "[\"plain\", \"tab\\there\", \"bad\\q\"]";
+    Lexer lexer(input);
+    lexer.setStringStorage(StringStorage::Lazy);
+    auto tokens = lexer.tokenise();
+
+    ASSERT_EQ(tokens.size(), 6);
+    EXPECT_TRUE(tokens[1].value.empty());
+    EXPECT_EQ(tokens[1].raw, "plain");
+    EXPECT_EQ(tokens[1].raw.data(), input.data() + 2);
+    EXPECT_FALSE(tokens[1].escaped);
+
+    EXPECT_EQ(tokens[3].raw, "tab\\there");
+    EXPECT_TRUE(tokens[3].escaped);
+    EXPECT_EQ(Lexer::unescape(tokens[3].raw), "tab\there");
+
+    // Escapes are still validated up front.
+    EXPECT_EQ(tokens[5].type, TokenType::Invalid);
+}
+
+TEST(TestLexer, IncrementalStringsSplitAnywhere)
+{
+    std::string input = "[\"ab\\\"c\\\\\", \"\\u00e9\"]";
+    Lexer lexer{std::string_view()};
+    std::vector<Token> tokens;
+    for (size_t end = 1; end <= input.size(); ++end)
+    {
+        lexer.extend(std::string_view(input).substr(0, end));
+        lexer.tokeniseAvailable(tokens, end == input.size());
+    }
+
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_EQ(tokens[1].type, TokenType::String);
+    EXPECT_EQ(tokens[1].value, "ab\"c\\");
+    EXPECT_EQ(tokens[3].value, "\xC3\xA9");
+    EXPECT_EQ(tokens[4].type, TokenType::RBracket);
+}
+
+TEST(TestLexer, RejectsMalformedUtf8InStrings)
+{
+    for (const char *input : {"[\"caf\xC3\"]", "[\"a\\nb\xED\xA0\x80\"]", "[\"\xC0\xAF\"]"})
+    {
+        for (StringStorage storage : {StringStorage::Copy, StringStorage::Lazy})
+        {
+            Lexer lexer(input);
+            lexer.setStringStorage(storage);
+            auto tokens = lexer.tokenise();
+            ASSERT_EQ(tokens.size(), 2) << input;
+            EXPECT_EQ(tokens[1].type, TokenType::Invalid) << input;
+            EXPECT_EQ(tokens[1].position, 1) << input;
+        }
+    }
+
+    Lexer lexer("[\"caf\xC3\xA9\", \"\\t\xF0\x9F\x98\x80\"]");
+    auto tokens = lexer.tokenise();
+    ASSERT_EQ(tokens.size(), 6);
+    EXPECT_EQ(tokens[1].value, "caf\xC3\xA9");
+    EXPECT_EQ(tokens[3].value, "\t\xF0\x9F\x98\x80");
+}
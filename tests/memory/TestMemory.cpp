@@ -0,0 +1,117 @@
+#include "json/Memory.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace json;
+
+TEST(MemoryUsageTest, ScalarsOwnNothing)
+{
+    EXPECT_EQ(memory_usage(JsonValue()).total(), 0u);
+    EXPECT_EQ(memory_usage(JsonValue(1.5)).total(), 0u);
+    EXPECT_EQ(memory_usage(JsonValue(true)).total(), 0u);
+    EXPECT_EQ(memory_usage(JsonValue("short")).total(), 0u);
+}
+
+TEST(MemoryUsageTest, CountsEachComponent)
+{
+    std::string text(100, 'x');
+    EXPECT_EQ(memory_usage(JsonValue(text)).strings, text.capacity() + 1);
+
+    JsonValue::array_t elements;
+    elements.reserve(10);
+    elements.emplace_back(1);
+    elements.emplace_back(text);
+    size_t capacity = elements.capacity();
+    MemoryUsage array = memory_usage(JsonValue(std::move(elements)));
+    EXPECT_EQ(array.arrays, capacity * sizeof(JsonValue));
+    EXPECT_EQ(array.strings, text.capacity() + 1);
+
+    JsonValue object;
+    object["a"] = 1;
+    object[std::string(40, 'k')] = 2;
+    MemoryUsage members = memory_usage(object);
+    EXPECT_EQ(members.keys, 41u);
+    EXPECT_GT(members.objects, 2 * (sizeof(std::string) + sizeof(JsonValue)));
+    EXPECT_EQ(members.strings, 0u);
+    EXPECT_EQ(members.total(), members.keys + members.objects);
+}
+
+TEST(MemoryUsageTest, GrowsWithTheDocument)
+{
+    std::string small = "{\"items\": [1, 2, 3]}";
+    std::string large = "{\"items\": [";
+    for (int i = 0; i < 1000; ++i)
+        large += (i ? ",\"" : "\"") + std::string(30, 'a' + i % 26) + "\"";
+    large += "]}";
+
+    MemoryUsage a = memory_usage(jsonDecodeValue(small));
+    MemoryUsage b = memory_usage(jsonDecodeValue(large));
+    EXPECT_LT(a.total(), b.total());
+    EXPECT_GE(b.strings, 1000u * 31);
+    EXPECT_GE(b.arrays, 1000u * sizeof(JsonValue));
+}
+
+TEST(MemoryUsageTest, LazyStringsCountOnceDecoded)
+{
+    std::string text = "{\"a\": \"" + std::string(50, 'a') + "\\n\"}";
+    auto doc = jsonTryDecodeLazy(text);
+    ASSERT_TRUE(doc);
+    size_t before = memory_usage(*doc).strings;
+    EXPECT_EQ(before, 0u);
+    (void)doc->at("a").get_string();
+    EXPECT_GT(memory_usage(*doc).strings, before);
+}
+
+TEST(MemoryEstimateTest, CountsStructure)
+{
+    MemoryEstimate estimate = estimate_memory_usage(
+        R"({"a": [1, "two", {"b": null}], "c": {}, "d": [], "e": "x,y:{z}"})");
+    EXPECT_EQ(estimate.objects, 3u);
+    EXPECT_EQ(estimate.arrays, 2u);
+    EXPECT_EQ(estimate.members, 5u);
+    EXPECT_EQ(estimate.elements, 3u);
+    EXPECT_EQ(estimate.strings, 2u);
+}
+
+TEST(MemoryEstimateTest, TracksDecodedSize)
+{
+    std::string input = "{\"records\": [";
+    for (int i = 0; i < 500; ++i)
+    {
+        input += i ? "," : "";
+        input += "{\"id\": " + std::to_string(i) + ", \"name\": \"user-" + std::to_string(i) +
+                 "-with-a-long-display-name\", \"tags\": [\"a\", \"b\", \"c\"], \"active\": true}";
+    }
+    input += "], \"count\": 500}";
+
+    size_t actual = memory_usage(jsonDecodeValue(input)).total();
+    size_t predicted = estimate_memory_usage(input).bytes;
+    EXPECT_GT(predicted, actual * 9 / 10) << "actual " << actual;
+    EXPECT_LT(predicted, actual * 11 / 10) << "actual " << actual;
+}
+
+TEST(MemoryEstimateTest, BoundsDepthOnAdversarialInput)
+{
+    // Scratch memory stays at maxDepth frames however deep the input goes.
+    std::string brackets(8 << 20, '[');
+    MemoryEstimate deep = estimate_memory_usage(brackets);
+    EXPECT_EQ(deep.error, ParseErrorCode::DepthLimitExceeded);
+    EXPECT_EQ(deep.arrays, ParseLimits{}.maxDepth);
+    EXPECT_GT(deep.bytes, 0u);
+
+    EXPECT_EQ(estimate_memory_usage("[[1]]", 1).error, ParseErrorCode::DepthLimitExceeded);
+    EXPECT_EQ(estimate_memory_usage("[[1]]", 2).error, ParseErrorCode::None);
+}
+
+TEST(MemoryEstimateTest, CountsUnclosedContainers)
+{
+    MemoryEstimate open = estimate_memory_usage(R"({"a": [1, 2, "three)");
+    EXPECT_EQ(open.error, ParseErrorCode::UnexpectedEndOfInput);
+    EXPECT_EQ(open.objects, 1u);
+    EXPECT_EQ(open.arrays, 1u);
+    EXPECT_EQ(open.elements, 3u);
+    EXPECT_GT(open.bytes, 3 * sizeof(JsonValue));
+    EXPECT_EQ(estimate_memory_usage(R"({"a": [1]})").error, ParseErrorCode::None);
+}
@@ -0,0 +1,122 @@
+#include "json/Json.h"
+#include "parser/Lexer.h"
+#include "parser/ParserContext.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace json;
+
+namespace
+{
+    ParseErrorCode strictError(std::string_view input)
+    {
+        auto result = jsonTryDecode(input);
+        return result ? ParseErrorCode::None : result.error().code;
+    }
+}
+
+TEST(ParseFlagsTest, StrictRejectsEveryExtension)
+{
+    EXPECT_EQ(strictError("{\"a\": 1 // note\n}"), ParseErrorCode::InvalidToken);
+    EXPECT_EQ(strictError("{\"a\": 1 /* note */}"), ParseErrorCode::InvalidToken);
+    EXPECT_EQ(strictError("{\"a\": [1, 2,]}"), ParseErrorCode::ExpectedValue);
+    EXPECT_EQ(strictError("{\"a\": 1,}"), ParseErrorCode::ExpectedKey);
+    EXPECT_EQ(strictError("{\"a\": NaN}"), ParseErrorCode::InvalidToken);
+    EXPECT_EQ(strictError("{\"a\": -Infinity}"), ParseErrorCode::InvalidToken);
+    EXPECT_EQ(strictError("{'a': 1}"), ParseErrorCode::InvalidToken);
+
+    auto strict = jsonTryDecodeWith<ParseFlags::Strict>("{\"a\": [1, 2,]}");
+    ASSERT_FALSE(strict);
+    EXPECT_EQ(strict.error().code, ParseErrorCode::ExpectedValue);
+}
+
+TEST(ParseFlagsTest, Comments)
+{
+    auto result = jsonTryDecodeWith<ParseFlags::Comments>(R"(// leading
+        {
+            "a": 1, // trailing
+            /* block
+               comment */ "b": "// not a comment /* either */"
+        } /* done */)");
+    ASSERT_TRUE(result) << result.error().describe();
+    EXPECT_EQ((*result)["a"], JsonValue(1.0));
+    EXPECT_EQ((*result)["b"], JsonValue("// not a comment /* either */"));
+
+    auto unterminated = jsonTryDecodeWith<ParseFlags::Comments>("{\"a\": 1 /* open");
+    ASSERT_FALSE(unterminated);
+    EXPECT_EQ(unterminated.error().code, ParseErrorCode::InvalidToken);
+    EXPECT_EQ(unterminated.error().offset, 8u);
+
+    // Only comments are enabled.
+    EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::Comments>("{\"a\": [1,]}"));
+}
+
+TEST(ParseFlagsTest, TrailingCommas)
+{
+    auto result = jsonTryDecodeWith<ParseFlags::TrailingCommas>(R"({"a": [1, 2,], "b": {"c": null,},})");
+    ASSERT_TRUE(result) << result.error().describe();
+    EXPECT_EQ(*result, *jsonTryDecode(R"({"a": [1, 2], "b": {"c": null}})"));
+
+    for (const char *input : {"{\"a\": [,]}", "{,}", "{\"a\": [1,,]}", "{\"a\": 1,,}"})
+        EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::TrailingCommas>(input)) << input;
+}
+
+TEST(ParseFlagsTest, NonFiniteNumbers)
+{
+    auto result = jsonTryDecodeWith<ParseFlags::NonFinite>(R"({"n": NaN, "p": Infinity, "m": -Infinity, "x": -1})");
+    ASSERT_TRUE(result) << result.error().describe();
+    EXPECT_TRUE(std::isnan(static_cast<double>((*result)["n"])));
+    EXPECT_EQ(static_cast<double>((*result)["p"]), INFINITY);
+    EXPECT_EQ(static_cast<double>((*result)["m"]), -INFINITY);
+    EXPECT_EQ(static_cast<double>((*result)["x"]), -1.0);
+
+    EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::NonFinite>(R"({"n": NaNa})"));
+    EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::NonFinite>(R"({"n": nan})"));
+}
+
+TEST(ParseFlagsTest, SingleQuotes)
+{
+    auto result = jsonTryDecodeWith<ParseFlags::SingleQuotes>(R"({'key': 'it\'s "quoted"\n', "mixed": 'aé'})");
+    ASSERT_TRUE(result) << result.error().describe();
+    EXPECT_EQ((*result)["key"], JsonValue("it's \"quoted\"\n"));
+    EXPECT_EQ((*result)["mixed"], JsonValue("a\xC3\xA9"));
+
+    // "\'" is not an escape in double-quoted strings, even in relaxed mode.
+    EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::SingleQuotes>(R"({"a": "it\'s"})"));
+    EXPECT_FALSE(jsonTryDecodeWith<ParseFlags::SingleQuotes>("{'open: 1}"));
+}
+
+TEST(ParseFlagsTest, Json5LiteConfigFile)
+{
+    JsonObject config = jsonDecodeWith<ParseFlags::Json5Lite>(R"(
+        // service configuration
+        {
+            'name': 'api',
+            "ports": [8080, 8443,],   /* public */
+            "ratio": NaN,
+        }
+    )");
+    EXPECT_EQ(config["name"], JsonValue("api"));
+    EXPECT_EQ(config["ports"], JsonValue(std::vector<JsonValue>{8080.0, 8443.0}));
+    EXPECT_TRUE(std::isnan(static_cast<double>(config["ratio"])));
+
+    EXPECT_THROW(jsonDecodeWith<ParseFlags::Json5Lite>("{'a': }"), ParseException);
+}
+
+TEST(ParseFlagsTest, ContextDecodeWithReusesBuffers)
+{
+    ParserContext context;
+    ASSERT_TRUE(context.decodeWith<ParseFlags::Json5Lite>("{'a': [1, 2, 3,]}"));
+    auto strict = context.decodeWith<ParseFlags::Strict>("{\"a\": [1, 2, 3]}");
+    ASSERT_TRUE(strict);
+    EXPECT_EQ(*strict, *context.decode("{\"a\": [1, 2, 3]}"));
+}
+
+TEST(ParseFlagsTest, LazyStringsWithApostrophesStillDecode)
+{
+    auto result = jsonTryDecodeLazy(R"({"a": "it's\tfine"})");
+    ASSERT_TRUE(result);
+    EXPECT_EQ((*result)["a"].get_string(), "it's\tfine");
+}
@@ -131,3 +131,64 @@ TEST(ParserTest, ThrowsOnUnclosedObject)
     Parser parser(tokens);
     EXPECT_THROW(parser.parse(), std::runtime_error);
 }
+
+TEST(ParserTest, TryParseReportsTokenPosition)
+{
+    std::vector<Token> tokens = {
+        Token(TokenType::LBrace, "{", 0),
+        Token(TokenType::String, "key", 1),
+        Token(TokenType::Number, "1", 7)};
+    Parser parser(tokens);
+    auto result = parser.tryParse();
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::ExpectedColon);
+    EXPECT_EQ(result.error().offset, 7);
+}
+
+TEST(ParserTest, EndOfInputOffsetIsTheInputSize)
+{
+    // The escaped string decodes shorter than its source text.
+    std::string input = "{\"key\": \"a\\\"b\"  ";
+    Lexer lexer(input);
+    auto result = Parser(lexer.tokenise()).tryParse();
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::UnexpectedEndOfInput);
+    EXPECT_EQ(result.error().offset, input.size());
+}
+
+TEST(ParserTest, ThrowsOnTrailingTokens)
+{
+    std::vector<Token> tokens = {T(TokenType::LBrace), T(TokenType::RBrace), T(TokenType::LBrace)};
+    Parser parser(tokens);
+    EXPECT_THROW(parser.parse(), ParseException);
+}
+
+TEST(ParserTest, DeepNestingFailsWithDepthLimit)
+{
+    std::vector<Token> tokens = {T(TokenType::LBrace), T(TokenType::String, "a"), T(TokenType::Colon)};
+    for (int i = 0; i < 100000; ++i)
+        tokens.push_back(T(TokenType::LBracket));
+
+    Parser parser(tokens);
+    auto result = parser.tryParse();
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, ParseErrorCode::DepthLimitExceeded);
+}
+
+TEST(ParserTest, DeepNestingWithinLimitParsesIteratively)
+{
+    const int depth = 5000;
+    std::vector<Token> tokens = {T(TokenType::LBrace), T(TokenType::String, "a"), T(TokenType::Colon)};
+    for (int i = 0; i < depth; ++i)
+        tokens.push_back(T(TokenType::LBracket));
+    for (int i = 0; i < depth; ++i)
+        tokens.push_back(T(TokenType::RBracket));
+    tokens.push_back(T(TokenType::RBrace));
+
+    ParseLimits limits;
+    limits.maxDepth = depth + 1;
+    Parser parser(tokens, limits);
+    EXPECT_TRUE(parser.tryParse().has_value());
+}
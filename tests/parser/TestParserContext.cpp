@@ -0,0 +1,82 @@
+#include "parser/ParserContext.h"
+
+#include <gtest/gtest.h>
+
+using namespace json;
+
+std::string makeMessage(int seed)
+{
+    std::string message = "{\"id\":" + std::to_string(seed) + ",\"items\":[";
+    for (int i = 0; i < 64; ++i)
+        message += (i ? "," : "") + std::string("{\"name\":\"item\\t") + std::to_string(i) + "\",\"v\":[1,2,3]}";
+    return message + "]}";
+}
+
+TEST(ParserContextTest, DecodesLikeJsonTryDecode)
+{
+    ParserContext context;
+    auto result = context.decode(makeMessage(1));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, *jsonTryDecode(makeMessage(1)));
+}
+
+TEST(ParserContextTest, BuffersAreReusedAcrossCalls)
+{
+    ParserContext context;
+    ASSERT_TRUE(context.decode(makeMessage(1)).has_value());
+    size_t tokens = context.tokenCapacity();
+    size_t stack = context.stackCapacity();
+    EXPECT_GT(tokens, 0);
+
+    for (int i = 2; i < 20; ++i)
+        ASSERT_TRUE(context.decode(makeMessage(i)).has_value());
+
+    EXPECT_EQ(context.tokenCapacity(), tokens);
+    EXPECT_EQ(context.stackCapacity(), stack);
+}
+
+TEST(ParserContextTest, RecoversAfterErrors)
+{
+    ParserContext context;
+    auto bad = context.decode("{\"a\":\n[1,,2]}");
+    ASSERT_FALSE(bad.has_value());
+    EXPECT_EQ(bad.error().line, 2);
+    EXPECT_EQ(bad.error().column, 4);
+
+    auto good = context.decode("{\"a\":[1,2]}");
+    ASSERT_TRUE(good.has_value());
+    EXPECT_TRUE((*good)["a"].is_array());
+}
+
+TEST(ParserContextTest, ReleasesOversizedBuffers)
+{
+    ParserContext context(16);
+    ASSERT_TRUE(context.decode(makeMessage(1)).has_value());
+    EXPECT_EQ(context.tokenCapacity(), 0);
+}
+
+TEST(ParserContextTest, AnyRootDecodingSupportsLazyStrings)
+{
+    ParserContext context;
+    std::string input = R"(["plain", "tab\there"])";
+    auto result = context.decodeValue(input, {}, StringStorage::Lazy);
+    ASSERT_TRUE(result.has_value());
+    const JsonValue &plain = result->at(0);
+    EXPECT_TRUE(plain.is_string());
+    EXPECT_EQ(plain.get<std::string_view>().data(), input.data() + 2);
+    EXPECT_EQ(result->at(1).get<std::string_view>(), "tab\there");
+}
+
+TEST(ParserContextTest, EveryEntryPointChecksDocumentSize)
+{
+    ParserContext context;
+    ParseLimits limits;
+    limits.maxDocumentSize = 4;
+    Projection projection;
+    EXPECT_EQ(context.decode("{\"a\":1}", limits).error().code, ParseErrorCode::DocumentTooLarge);
+    EXPECT_EQ(context.decodeValue("[1, 2]", limits).error().code, ParseErrorCode::DocumentTooLarge);
+    EXPECT_EQ(context.decodeWith<ParseFlags::Json5Lite>("{a: 1}", limits).error().code,
+              ParseErrorCode::DocumentTooLarge);
+    EXPECT_EQ(context.decode("{\"a\":1}", projection, limits).error().code, ParseErrorCode::DocumentTooLarge);
+    EXPECT_TRUE(context.decodeValue("[1]", limits).has_value());
+}
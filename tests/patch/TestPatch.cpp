@@ -0,0 +1,115 @@
+#include "json/Json.h"
+#include "json/Patch.h"
+
+#include <gtest/gtest.h>
+
+using namespace json;
+
+// Decodes any JSON value by wrapping it in an object.
+JsonValue parseValue(const std::string &json)
+{
+    JsonObject wrapper = jsonDecode("{\"v\":" + json + "}");
+    return wrapper["v"];
+}
+
+TEST(MergePatchTest, Rfc7386Example)
+{
+    JsonValue target = parseValue(R"({"title":"Goodbye!","author":{"givenName":"John","familyName":"Doe"},
+                                      "tags":["example","sample"],"content":"This will be unchanged"})");
+    JsonValue patch = parseValue(R"({"title":"Hello!","phoneNumber":"+01-123-456-7890",
+                                     "author":{"familyName":null},"tags":["example"]})");
+
+    mergePatch(target, patch);
+
+    EXPECT_EQ(target, parseValue(R"({"title":"Hello!","author":{"givenName":"John"},"tags":["example"],
+                                     "content":"This will be unchanged","phoneNumber":"+01-123-456-7890"})"));
+}
+
+TEST(MergePatchTest, NonObjectPatchReplacesTarget)
+{
+    JsonValue target = parseValue(R"({"a":"b"})");
+    mergePatch(target, parseValue(R"(["c"])"));
+    EXPECT_EQ(target, parseValue(R"(["c"])"));
+
+    target = parseValue(R"([1,2])");
+    mergePatch(target, parseValue(R"({"a":{"b":null,"c":1}})"));
+    EXPECT_EQ(target, parseValue(R"({"a":{"c":1}})"));
+}
+
+TEST(JsonPatchTest, AppliesAllOperations)
+{
+    JsonValue doc = parseValue(R"({"foo":{"bar":"baz","waldo":"fred"},"qux":{"corge":"grault"},"list":[1,2,3]})");
+    JsonValue patch = parseValue(R"([
+        {"op":"add","path":"/list/1","value":9},
+        {"op":"add","path":"/list/-","value":4},
+        {"op":"remove","path":"/list/0"},
+        {"op":"replace","path":"/foo/bar","value":"qux"},
+        {"op":"move","from":"/foo/waldo","path":"/qux/thud"},
+        {"op":"copy","from":"/qux/corge","path":"/copied"},
+        {"op":"test","path":"/copied","value":"grault"},
+        {"op":"add","path":"/a~1b","value":true}
+    ])");
+
+    applyPatch(doc, std::move(patch));
+
+    EXPECT_EQ(doc, parseValue(R"({"foo":{"bar":"qux"},"qux":{"corge":"grault","thud":"fred"},
+                                  "list":[9,2,3,4],"copied":"grault","a/b":true})"));
+}
+
+TEST(JsonPatchTest, FailedPatchLeavesDocumentUnchanged)
+{
+    JsonValue original = parseValue(R"({"a":{"b":[1,2,3]},"c":"d","e":"f"})");
+    JsonValue doc = original;
+    JsonValue patch = parseValue(R"([
+        {"op":"remove","path":"/a/b/0"},
+        {"op":"replace","path":"/c","value":"x"},
+        {"op":"move","from":"/e","path":"/c"},
+        {"op":"add","path":"/a/new","value":1},
+        {"op":"test","path":"/a/b/0","value":99}
+    ])");
+
+    try
+    {
+        applyPatch(doc, patch);
+        FAIL() << "expected PatchException";
+    }
+    catch (const PatchException &e)
+    {
+        EXPECT_EQ(e.operation(), 4);
+    }
+    EXPECT_EQ(doc, original);
+}
+
+TEST(JsonPatchTest, RejectsInvalidOperations)
+{
+    JsonValue doc = parseValue(R"({"a":[1]})");
+    EXPECT_THROW(applyPatch(doc, parseValue(R"([{"op":"remove","path":"/missing"}])")), PatchException);
+    EXPECT_THROW(applyPatch(doc, parseValue(R"([{"op":"add","path":"/a/5","value":1}])")), PatchException);
+    EXPECT_THROW(applyPatch(doc, parseValue(R"([{"op":"add","path":"/a/01","value":1}])")), PatchException);
+    EXPECT_THROW(applyPatch(doc, parseValue(R"([{"op":"move","from":"/a","path":"/a/0"}])")), PatchException);
+    EXPECT_THROW(applyPatch(doc, parseValue(R"([{"op":"frobnicate","path":"/a"}])")), PatchException);
+    EXPECT_EQ(doc, parseValue(R"({"a":[1]})"));
+}
+
+TEST(JsonPatchTest, DiffProducesPatchThatReproducesTarget)
+{
+    JsonValue from = parseValue(R"({"keep":1,"drop":true,"nested":{"x":[1,2,3,4],"y":"old"},"list":[1,2,3]})");
+    JsonValue to = parseValue(R"({"keep":1,"added":null,"nested":{"x":[1,5,4],"y":"new"},"list":[0,1,2,3,4]})");
+
+    JsonValue patch = diff(from, to);
+    applyPatch(from, patch);
+    EXPECT_EQ(from, to);
+}
+
+TEST(JsonPatchTest, DiffIsMinimalForSmallEdits)
+{
+    JsonValue from = parseValue(R"({"a":{"b":{"c":[1,2,3]}},"big":[1,2,3,4,5,6,7,8,9]})");
+    JsonValue to = from;
+    to["a"]["b"]["d"] = 5.0;
+
+    JsonValue patch = diff(from, to);
+    ASSERT_TRUE(patch.is_array());
+    EXPECT_EQ(std::get<JsonValue::array_t>(patch.get_value()).size(), 1);
+    EXPECT_EQ(patch, parseValue(R"([{"op":"add","path":"/a/b/d","value":5}])"));
+    EXPECT_EQ(std::get<JsonValue::array_t>(diff(from, from).get_value()).size(), 0);
+}
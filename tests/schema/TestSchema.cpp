@@ -0,0 +1,252 @@
+#include "json/Json.h"
+#include "json/Schema.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace json;
+
+namespace
+{
+    // Runs both validators and checks that they agree before returning the
+    // violation path (or "ok").
+    std::string check(const Schema &schema, const std::string &instance)
+    {
+        auto text = schema.validateText(instance);
+        auto dom = schema.validate(jsonDecode("{\"v\":" + instance + "}")["v"]);
+        EXPECT_EQ(text.has_value(), dom.has_value()) << instance;
+        if (!text)
+        {
+            EXPECT_EQ(text.error().parseError, ParseErrorCode::None) << instance;
+            if (!dom)
+            {
+                EXPECT_EQ(text.error().message, dom.error().message) << instance;
+            }
+            return text.error().path;
+        }
+        return "ok";
+    }
+
+    const char *userSchema = R"({
+        "$schema": "https://json-schema.org/draft/2020-12/schema",
+        "title": "user",
+        "type": "object",
+        "required": ["id", "name"],
+        "properties": {
+            "id": {"type": "integer", "minimum": 1},
+            "name": {"type": "string", "minLength": 1, "maxLength": 8, "pattern": "^[a-z]+$"},
+            "role": {"enum": ["admin", "user", null]},
+            "score": {"type": "number", "exclusiveMinimum": 0, "maximum": 100},
+            "tags": {"type": "array", "items": {"type": "string"}, "maxItems": 2},
+            "meta": {"type": "object", "additionalProperties": false, "properties": {"a/b": true}}
+        },
+        "additionalProperties": {"type": ["boolean", "null"]}
+    })";
+}
+
+TEST(SchemaTest, AcceptsConformingDocuments)
+{
+    Schema schema(jsonDecode(userSchema));
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann"})"), "ok");
+    EXPECT_EQ(check(schema, R"({"id": 2.0, "name": "bob", "role": null, "score": 99.5,
+                                "tags": ["x", "y"], "meta": {"a/b": [1]}, "extra": true})"),
+              "ok");
+}
+
+TEST(SchemaTest, ReportsThePathOfTheFirstViolation)
+{
+    Schema schema(jsonDecode(userSchema));
+    EXPECT_EQ(check(schema, R"({"name": "ann"})"), "");
+    EXPECT_EQ(check(schema, R"({"id": 0, "name": "ann"})"), "/id");
+    EXPECT_EQ(check(schema, R"({"id": 1.5, "name": "ann"})"), "/id");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": ""})"), "/name");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "Ann"})"), "/name");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "annabelle"})"), "/name");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "role": "root"})"), "/role");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "score": 0})"), "/score");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "tags": ["x", 2]})"), "/tags/1");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "tags": ["x", "y", "z"]})"), "/tags");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "meta": {"c": 1}})"), "/meta/c");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "meta": {"a/b": 1, "c": 1}})"), "/meta/c");
+    EXPECT_EQ(check(schema, R"({"id": 1, "name": "ann", "extra": 3})"), "/extra");
+    EXPECT_EQ(check(schema, R"([])"), "");
+}
+
+TEST(SchemaTest, MessagesDescribeTheFailure)
+{
+    Schema schema(jsonDecode(userSchema));
+    auto result = schema.validate(jsonDecode(R"({"id": 1})"));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().message, "missing required property \"name\"");
+
+    result = schema.validate(jsonDecode(R"({"id": "1", "name": "ann"})"));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().message, "expected integer");
+
+    result = schema.validate(jsonDecode(R"({"id": 1, "name": "ann", "meta": {"c": 1}})"));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().message, "property \"c\" is not allowed");
+}
+
+TEST(SchemaTest, EnumAndConstCompareWholeValues)
+{
+    Schema schema(jsonDecode(R"({"properties": {"point": {"enum": [[1, 2], {"x": 1}]}, "v": {"const": 3}}})"));
+    EXPECT_EQ(check(schema, R"({"point": [1, 2], "v": 3.0})"), "ok");
+    EXPECT_EQ(check(schema, R"({"point": {"x": 1}})"), "ok");
+    EXPECT_EQ(check(schema, R"({"point": [1, 2, 3]})"), "/point");
+    EXPECT_EQ(check(schema, R"({"point": {"x": 2}})"), "/point");
+    EXPECT_EQ(check(schema, R"({"v": "3"})"), "/v");
+}
+
+TEST(SchemaTest, BooleanSchemas)
+{
+    Schema anything(jsonDecode(R"({"properties": {"a": true, "b": false}})"));
+    EXPECT_EQ(check(anything, R"({"a": [{"deep": null}]})"), "ok");
+    EXPECT_EQ(check(anything, R"({"b": 1})"), "/b");
+    EXPECT_TRUE(Schema(true).validateText("[1, {}]"));
+    EXPECT_FALSE(Schema(false).validateText("{}"));
+}
+
+TEST(SchemaTest, LengthCountsCodePoints)
+{
+    Schema schema(jsonDecode(R"({"properties": {"s": {"maxLength": 2}}})"));
+    EXPECT_EQ(check(schema, R"({"s": "éé"})"), "ok");
+    EXPECT_EQ(check(schema, R"({"s": "ééé"})"), "/s");
+
+    // Counts past size_t saturate instead of overflowing the cast.
+    Schema huge(jsonDecode(R"({"properties": {"s": {"maxLength": 1e30, "minLength": 1e30}}})"));
+    EXPECT_EQ(check(huge, R"({"s": "abc"})"), "/s");
+}
+
+TEST(SchemaTest, TextValidationRejectsMalformedJson)
+{
+    Schema schema(jsonDecode(userSchema));
+    struct Case
+    {
+        const char *input;
+        ParseErrorCode code;
+        size_t offset;
+    } cases[] = {
+        {R"({"id": 1, "name": "ann")", ParseErrorCode::UnexpectedEndOfInput, 23},
+        {R"({"id": 1 "name": "ann"})", ParseErrorCode::ExpectedCommaOrBrace, 9},
+        {R"({"id": 1, "name": "ann",})", ParseErrorCode::ExpectedKey, 24},
+        {R"({"id": 1x})", ParseErrorCode::InvalidToken, 8},
+        {R"({"id": 1, "name": "ann"} [])", ParseErrorCode::TrailingContent, 25},
+        {R"({"id": 1, "name": "ann", "tags": ["a",]})", ParseErrorCode::ExpectedValue, 38},
+    };
+    for (const Case &c : cases)
+    {
+        auto result = schema.validateText(c.input);
+        ASSERT_FALSE(result) << c.input;
+        EXPECT_EQ(result.error().parseError, c.code) << c.input;
+        EXPECT_EQ(result.error().offset, c.offset) << c.input;
+    }
+}
+
+TEST(SchemaTest, TextValidationReportsOffsets)
+{
+    Schema schema(jsonDecode(userSchema));
+    auto result = schema.validateText(R"({"id": 1, "name": "ann", "tags": ["x", 2]})");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().offset, 39u);
+    EXPECT_EQ(result.error().parseError, ParseErrorCode::None);
+}
+
+TEST(SchemaTest, TextValidationEnforcesLimits)
+{
+    ParseLimits limits;
+    limits.maxDepth = 3;
+    auto result = Schema(true).validateText("[[[[1]]]]", limits);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().parseError, ParseErrorCode::DepthLimitExceeded);
+}
+
+TEST(SchemaTest, RejectsUnsupportedOrMalformedSchemas)
+{
+    EXPECT_THROW(Schema(jsonDecode(R"({"type": "integr"})")), SchemaException);
+    EXPECT_THROW(Schema(jsonDecode(R"({"minLength": -1})")), SchemaException);
+    EXPECT_THROW(Schema(jsonDecode(R"({"pattern": "("})")), SchemaException);
+    EXPECT_THROW(Schema(jsonDecode(R"({"required": [1]})")), SchemaException);
+    EXPECT_THROW(Schema(JsonValue(3)), SchemaException);
+
+    try
+    {
+        Schema(jsonDecode(R"({"properties": {"a": {"$ref": "#"}}})"));
+        FAIL() << "expected SchemaException";
+    }
+    catch (const SchemaException &e)
+    {
+        EXPECT_EQ(e.location(), "/properties/a/$ref");
+    }
+}
+
+TEST(SchemaTest, CompiledSchemaIsSharedAcrossThreads)
+{
+    const Schema schema(jsonDecode(userSchema));
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8);
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+                                 for (int i = 0; i < 200; ++i)
+                                 {
+                                     bool good = (i + t) % 2 == 0;
+                                     std::string doc = good ? R"({"id": 5, "name": "eve"})" : R"({"id": 5, "name": "Eve"})";
+                                     if (schema.validateText(doc).has_value() != good)
+                                         ++failures[t];
+                                 } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    for (int count : failures)
+        EXPECT_EQ(count, 0);
+}
+
+TEST(SchemaTest, PatternSyntax)
+{
+    auto matches = [](const char *pattern, const std::string &text)
+    {
+        JsonValue schema = JsonObject();
+        schema["pattern"] = pattern;
+        return Schema(schema).validateText(jsonEncodeCanonical(JsonValue(text))).has_value();
+    };
+    EXPECT_TRUE(matches("b+", "abbc"));
+    EXPECT_FALSE(matches("^b+", "abbc"));
+    EXPECT_TRUE(matches("^a(b|c)*d$", "abcbd"));
+    EXPECT_FALSE(matches("^a(b|c)*d$", "abcbde"));
+    EXPECT_TRUE(matches("^(?:ab){2,3}$", "ababab"));
+    EXPECT_FALSE(matches("^(?:ab){2,3}$", "abababab"));
+    EXPECT_TRUE(matches("^\\d{3}-[A-Z_]\\w*$", "123-X_9"));
+    EXPECT_FALSE(matches("^\\d{3}-[A-Z_]\\w*$", "12-X"));
+    EXPECT_TRUE(matches("^[^\\s,]+$", "a.b"));
+    EXPECT_FALSE(matches("^[^\\s,]+$", "a b"));
+    EXPECT_TRUE(matches("^.$", "\xc3\xa9"));
+    EXPECT_TRUE(matches("^[\\u00e0-\\u00ff]+$", "\xc3\xa9\xc3\xa0"));
+    EXPECT_TRUE(matches("^a{,}$", "a{,}"));
+    EXPECT_TRUE(matches("x*", ""));
+    EXPECT_TRUE(matches("^(a*)*$", "aaa"));
+    EXPECT_TRUE(matches("\\.\\$", "1.$"));
+
+    for (const char *bad : {"(a", "a)", "[a", "*a", "a{3,1}", "(?=a)", "(a)\\1", "\\bx", "\\q", "a{5000}{5000}"})
+        EXPECT_THROW(Schema(jsonDecode(std::string(R"({"pattern": )") + jsonEncodeCanonical(JsonValue(bad)) + "}")),
+                     SchemaException)
+            << bad;
+}
+
+TEST(SchemaTest, PatternRunsInLinearTimeOnLongStrings)
+{
+    // std::regex recursed once per character here and overflowed the stack.
+    Schema schema(jsonDecode(R"({"properties": {"name": {"type": "string", "pattern": "^(a|b)*$"}}})"));
+    std::string name(1 << 18, 'a');
+    name[name.size() / 2] = 'b';
+    EXPECT_EQ(check(schema, R"({"name": ")" + name + "\"}"), "ok");
+    name.back() = 'c';
+    EXPECT_EQ(check(schema, R"({"name": ")" + name + "\"}"), "/name");
+
+    // Classic catastrophic-backtracking shape.
+    Schema nested(jsonDecode(R"({"pattern": "^(a+)+$"})"));
+    EXPECT_FALSE(nested.validateText("\"" + std::string(100000, 'a') + "!\"").has_value());
+}
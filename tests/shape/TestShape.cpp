@@ -0,0 +1,114 @@
+#include "json/Shape.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace json;
+
+namespace
+{
+    JsonValue::array_t shapeRecords()
+    {
+        JsonValue doc = jsonDecodeValue(R"([
+            {"user_id": 1, "name": "ada", "admin": true},
+            {"user_id": 2, "name": "bob"},
+            {"user_id": 3, "name": null, "team": "ops"}
+        ])");
+        return std::get<JsonValue::array_t>(doc.get_value());
+    }
+}
+
+TEST(KeyTest, HashIsComputedAtCompileTime)
+{
+    static constexpr Key userId{"user_id"};
+    static_assert(userId.hash() == hashBytes("user_id"));
+    static_assert(userId.view() == "user_id");
+    EXPECT_EQ(KeyHash{}(userId), KeyHash{}(std::string("user_id")));
+    EXPECT_TRUE(KeyEqual{}(userId, std::string_view("user_id")));
+    EXPECT_FALSE(KeyEqual{}(std::string("user_ids"), userId));
+}
+
+TEST(KeyTest, ObjectLookupsWithKeys)
+{
+    static constexpr Key userId{"user_id"};
+    static constexpr Key missing{"missing"};
+
+    JsonObject object = jsonDecode(R"({"user_id": 42, "name": "ada"})");
+    ASSERT_TRUE(object.contains(userId));
+    EXPECT_FALSE(object.contains(missing));
+    EXPECT_EQ(object.find(userId)->second, JsonValue(42.0));
+    EXPECT_TRUE(object.find(missing) == object.end());
+
+    const JsonObject &constObject = object;
+    EXPECT_EQ(constObject.find(userId)->first, "user_id");
+
+    object[userId] = 7;
+    EXPECT_EQ(object["user_id"], JsonValue(7));
+    EXPECT_EQ(object.size(), 2u);
+
+    object[missing] = true;
+    EXPECT_EQ(object.size(), 3u);
+    EXPECT_EQ(object["missing"], JsonValue(true));
+
+    JsonValue value;
+    value[Key("a")][Key("b")] = 1;
+    EXPECT_EQ(value, jsonDecodeValue(R"({"a": {"b": 1}})"));
+}
+
+TEST(ShapeTest, SlotsFollowInsertionOrder)
+{
+    Shape shape{"id", "name", "id"};
+    EXPECT_EQ(shape.size(), 2u);
+    EXPECT_EQ(shape.slot(Key("id")), 0u);
+    EXPECT_EQ(shape.slot(std::string_view("name")), 1u);
+    EXPECT_EQ(shape.slot(Key("other")), Shape::npos);
+    EXPECT_EQ(shape.add("other"), 2u);
+    EXPECT_EQ(shape.add("name"), 1u);
+    EXPECT_EQ(shape.key(2), "other");
+}
+
+TEST(RecordSetTest, RecordsShareOneShape)
+{
+    RecordSet records = RecordSet::fromArray(shapeRecords());
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.shape().size(), 4u);
+
+    size_t id = records.shape().slot(Key("user_id"));
+    size_t name = records.shape().slot(Key("name"));
+    size_t team = records.shape().slot(Key("team"));
+    for (size_t row = 0; row < records.size(); ++row)
+    {
+        ASSERT_NE(records.get(row, id), nullptr);
+        EXPECT_EQ(*records.get(row, id), JsonValue(double(row + 1)));
+    }
+
+    // Present-but-null is distinct from missing.
+    ASSERT_NE(records.get(2, name), nullptr);
+    EXPECT_EQ(*records.get(2, name), JsonValue(nullptr));
+    EXPECT_EQ(records.get(0, team), nullptr);
+    EXPECT_EQ(*records.get(2, Key("team")), JsonValue("ops"));
+    EXPECT_EQ(records.get(1, Key("admin")), nullptr);
+    EXPECT_EQ(records.get(0, Shape::npos), nullptr);
+
+    EXPECT_EQ(JsonValue(records.toArray()), JsonValue(shapeRecords()));
+}
+
+TEST(RecordSetTest, ExistingShapeProjectsMembers)
+{
+    auto shape = std::make_shared<const Shape>(Shape{"name", "user_id"});
+    RecordSet records = RecordSet::fromArray(shapeRecords(), shape);
+    EXPECT_TRUE(records.sharedShape() == shape);
+    EXPECT_EQ(*records.get(1, 0), JsonValue("bob"));
+    EXPECT_EQ(*records.get(1, 1), JsonValue(2.0));
+    EXPECT_EQ(records.get(0, Key("admin")), nullptr);
+    EXPECT_EQ(records.toArray()[0], jsonDecodeValue(R"({"user_id": 1, "name": "ada"})"));
+}
+
+TEST(RecordSetTest, RejectsNonObjectElements)
+{
+    JsonValue::array_t mixed = shapeRecords();
+    mixed.emplace_back(1);
+    EXPECT_THROW(RecordSet::fromArray(mixed), std::invalid_argument);
+    EXPECT_THROW(RecordSet::fromArray(mixed, std::make_shared<const Shape>()), std::invalid_argument);
+}
@@ -0,0 +1,131 @@
+#include "json/Json.h"
+#include "json/Snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+using namespace json;
+
+JsonValue makeSnapshotDocument()
+{
+    JsonObject inner;
+    inner["x"] = 42.5;
+    inner["id"] = 7;
+
+    JsonObject root;
+    root["name"] = "John";
+    root["married"] = true;
+    root["children"] = nullptr;
+    root["inner"] = inner;
+    root["list"] = std::vector<JsonValue>{"a", 1.0, false};
+    return root;
+}
+
+TEST(SnapshotTest, ViewMirrorsDocument)
+{
+    std::string data = snapshotEncode(makeSnapshotDocument());
+    SnapshotView view(data.data(), data.size());
+    SnapshotValue root = view.root();
+
+    ASSERT_TRUE(root.is_object());
+    EXPECT_EQ(root.size(), 5);
+    EXPECT_EQ(static_cast<std::string_view>(root["name"]), "John");
+    EXPECT_TRUE(static_cast<bool>(root["married"]));
+    EXPECT_TRUE(root["children"].is_null());
+    EXPECT_EQ(static_cast<double>(root["inner"]["x"]), 42.5);
+    EXPECT_EQ(static_cast<int64_t>(root["inner"]["id"]), 7);
+
+    SnapshotValue list = root["list"];
+    ASSERT_TRUE(list.is_array());
+    ASSERT_EQ(list.size(), 3);
+    EXPECT_EQ(static_cast<std::string>(list[0]), "a");
+    EXPECT_TRUE(list[1].is_number_float());
+    EXPECT_TRUE(list[2].is_boolean());
+}
+
+TEST(SnapshotTest, MissingKeysAndIndexesAreAbsent)
+{
+    std::string data = snapshotEncode(makeSnapshotDocument());
+    SnapshotView view(data.data(), data.size());
+
+    EXPECT_FALSE(view.root()["missing"].exists());
+    EXPECT_FALSE(view.root()["list"][10].exists());
+    EXPECT_FALSE(view.root()["name"]["nested"].exists());
+    EXPECT_TRUE(view.root().contains("inner"));
+    EXPECT_FALSE(view.root().contains("inne"));
+}
+
+TEST(SnapshotTest, ObjectIterationIsSortedByKey)
+{
+    std::string data = snapshotEncode(makeSnapshotDocument());
+    SnapshotView view(data.data(), data.size());
+
+    std::vector<std::string> keys;
+    for (auto [key, value] : view.root().items())
+        keys.emplace_back(key);
+
+    EXPECT_EQ(keys, (std::vector<std::string>{"children", "inner", "list", "married", "name"}));
+}
+
+TEST(SnapshotTest, RoundTripThroughJsonValue)
+{
+    std::string data = snapshotEncode(makeSnapshotDocument());
+    SnapshotView view(data.data(), data.size());
+
+    JsonValue restored = view.root().toJsonValue();
+    EXPECT_EQ(std::get<double>(restored["inner"]["x"].get_value()), 42.5);
+    EXPECT_EQ(std::get<int64_t>(restored["inner"]["id"].get_value()), 7);
+    EXPECT_EQ(std::get<std::string>(restored["name"].get_value()), "John");
+}
+
+TEST(SnapshotTest, DecodedDocumentSurvivesMappedFile)
+{
+    JsonObject decoded = jsonDecode("{\"service\":{\"ports\":[80,443],\"host\":\"example\"}}");
+    std::string path = testing::TempDir() + "snapshot_test.bin";
+    snapshotWrite(path, decoded);
+
+    {
+        MappedSnapshot mapped(path);
+        SnapshotValue service = mapped.root()["service"];
+        EXPECT_EQ(static_cast<std::string_view>(service["host"]), "example");
+        EXPECT_EQ(static_cast<double>(service["ports"][1]), 443.0);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, RejectsForeignBuffers)
+{
+    alignas(8) char garbage[64] = "definitely not a snapshot";
+    EXPECT_THROW(SnapshotView(garbage, sizeof(garbage)), std::runtime_error);
+    EXPECT_THROW(SnapshotView(garbage, 4), std::runtime_error);
+}
+
+TEST(SnapshotTest, CorruptOffsetsThrowOnAccess)
+{
+    std::string bytes = snapshotEncode(makeSnapshotDocument());
+    auto header = [&] { return reinterpret_cast<snapshot::SnapshotHeader *>(bytes.data()); };
+    auto rootNode = [&] { return reinterpret_cast<snapshot::SnapshotNode *>(bytes.data() + header()->root); };
+
+    // Truncated before the string table, with the header size patched to match.
+    std::string original = bytes;
+    bytes.resize(header()->strings);
+    header()->size = bytes.size();
+    EXPECT_THROW(SnapshotView(bytes.data(), bytes.size()).root().toJsonValue(), std::runtime_error);
+
+    // Members past the end of the buffer.
+    bytes = original;
+    rootNode()->count = 1u << 30;
+    EXPECT_THROW(SnapshotView(bytes.data(), bytes.size()).root()["name"], std::runtime_error);
+    EXPECT_THROW(SnapshotView(bytes.data(), bytes.size()).root().items(), std::runtime_error);
+
+    // A container pointing back at its own node would otherwise recurse forever.
+    bytes = original;
+    rootNode()->payload = header()->root;
+    EXPECT_THROW(SnapshotView(bytes.data(), bytes.size()).root().toJsonValue(), std::runtime_error);
+
+    bytes = original;
+    header()->root = bytes.size();
+    EXPECT_THROW(SnapshotView(bytes.data(), bytes.size()), std::runtime_error);
+}
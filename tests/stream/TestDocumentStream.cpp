@@ -0,0 +1,126 @@
+#include "json/DocumentStream.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace json;
+
+TEST(DocumentStreamTest, SplitsConcatenatedDocuments)
+{
+    std::string input = "{\"a\":1}{\"b\":[2]} [3]\n\"four\" 5 true null{}";
+    DocumentStream stream(input);
+
+    std::vector<std::string> ranges;
+    std::vector<JsonValue> values;
+    for (const auto &doc : stream)
+    {
+        ranges.push_back(input.substr(doc.begin, doc.end - doc.begin));
+        values.push_back(doc.value);
+    }
+
+    EXPECT_FALSE(stream.failed());
+    EXPECT_EQ(stream.count(), 8u);
+    EXPECT_EQ(ranges, (std::vector<std::string>{"{\"a\":1}", "{\"b\":[2]}", "[3]", "\"four\"", "5", "true", "null", "{}"}));
+    for (size_t i = 0; i < ranges.size(); ++i)
+        EXPECT_EQ(values[i], jsonDecodeValue(ranges[i])) << ranges[i];
+}
+
+TEST(DocumentStreamTest, EmptyAndWhitespaceOnlyStreams)
+{
+    for (const char *input : {"", " \n\t "})
+    {
+        DocumentStream stream(input);
+        DocumentStream::Document doc;
+        EXPECT_FALSE(stream.next(doc));
+        EXPECT_FALSE(stream.failed());
+        EXPECT_EQ(stream.count(), 0u);
+    }
+}
+
+TEST(DocumentStreamTest, DocumentsSpanManyTokenBatches)
+{
+    std::string big = "[";
+    for (int i = 0; i < 2000; ++i)
+        big += (i ? "," : "") + std::to_string(i);
+    big += "]";
+
+    std::string input = big + big + "{\"k\":\"v\"}" + big;
+    DocumentStream stream(input);
+    DocumentStream::Document doc;
+    size_t n = 0;
+    while (stream.next(doc))
+    {
+        if (n != 2)
+        {
+            EXPECT_EQ(std::get<JsonValue::array_t>(doc.value.get_value()).size(), 2000u);
+            EXPECT_EQ(doc.end - doc.begin, big.size());
+        }
+        ++n;
+    }
+    EXPECT_FALSE(stream.failed());
+    EXPECT_EQ(n, 4u);
+}
+
+TEST(DocumentStreamTest, StopsAtTheFirstMalformedDocument)
+{
+    std::string input = "{\"a\":1} {\"b\" 2} {\"c\":3}";
+    DocumentStream stream(input);
+    DocumentStream::Document doc;
+
+    ASSERT_TRUE(stream.next(doc));
+    EXPECT_FALSE(stream.next(doc));
+    EXPECT_TRUE(stream.failed());
+    EXPECT_EQ(stream.error().code, ParseErrorCode::ExpectedColon);
+    EXPECT_EQ(stream.error().offset, 13u);
+    EXPECT_EQ(stream.error().line, 1u);
+    EXPECT_FALSE(stream.next(doc));
+}
+
+TEST(DocumentStreamTest, TruncatedLastDocument)
+{
+    DocumentStream stream("[1][2");
+    size_t n = 0;
+    for (const auto &doc : stream)
+    {
+        (void)doc;
+        ++n;
+    }
+    EXPECT_EQ(n, 1u);
+    ASSERT_TRUE(stream.failed());
+    EXPECT_EQ(stream.error().code, ParseErrorCode::UnexpectedEndOfInput);
+    EXPECT_EQ(stream.error().offset, 5u);
+}
+
+TEST(DocumentStreamTest, LimitsApplyPerDocument)
+{
+    ParseLimits limits;
+    limits.maxDocumentSize = 8;
+    limits.maxDepth = 2;
+
+    DocumentStream sized("[1,2] [3,4] [1,2,3,4,5]", limits);
+    DocumentStream::Document doc;
+    EXPECT_TRUE(sized.next(doc));
+    EXPECT_TRUE(sized.next(doc));
+    EXPECT_FALSE(sized.next(doc));
+    EXPECT_EQ(sized.error().code, ParseErrorCode::DocumentTooLarge);
+
+    // An oversized document fails once lexing passes the limit, before the
+    // rest of it (here truncated) is parsed.
+    limits.maxDepth = 1024;
+    std::string huge = "[1] [0";
+    for (int i = 0; i < 100000; ++i)
+        huge += ",1";
+    DocumentStream early(huge, limits);
+    EXPECT_TRUE(early.next(doc));
+    EXPECT_FALSE(early.next(doc));
+    EXPECT_EQ(early.error().code, ParseErrorCode::DocumentTooLarge);
+    EXPECT_EQ(early.error().offset, 4u);
+
+    limits.maxDepth = 2;
+    DocumentStream deep("[[1]] [[[1]]]", limits);
+    EXPECT_TRUE(deep.next(doc));
+    EXPECT_FALSE(deep.next(doc));
+    EXPECT_EQ(deep.error().code, ParseErrorCode::DepthLimitExceeded);
+}
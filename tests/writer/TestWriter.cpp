@@ -0,0 +1,167 @@
+#include "json/Json.h"
+#include "json/Writer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+using namespace json;
+
+TEST(WriterTest, WritesNestedContainers)
+{
+    std::string out;
+    StringSink sink(out);
+    {
+        Writer w(sink);
+        w.begin_object()
+            .key("name")
+            .value("ann")
+            .key("ids")
+            .begin_array()
+            .value(1)
+            .value(-2)
+            .value(2.5)
+            .end_array()
+            .key("empty")
+            .begin_object()
+            .end_object()
+            .key("flags")
+            .begin_array()
+            .value(true)
+            .value(nullptr)
+            .begin_array()
+            .end_array()
+            .end_array()
+            .end_object();
+    }
+    EXPECT_EQ(out, R"({"name":"ann","ids":[1,-2,2.5],"empty":{},"flags":[true,null,[]]})");
+}
+
+TEST(WriterTest, EscapesAndFormatsLikeTheCanonicalEncoder)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink);
+    w.begin_array();
+    for (double d : {0.1, 1e21, 1e-7, -0.0, 123456789.0})
+        w.value(d);
+    w.value("a\"b\\c\n\x01/\xC3\xA9");
+    w.end_array();
+    w.flush();
+
+    EXPECT_EQ(out, jsonEncodeCanonical(JsonValue(std::vector<JsonValue>{0.1, 1e21, 1e-7, -0.0, 123456789.0,
+                                                                         "a\"b\\c\n\x01/\xC3\xA9"})));
+}
+
+TEST(WriterTest, WritesIntegersExactly)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink);
+    w.begin_array()
+        .value(std::numeric_limits<int64_t>::min())
+        .value(std::numeric_limits<uint64_t>::max())
+        .value(static_cast<short>(7))
+        .end_array();
+    w.flush();
+    EXPECT_EQ(out, "[-9223372036854775808,18446744073709551615,7]");
+}
+
+TEST(WriterTest, ScalarRoot)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink);
+    w.value(42);
+    w.flush();
+    EXPECT_EQ(out, "42");
+}
+
+TEST(WriterTest, StreamsJsonValueSubtrees)
+{
+    JsonObject doc = jsonDecode(R"({"a": [1, {"b": "x\ty"}], "c": null, "d": false})");
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink);
+    w.begin_array().value(JsonValue(doc)).value(JsonValue(int64_t(3))).end_array();
+    w.flush();
+
+    auto decoded = jsonTryDecode("{\"v\":" + out + "}");
+    ASSERT_TRUE(decoded) << out;
+    EXPECT_EQ((*decoded)["v"], JsonValue(std::vector<JsonValue>{JsonValue(doc), 3.0}));
+}
+
+TEST(WriterTest, FlushesInBufferSizedChunks)
+{
+    std::vector<size_t> chunks;
+    std::string out;
+    CallbackSink sink([&](std::string_view data)
+                      {
+                          chunks.push_back(data.size());
+                          out.append(data); });
+    {
+        Writer w(sink, 256);
+        w.begin_array();
+        for (int i = 0; i < 1000; ++i)
+            w.value(i);
+        w.end_array();
+    }
+
+    ASSERT_GT(chunks.size(), 10u);
+    for (size_t i = 0; i + 1 < chunks.size(); ++i)
+        EXPECT_LT(chunks[i], 256u + 32);
+    auto decoded = jsonTryDecode("{\"v\":" + out + "}");
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(std::get<JsonValue::array_t>((*decoded)["v"].get_value()).size(), 1000u);
+}
+
+TEST(WriterTest, StreamAndFdSinks)
+{
+    std::ostringstream oss;
+    StreamSink stream(oss);
+    {
+        Writer w(stream);
+        w.begin_object().key("k").value("v").end_object();
+    }
+    EXPECT_EQ(oss.str(), R"({"k":"v"})");
+
+    std::FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    FdSink fd(fileno(file));
+    {
+        Writer w(fd);
+        w.begin_array().value(1).end_array();
+    }
+    std::rewind(file);
+    char buf[16] = {};
+    size_t n = std::fread(buf, 1, sizeof(buf), file);
+    std::fclose(file);
+    EXPECT_EQ(std::string(buf, n), "[1]");
+}
+
+TEST(WriterTest, RejectsNonFiniteNumbers)
+{
+    std::string out;
+    StringSink sink(out);
+    Writer w(sink);
+    EXPECT_THROW(w.value(std::numeric_limits<double>::infinity()), std::runtime_error);
+}
+
+#if JSON_WRITER_CHECKS
+TEST(WriterTest, ChecksNesting)
+{
+    std::string out;
+    StringSink sink(out);
+
+    EXPECT_THROW(Writer(sink).key("x"), std::logic_error);
+    EXPECT_THROW(Writer(sink).begin_object().value(1), std::logic_error);
+    EXPECT_THROW(Writer(sink).begin_object().key("a").key("b"), std::logic_error);
+    EXPECT_THROW(Writer(sink).begin_array().end_object(), std::logic_error);
+    EXPECT_THROW(Writer(sink).begin_object().key("a").end_object(), std::logic_error);
+    EXPECT_THROW(Writer(sink).end_array(), std::logic_error);
+    EXPECT_THROW(Writer(sink).value(1).value(2), std::logic_error);
+}
+#endif